@@ -58,6 +58,9 @@ public:
      * @param bufferSize Size of buffer in bytes
      * @param speed Initial speed setting
      * @param interface FireWire device interface
+     * @param playbackRing Driver->daemon shm ring; a transmitter encodes straight from it when valid,
+     *        a receiver's PLL publishes the bus clock into its clock record
+     * @param captureRing Daemon->driver shm ring; a receiver writes its decoded frames to it when valid
      * @return std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> Shared pointer to created stream or error
      */
     static std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> create(
@@ -73,7 +76,9 @@ public:
                                                                                 unsigned int numSegments = 4,
                                                                                 unsigned int bufferSize = 512,
                                                                                 IOFWSpeed speed = kFWSpeed100MBit,
-                                                                                IOFireWireLibDeviceRef interface = nullptr);
+                                                                                IOFireWireLibDeviceRef interface = nullptr,
+                                                                                RTShmRing::RingView playbackRing = {},
+                                                                                RTShmRing::RingView captureRing = {});
     
     /**
      * @brief Create a receiver stream for a device output plug
@@ -89,6 +94,10 @@ public:
      * @param numSegments Number of segments in the cycle buffer
      * @param cycleBufferSize Size of cycle buffer in bytes
      * @param interface FireWire device interface
+     * @param captureRing Daemon->driver shm ring the received audio is written to
+     *        (RingBufferManager::captureRing()); without it the driver's input stays silent
+     * @param clockRing Segment whose clock record the PLL publishes to (RingBufferManager::ring()); without
+     *        it the driver's zero timestamps run at the nominal rate
      * @return std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> Created stream or error
      */
     static std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> createReceiverForDevicePlug(
@@ -102,7 +111,9 @@ public:
                                                                                                      unsigned int cyclesPerSegment = 8,
                                                                                                      unsigned int numSegments = 4,
                                                                                                      unsigned int cycleBufferSize = 512,
-                                                                                                     IOFireWireLibDeviceRef interface = nullptr);
+                                                                                                     IOFireWireLibDeviceRef interface = nullptr,
+                                                                                                     RTShmRing::RingView captureRing = {},
+                                                                                                     RTShmRing::RingView clockRing = {});
     
     /**
      * @brief Create a transmitter stream for a device input plug
@@ -118,6 +129,8 @@ public:
      * @param numSegments Number of segments in the cycle buffer
      * @param transmitBufferSize Size of transmission buffer in bytes
      * @param interface FireWire device interface
+     * @param playbackRing Driver->daemon shm ring to encode from (RingBufferManager::ring()). The caller
+     *        must also stop the ring's other consumer (RingBufferManager::setDirectConsumer(true)).
      * @return std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> Created stream or error
      */
     static std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> createTransmitterForDevicePlug(
@@ -131,7 +144,8 @@ public:
                                                                                                         unsigned int cyclesPerSegment = 8,
                                                                                                         unsigned int numSegments = 4,
                                                                                                         unsigned int transmitBufferSize = 512,
-                                                                                                        IOFireWireLibDeviceRef interface = nullptr);
+                                                                                                        IOFireWireLibDeviceRef interface = nullptr,
+                                                                                                        RTShmRing::RingView playbackRing = {});
     
     /**
      * @brief Destructor handles proper cleanup of resources
@@ -239,9 +253,9 @@ public:
 
     /**
      * @brief Get the underlying Ring Buffer for receiver streams.
-     * @return Pointer to the raul::RingBuffer, or nullptr if not a receiver or not initialized.
+     * @return Pointer to the receiver's frame ring, or nullptr if not a receiver or not initialized.
      */
-    raul::RingBuffer* getReceiverRingBuffer() const; // Declaration added
+    Isoch::AppRingBuffer* getReceiverRingBuffer() const; // Declaration added
     
     /**
      * @brief Push audio data to the transmitter for sending
@@ -101,7 +101,7 @@ private:
     void consumerLoop(); // The function the consumer thread will run
 
     // Helper to get the ring buffer pointer safely
-    raul::RingBuffer* getInputStreamRingBuffer();
+    Isoch::AppRingBuffer* getInputStreamRingBuffer();
 
     // Statistics tracking
     std::chrono::steady_clock::time_point m_lastTimestamp;
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief Tuning for AdaptiveLatencyController. All levels are in the ring's own unit
+ *        (frames for RTShmRing, bytes for the provider's RingBuffer).
+ */
+struct AdaptiveLatencyConfig {
+    uint32_t capacity{0};                 ///< Usable ring capacity
+    uint32_t initialTarget{0};            ///< 0 = capacity / 2 (the old fixed 50% target)
+    uint32_t minTarget{0};                ///< 0 = capacity / 16
+    uint32_t maxTarget{0};                ///< 0 = capacity * 7 / 8
+    uint32_t windowObservations{8000};    ///< Observations per evaluation window (1 s of packets at 8 kHz)
+    uint32_t stableWindowsToShrink{10};   ///< Clean windows required before the target starts to shrink
+    double safetyFactor{2.0};             ///< Target is kept at least this many times the observed jitter
+    double growFactor{1.5};               ///< Target multiplier on underrun
+    double shrinkFraction{0.125};         ///< Fraction of the excess over the floor removed per stable window
+};
+
+/**
+ * @brief Picks the playback ring's target fill level at runtime.
+ *
+ * The packet provider reports the ring fill once per packet (observe()) and every underrun
+ * (noteUnderrun()). Each window the controller measures the peak-to-peak fill excursion
+ * (jitter) and:
+ *  - grows the target by growFactor on an underrun, at most once per window;
+ *  - raises the target to safetyFactor x jitter if the jitter outgrew it;
+ *  - after stableWindowsToShrink clean windows, walks the target down towards that floor.
+ *
+ * The provider primes (and re-primes after an underrun) to target(), and discards
+ * trimAmount() once the target has been lowered, which is what actually removes latency.
+ *
+ * Pure logic with no clock, allocation or logging, so it is deterministic for a given trace.
+ * observe()/noteUnderrun()/trimAmount() belong to the consumer thread; target() may be read
+ * from any thread.
+ */
+class AdaptiveLatencyController {
+public:
+    explicit AdaptiveLatencyController(const AdaptiveLatencyConfig& config);
+
+    /// Record the fill level seen by the consumer; closes the window every windowObservations calls.
+    void observe(uint32_t fill) noexcept;
+
+    /// Record an underrun; grows the target immediately (once per window).
+    void noteUnderrun() noexcept;
+
+    /// Units to discard so a lowered target takes effect; 0 unless a shrink is pending and
+    /// fill is above target plus the current jitter allowance. Clears the pending shrink when nonzero.
+    uint32_t trimAmount(uint32_t fill) noexcept;
+
+    [[nodiscard]] uint32_t target() const noexcept { return target_.load(std::memory_order_relaxed); }
+    [[nodiscard]] uint32_t lastJitter() const noexcept { return lastJitter_; }
+    [[nodiscard]] uint32_t growCount() const noexcept { return grows_; }
+    [[nodiscard]] uint32_t shrinkCount() const noexcept { return shrinks_; }
+    [[nodiscard]] const AdaptiveLatencyConfig& config() const noexcept { return config_; }
+
+    /// Back to the initial target with no history.
+    void reset() noexcept;
+
+private:
+    void closeWindow() noexcept;
+    uint32_t clampTarget(double value) const noexcept;
+    uint32_t jitterFloor(uint32_t jitter) const noexcept;
+
+    AdaptiveLatencyConfig config_;
+    std::atomic<uint32_t> target_{0};
+
+    // Current window
+    uint32_t observations_{0};
+    uint32_t windowMin_{UINT32_MAX};
+    uint32_t windowMax_{0};
+    bool windowUnderrun_{false};
+
+    // History
+    uint32_t lastJitter_{0};
+    uint32_t stableWindows_{0};
+    bool trimPending_{false};
+    uint32_t grows_{0};
+    uint32_t shrinks_{0};
+};
+
+} // namespace Isoch
+} // namespace FWA
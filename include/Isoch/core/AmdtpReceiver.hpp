@@ -141,9 +141,9 @@ public:
 
     /**
      * @brief Get a pointer to the application ring buffer.
-     * @return Pointer to the raul::RingBuffer, or nullptr if not initialized.
+     * @return Pointer to the frame ring, or nullptr if not initialized.
      */
-    raul::RingBuffer* getAppRingBuffer() const; // <<< Declaration Added Here
+    AppRingBuffer* getAppRingBuffer() const; // <<< Declaration Added Here
     
 private:
     /**
@@ -206,6 +206,9 @@ private:
     void handleProcessedData(const std::vector<ProcessedSample>& samples,
                             const PacketTimingInfo& timing);
     
+    // Write processed frames into the capture shm ring (daemon -> driver)
+    void writeCaptureRing(const std::vector<ProcessedSample>& samples, uint64_t presentationHostTime);
+
     // For structured callback forwarding
     static void handleStructuredCallback(const ReceivedCycleData& data, void* refCon);
     
@@ -226,7 +229,7 @@ private:
     
     // Future components (placeholders)
     std::unique_ptr<AudioClockPLL> pll_{nullptr};
-    std::unique_ptr<class raul::RingBuffer> appRingBuffer_{nullptr};
+    std::unique_ptr<AppRingBuffer> appRingBuffer_{nullptr};
     
     // RunLoop reference
     CFRunLoopRef runLoopRef_{nullptr};
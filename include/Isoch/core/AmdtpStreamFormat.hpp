@@ -0,0 +1,146 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief Per-rate constants of IEC 61883-6 blocking transmission.
+ *
+ * A data packet carries sytInterval frames and the next one is due ticksPerPacket +
+ * ticksRemainder / ticksDenominator cycle-timer ticks (24.576 MHz) later. The fraction is
+ * kept reduced, so 44.1 kHz family rates step 4458 + 34/147 ticks and the 48 kHz family
+ * steps a whole 4096 (remainder 0, denominator 1).
+ */
+struct AmdtpRateInfo {
+    uint32_t sampleRate;
+    uint8_t  sfc;
+    uint8_t  sytInterval;
+    uint16_t ticksPerPacket;
+    uint16_t ticksRemainder;
+    uint16_t ticksDenominator;
+};
+
+namespace detail {
+constexpr uint64_t kTicksPerSecond = 24576000;
+
+constexpr AmdtpRateInfo makeRateInfo(uint32_t rate, uint8_t sfc, uint8_t sytInterval) {
+    const uint64_t num = sytInterval * kTicksPerSecond;
+    const uint64_t g = std::gcd(num, uint64_t(rate));
+    const uint64_t n = num / g, d = rate / g;
+    return { rate, sfc, sytInterval, uint16_t(n / d), uint16_t(n % d), uint16_t(d) };
+}
+} // namespace detail
+
+inline constexpr AmdtpRateInfo kAmdtpRates[] = {
+    detail::makeRateInfo(32000,  0x00, 8),
+    detail::makeRateInfo(44100,  0x01, 8),
+    detail::makeRateInfo(48000,  0x02, 8),
+    detail::makeRateInfo(88200,  0x03, 16),
+    detail::makeRateInfo(96000,  0x04, 16),
+    detail::makeRateInfo(176400, 0x05, 32),
+    detail::makeRateInfo(192000, 0x06, 32),
+};
+
+/// Table entry for a nominal rate in Hz, or nullptr if IEC 61883-6 does not define it
+constexpr const AmdtpRateInfo* findAmdtpRate(uint32_t sampleRate) {
+    for (const auto& r : kAmdtpRates) {
+        if (r.sampleRate == sampleRate) return &r;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief IEC 61883-6 packetization: how many data blocks each cycle's packet carries.
+ */
+enum class AmdtpTransmissionMode : uint8_t {
+    Blocking,     ///< SYT_INTERVAL data blocks per data packet, NO_DATA packets in the other cycles
+    NonBlocking   ///< Every packet carries the data blocks presented in its cycle (44.1 kHz: 5 or 6)
+};
+
+/**
+ * @brief Shape of one AM824 (IEC 61883-6) stream: N audio plus M MIDI slots per data block.
+ *
+ * Everything the transmit path sizes (DCL payload, client buffer stride, CIP DBS, DBC step,
+ * IRM bandwidth) derives from this, so an 18-channel interface runs on the same single
+ * stream as stereo. In blocking mode a packet carries either no data blocks or exactly
+ * SYT_INTERVAL of them; in non-blocking mode every packet carries rate / 8000 of them,
+ * rounded up or down, and buffers are sized for the larger count.
+ *
+ * Header-only and free of IOKit so the arithmetic can be checked on any host.
+ */
+struct AmdtpStreamFormat {
+    uint32_t audioChannels{2};      ///< MBLA (24-bit audio) slots per data block
+    uint32_t midiSlots{0};          ///< MIDI conformant slots, each multiplexing up to 8 ports
+    uint32_t sampleRate{44100};     ///< Nominal rate in Hz
+    AmdtpTransmissionMode mode{AmdtpTransmissionMode::Blocking};
+
+    static constexpr uint32_t kMaxDataBlockSize = 255;   ///< DBS is an 8-bit field
+    static constexpr uint8_t  kFmtAM824 = 0x10;
+    static constexpr uint8_t  kFdfNoData = 0xFF;
+
+    /// DBS: quadlets per data block
+    constexpr uint32_t dataBlockSize() const { return audioChannels + midiSlots; }
+
+    constexpr uint32_t bytesPerDataBlock() const { return dataBlockSize() * 4; }
+
+    /// SYT_INTERVAL: data blocks between SYT timestamps
+    constexpr uint32_t sytInterval() const {
+        const AmdtpRateInfo* r = findAmdtpRate(sampleRate);
+        return r ? r->sytInterval : 8;
+    }
+
+    /// Most data blocks one packet carries: SYT_INTERVAL blocking, rate / 8000 rounded up non-blocking
+    constexpr uint32_t framesPerPacket() const {
+        if (mode == AmdtpTransmissionMode::NonBlocking) return (sampleRate + 7999) / 8000;
+        return sytInterval();
+    }
+
+    /// AM824 bytes after the CIP header in the largest data packet
+    constexpr uint32_t payloadBytes() const { return framesPerPacket() * bytesPerDataBlock(); }
+
+    /// Largest isoch payload (CIP header + data blocks) to reserve bandwidth for with the IRM
+    constexpr uint32_t irmPayloadBytes() const { return kCIPHeaderBytes + payloadBytes(); }
+
+    /// IEC 61883-6 sampling frequency code, or 0xFF for a rate it does not define
+    constexpr uint8_t sfc() const {
+        const AmdtpRateInfo* r = findAmdtpRate(sampleRate);
+        return r ? r->sfc : 0xFF;
+    }
+
+    constexpr bool isValid() const {
+        return audioChannels > 0 && dataBlockSize() <= kMaxDataBlockSize && sfc() != 0xFF;
+    }
+
+    /**
+     * @brief Write the two CIP header quadlets (big-endian, as they go on the wire).
+     * @param out 8 bytes
+     * @param sid Source node ID (low 6 bits)
+     * @param dbc Data block counter of the first block in the packet
+     * @param fdf SFC for a data packet, kFdfNoData for an empty one
+     * @param syt Presentation timestamp, 0xFFFF for none
+     */
+    constexpr void writeCIPHeader(uint8_t* out, uint8_t sid, uint8_t dbc, uint8_t fdf, uint16_t syt) const {
+        out[0] = sid & 0x3F;                       // EOH=0, SID
+        out[1] = static_cast<uint8_t>(dataBlockSize());
+        out[2] = 0;                                // FN=0, QPC=0, SPH=0
+        out[3] = dbc;
+        out[4] = 0x80 | kFmtAM824;                 // EOH=1, FMT
+        out[5] = fdf;
+        out[6] = static_cast<uint8_t>(syt >> 8);
+        out[7] = static_cast<uint8_t>(syt);
+    }
+
+    static constexpr size_t kCIPHeaderBytes = 8;
+};
+
+static_assert(findAmdtpRate(44100)->ticksPerPacket == 4458 && findAmdtpRate(44100)->ticksRemainder == 34 &&
+              findAmdtpRate(44100)->ticksDenominator == 147, "44.1 kHz packet spacing");
+static_assert(findAmdtpRate(192000)->ticksPerPacket == 4096 && findAmdtpRate(192000)->ticksRemainder == 0,
+              "192 kHz packet spacing");
+
+} // namespace Isoch
+} // namespace FWA
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include "Isoch/core/AmdtpStreamFormat.hpp"
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief What one isochronous cycle's packet carries: its data block count, DBC and SYT.
+ */
+struct CycleTiming {
+    uint8_t  dataBlocks{0};   ///< 0 (NO_DATA packet) or SYT_INTERVAL; non-blocking: the blocks presented this cycle
+    uint8_t  dbc{0};          ///< Data block counter: blocks sent before this packet, mod 256
+    uint16_t syt{0xFFFF};     ///< Presentation time (cycle low 4 bits : offset), 0xFFFF when empty
+
+    bool hasData() const { return dataBlocks != 0; }
+};
+
+/**
+ * @brief Cycle-by-cycle DBC/SYT generator for IEC 61883-6 blocking or non-blocking transmission.
+ *
+ * Call next() once per isochronous cycle, in cycle order. In blocking mode a data packet is
+ * emitted in the cycle its first frame's presentation time falls into; every other cycle
+ * gets an empty packet whose DBC is that of the next data packet. Packet times advance by
+ * the rate's reduced fraction from kAmdtpRates, so the sequence is exact for every rate with
+ * integer arithmetic only and no rate-dependent branches per packet.
+ *
+ * In non-blocking mode every cycle carries the frames presented in it, ceil((k+1) * rate /
+ * 8000) - ceil(k * rate / 8000) of them for the k-th cycle of each second, and SYT is the
+ * presentation time of the packet's block whose DBC is a multiple of SYT_INTERVAL (0xFFFF if
+ * it has none). Frames are counted within the second, so this too is exact and never drifts.
+ *
+ * SYT is the presentation time plus the transfer delay; the cycle counter wraps after 128
+ * seconds, which is a multiple of 16 cycles, so SYT stays continuous across the wrap.
+ *
+ * Pure logic with no clock or allocation; all methods are real-time safe.
+ */
+class AmdtpTimingGenerator {
+public:
+    static constexpr uint32_t kTicksPerCycle = 3072;
+    static constexpr uint32_t kCyclesPerSecond = 8000;
+    static constexpr uint32_t kCyclesPerWrap = 128 * kCyclesPerSecond;   ///< 7-bit seconds field
+    static constexpr uint32_t kDefaultTransferDelayTicks = 0x2E00;      ///< ~479 us, as Linux firewire-lib
+
+    /// @param sampleRate Nominal rate in Hz; isValid() is false for rates not in kAmdtpRates
+    explicit AmdtpTimingGenerator(uint32_t sampleRate,
+                                  uint32_t transferDelayTicks = kDefaultTransferDelayTicks,
+                                  AmdtpTransmissionMode mode = AmdtpTransmissionMode::Blocking);
+
+    bool isValid() const { return rate_ != nullptr; }
+    uint8_t sfc() const { return rate_ ? rate_->sfc : 0xFF; }
+    AmdtpTransmissionMode mode() const { return mode_; }
+    /// Most data blocks next() puts in one packet
+    uint32_t framesPerPacket() const;
+
+    /**
+     * @brief Restart the sequence with the first data packet in startCycle.
+     * @param startCycle Cycle index seconds * 8000 + cycle (see cycleIndex()); taken mod 128 s
+     * @param dbc DBC of that packet: 0 for a new stream, dbc() to resynchronize one in place
+     */
+    void reset(uint32_t startCycle, uint8_t dbc = 0);
+
+    /// Timing for the next cycle, then advance by one cycle
+    CycleTiming next();
+
+    /// Cycle index (0 .. kCyclesPerWrap-1) the next call to next() describes
+    uint32_t cycle() const { return cycle_; }
+
+    /// DBC of the next data packet (also what empty packets before it carry)
+    uint8_t dbc() const { return dbc_; }
+
+    /// seconds * 8000 + cycle of a 32-bit cycle-timer value (seconds:7, cycle:13, offset:12)
+    static constexpr uint32_t cycleIndex(uint32_t cycleTime) {
+        return ((cycleTime >> 25) & 0x7F) * kCyclesPerSecond + ((cycleTime >> 12) & 0x1FFF);
+    }
+
+private:
+    static uint32_t nextCycle(uint32_t c) { return c + 1 == kCyclesPerWrap ? 0 : c + 1; }
+
+    CycleTiming nextNonBlocking();
+    uint16_t syt(uint32_t cycle, uint32_t ticks) const;
+
+    const AmdtpRateInfo* rate_;
+    AmdtpTransmissionMode mode_;
+    uint32_t interval_;        // SYT_INTERVAL (0 if the rate is unknown)
+    uint32_t stepTicks_;       // whole ticks between packets
+    uint32_t stepRemainder_;   // plus stepRemainder_ / denominator_
+    uint32_t denominator_;
+    uint32_t delayCycles_;     // transfer delay split into whole cycles ...
+    uint32_t delayTicks_;      // ... and the rest
+
+    uint32_t cycle_{0};        // cycle described by the next next() call
+    uint32_t packetCycle_{0};  // cycle of the next data packet's presentation time ...
+    uint32_t packetTicks_{0};  // ... and its offset within that cycle
+    uint32_t fraction_{0};     // accumulated remainder, < denominator_
+    uint32_t secondCycle_{0};  // non-blocking: cycles since the start of the current second ...
+    uint32_t secondFrame_{0};  // ... and frames presented in them
+    uint8_t  dbc_{0};
+};
+
+} // namespace Isoch
+} // namespace FWA
@@ -11,6 +11,11 @@
 
 #include "FWA/Error.h"
 #include "Isoch/core/TransmitterTypes.hpp"
+#include "Isoch/core/AmdtpTimingGenerator.hpp"
+#include "Isoch/core/TransmitterEvents.hpp"
+#include "Isoch/core/TransmitRecovery.hpp"
+#include "Isoch/core/PacketTimeInterpolator.hpp"
+#include "Isoch/core/TransmitRenderPipeline.hpp"
 #include "Isoch/interfaces/ITransmitBufferManager.hpp"
 #include "Isoch/interfaces/ITransmitDCLManager.hpp"
 #include "Isoch/interfaces/ITransmitPacketProvider.hpp"
@@ -44,10 +49,18 @@ public:
 
     // Method for client to push data into the transmitter's provider
     bool pushAudioData(const void* buffer, size_t bufferSizeInBytes);
+    // Same, for interleaved float32 / int16 / packed int24 / int32 samples (converted on ingest)
+    bool pushAudioData(const void* buffer, size_t bufferSizeInBytes, AM824InputFormat format);
+    // MIDI bytes for port (0 .. 8 x config midiSlots - 1); false if queue full or no MIDI slots
+    bool pushMidiData(uint32_t port, const uint8_t* bytes, size_t count);
 
     // Set message callback
     void setMessageCallback(MessageCallback callback, void* refCon);
 
+    // Totals of the faults counted by the DCL completion callback since creation.
+    // The same counts reach the message callback summarized as TransmitterMessage::EventSummary.
+    TransmitterEventSnapshot getEventCounters() const { return events_.snapshot(); }
+
     // Get underlying runloop
     CFRunLoopRef getRunLoopRef() const { return runLoopRef_; }
 
@@ -70,16 +83,34 @@ private:
     static void DCLCompleteCallback_Helper(uint32_t completedGroupIndex, void* refCon);
     static void DCLOverrunCallback_Helper(void* refCon);
     static void TransportFinalize_Helper(void* refCon); // If needed
+    static void EventSummary_Helper(const TransmitterEventSnapshot& delta,
+                                    const TransmitterEventSnapshot& totals, void* refCon);
+    static void RenderGroup_Helper(const TransmitRenderJob& job, void* refCon);
+
+    // Per-group work of the completion callback, split so rendering can move to the worker
+    void renderGroup(const TransmitRenderJob& job);   // provider pull, CIP and isoch headers
+    void publishGroup(IOFireWireLibLocalIsochPortRef localPort, uint32_t group); // DCL ranges, Notify
+    void publishRendered(IOFireWireLibLocalIsochPortRef localPort); // Pipeline mode: whatever the worker has finished
 
      // CIP Header/Timing generation logic
      void initializeCIPState();
-     void prepareCIPHeader(CIPHeader* outHeader); // Fills header based on state
+     CycleTiming prepareCIPHeader(CIPHeader* outHeader); // Fills header for the next cycle, returns its timing
+     void writeNoDataHeader(CIPHeader* outHeader) const;  // Empty packet, next DBC, without advancing
+
+     // Overrun recovery: overwrite every packet with NO_DATA and tell the hardware, in place.
+     // In pipeline mode the worker writes the ring and the callback publishes it once taken.
+     void reprimeRing(IOFireWireLibLocalIsochPortRef localPort); // Either mode; never waits for the worker
+     void writeNoDataRing();                                      // DMA slots only
+     void publishRing(IOFireWireLibLocalIsochPortRef localPort);  // DCL ranges and Notify, every group
+     uint32_t readCycleTime(uint32_t fallback) const; // Bus cycle timer now, or fallback if unavailable
      
      // Helper to send messages to the client
      void notifyMessage(TransmitterMessage msg, uint32_t p1 = 0, uint32_t p2 = 0);
 
     // Configuration & Logger
     TransmitterConfig config_;
+    AmdtpStreamFormat streamFormat_;   // derived from config_ once; drives DBS, DBC step and payload size
+    AmdtpTimingGenerator timing_;      // per-cycle data blocks/DBC/SYT for streamFormat_ (rate and mode)
     std::shared_ptr<spdlog::logger> logger_;
 
     // Manager Components
@@ -91,29 +122,30 @@ private:
 
     // RunLoop
     CFRunLoopRef runLoopRef_{nullptr};
+    IOFireWireLibNubRef interface_{nullptr}; // Non-owning, for the bus cycle timer
 
     // State
     std::atomic<bool> initialized_{false};
     std::atomic<bool> running_{false};
+    std::atomic<bool> stopping_{false};            // stopTransmit() is draining the DCL callbacks
+    std::atomic<uint32_t> callbacksInFlight_{0};   // DCL callbacks entered, running or not
     std::mutex stateMutex_;
 
      // CIP Header State
-     uint8_t dbc_count_{0};
-     bool wasNoData_{true}; // Start assuming previous was NoData
-     uint16_t sytOffset_{0};
-     uint32_t sytPhase_{0}; // For 44.1kHz calculation
-     bool firstDCLCallbackOccurred_{false};
+     TransmitRecovery recovery_;          // Starting -> Running, overrun detection and in-place recovery
+     PacketTimeInterpolator packetTimes_; // Per-packet bus/host time, anchored once per completion
+
+    // Pre-render mode only (TransmitterConfig::preRenderPipeline): renders groups off the callback
+    std::unique_ptr<TransmitRenderPipeline> pipeline_;
      uint32_t expectedTimeStampCycle_{0}; // For timestamp checking
 
     // Client Callbacks
     MessageCallback messageCallback_{nullptr};
     void* messageCallbackRefCon_{nullptr};
 
-    // Static constants for SYT calc (44.1kHz)
-    static constexpr uint32_t SYT_PHASE_MOD = 147;
-    static constexpr uint32_t SYT_PHASE_RESET = 1470;
-    static constexpr uint32_t BASE_TICKS = 1386; // ~1/8 of TICKS_PER_CYCLE
-    static constexpr uint32_t TICKS_PER_CYCLE = 3072;
+    // Fault counting: the DCL callback only records, the dispatcher thread reports
+    TransmitterEventCounters events_;
+    TransmitterEventDispatcher eventDispatcher_{events_};
 };
 
 } // namespace Isoch
@@ -23,6 +23,9 @@ public:
 
     // Calculate the estimated presentation time for a given absolute sample index
     uint64_t getPresentationTimeNs(uint64_t absoluteSampleIndex);
+
+    // Same, in host (mach_absolute_time) ticks: the unit of TimeStamp_POD::hostTime and the clock record
+    uint64_t getPresentationHostTime(uint64_t absoluteSampleIndex);
     
     // Set target sample rate
     void setSampleRate(double rate);
@@ -39,6 +42,10 @@ public:
     // Helper to be called when the first valid SYT is received AFTER initialize
     void updateInitialSYT(uint16_t firstSyt, uint32_t firstSytFwTimestamp, uint64_t firstSytAbsSampleIndex);
 
+    // Publish the sample/host mapping into this segment's clock record on every SYT update
+    // (the driver reads it for its zero timestamps). An empty view disables publishing.
+    void setClockPublishTarget(RTShmRing::RingView ring);
+
 private:
     std::shared_ptr<spdlog::logger> logger_;
     std::atomic<bool> initialized_{false}; // Use atomic for thread safety
@@ -81,8 +88,13 @@ private:
     double integralMax_ = 0.001;       // Max accumulator value (prevents windup)
     double integralMin_ = -0.001;      // Min accumulator value
 
+    // Shared-memory clock record (see setClockPublishTarget)
+    RTShmRing::ControlBlock_POD* clockTarget_ = nullptr;
+    uint64_t clockSeed_ = 0;                   // bumped on every initialize(), i.e. every re-lock
+
     // Helper methods
     void initializeHostClockInfo();
+    void publishClock();
     uint64_t absolute_to_nanoseconds(uint64_t mach_time) const;
     uint64_t nanoseconds_to_absolute(uint64_t nano_time) const;
 };
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief Per-packet bookkeeping for a segmented send DCL program, sized once at creation.
+ *
+ * Keeps every send-packet DCL in program order, so the DCLs of segment g are one contiguous
+ * packetsPerGroup-long array that can be handed to the local isoch port's Notify() as is,
+ * and the ranges each DCL was last given, so a caller can skip SetDCLRanges when a packet
+ * goes out with the same ranges as on the previous lap of the ring (the common case: the
+ * payload address of a slot never moves and the DATA / NO_DATA pattern mostly repeats).
+ *
+ * Only build() and clear() allocate; everything used from the DCL completion callback is
+ * real-time safe. Range is IOVirtualRange in the driver (anything with address and length
+ * members works), which keeps this free of IOKit and testable on any host.
+ */
+template <typename Range>
+class DCLSegmentTable {
+public:
+    static constexpr uint32_t kMaxRanges = 2;   ///< CIP header + payload
+
+    /// Size for numGroups * packetsPerGroup packets: no DCLs, no ranges recorded
+    void build(uint32_t numGroups, uint32_t packetsPerGroup) {
+        numGroups_ = numGroups;
+        packetsPerGroup_ = packetsPerGroup;
+        dcls_.assign(size_t(numGroups) * packetsPerGroup, nullptr);
+        ranges_.assign(dcls_.size(), RangeSet{});
+    }
+
+    void clear() {
+        numGroups_ = 0;
+        packetsPerGroup_ = 0;
+        dcls_.clear();
+        ranges_.clear();
+    }
+
+    /// Record the DCL of packet index (group * packetsPerGroup + packet) and the ranges it was created with
+    void setDCL(uint32_t packetIndex, void* dcl, const Range* ranges, uint32_t numRanges) {
+        dcls_[packetIndex] = dcl;
+        remember(packetIndex, ranges, numRanges);
+    }
+
+    /// True once build() has run and every packet has a DCL
+    bool isComplete() const {
+        return !dcls_.empty() && std::find(dcls_.begin(), dcls_.end(), nullptr) == dcls_.end();
+    }
+
+    /// The segment's segmentSize() DCLs in program order, or nullptr for a group out of range
+    void** segment(uint32_t group) {
+        return group < numGroups_ ? dcls_.data() + size_t(group) * packetsPerGroup_ : nullptr;
+    }
+
+    uint32_t segmentSize() const { return packetsPerGroup_; }
+    size_t packetCount() const { return dcls_.size(); }
+
+    /// True if packetIndex's DCL was last given exactly these ranges
+    bool isUnchanged(uint32_t packetIndex, const Range* ranges, uint32_t numRanges) const {
+        const RangeSet& last = ranges_[packetIndex];
+        if (last.count != numRanges) return false;
+        for (uint32_t i = 0; i < numRanges; ++i) {
+            if (last.ranges[i].address != ranges[i].address || last.ranges[i].length != ranges[i].length)
+                return false;
+        }
+        return true;
+    }
+
+    /// Record the ranges packetIndex's DCL now uses; call after SetDCLRanges succeeds
+    void remember(uint32_t packetIndex, const Range* ranges, uint32_t numRanges) {
+        RangeSet& last = ranges_[packetIndex];
+        if (numRanges > kMaxRanges) {
+            last.count = kUnknown;
+            return;
+        }
+        last.count = numRanges;
+        std::copy(ranges, ranges + numRanges, last.ranges);
+    }
+
+    /// Forget packetIndex's ranges so the next update is always applied (e.g. after a failed set)
+    void invalidate(uint32_t packetIndex) { ranges_[packetIndex].count = kUnknown; }
+
+private:
+    static constexpr uint32_t kUnknown = ~0u;
+
+    struct RangeSet {
+        uint32_t count{kUnknown};
+        Range ranges[kMaxRanges]{};
+    };
+
+    uint32_t numGroups_{0};
+    uint32_t packetsPerGroup_{0};
+    std::vector<void*> dcls_;        // program order; segment g starts at g * packetsPerGroup_
+    std::vector<RangeSet> ranges_;
+};
+
+} // namespace Isoch
+} // namespace FWA
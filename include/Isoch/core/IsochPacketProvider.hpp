@@ -2,6 +2,9 @@
 
 #include "Isoch/interfaces/ITransmitPacketProvider.hpp"
 #include "Isoch/utils/RingBuffer.hpp" // Include RingBuffer - WE OWN IT NOW
+#include "Isoch/core/AdaptiveLatencyController.hpp"
+#include "Isoch/core/AmdtpStreamFormat.hpp"
+#include "Isoch/core/MidiMultiplexer.hpp"
 #include <atomic>
 #include <chrono>
 #include <spdlog/spdlog.h> // Use main spdlog header
@@ -11,8 +14,10 @@ namespace Isoch {
 
 class IsochPacketProvider : public ITransmitPacketProvider {
 public:
+    // The ring holds interleaved AM824 quadlets, format.audioChannels per frame, encoded on push
     explicit IsochPacketProvider(std::shared_ptr<spdlog::logger> logger,
-                                 size_t ringBufferSize = 131072); // Default size
+                                 size_t ringBufferSize = 131072, // Default size
+                                 const AmdtpStreamFormat& format = {});
     ~IsochPacketProvider() override;
 
     // Prevent Copy
@@ -21,6 +26,8 @@ public:
 
     // --- Method for XPC Bridge to call ---
     bool pushAudioData(const void* buffer, size_t bufferSizeInBytes) override;
+    bool pushAudioData(const void* buffer, size_t bufferSizeInBytes, AM824InputFormat format) override;
+    bool pushMidiData(uint32_t port, const uint8_t* bytes, size_t count) override;
     // ------------------------------------------
 
     PreparedPacketData fillPacketData(
@@ -39,23 +46,35 @@ public:
     [[nodiscard]] uint32_t getAvailableWriteBytes() const {
         return audioBuffer_.write_space();
     }
+    [[nodiscard]] size_t getBufferedBytes() const override {
+        return audioBuffer_.read_space();
+    }
+    // Current adaptive prime/target fill in bytes
+    [[nodiscard]] size_t getTargetFillBytes() const override {
+        return latency_.target();
+    }
     // -----------------------------------------------------------
 
 private:
     void handleUnderrun(const TransmitPacketInfo& info);
+    void fillMidiSlots(uint8_t* targetBuffer, size_t frames, const TransmitPacketInfo& info);
 
     std::shared_ptr<spdlog::logger> logger_;
     // --- Own the RingBuffer ---
     raul::RingBuffer audioBuffer_;
     // -------------------------------------
 
-    std::atomic<bool> isInitialized_{false};
+    std::atomic<bool> isInitialized_{false}; // primed to the latency target; cleared on underrun
     std::atomic<size_t> underrunCount_{0};
 
+    // Chooses the prime/target fill at runtime (starts at 50% of the ring)
+    AdaptiveLatencyController latency_;
+
     // Configuration/Constants
-    static constexpr size_t INITIAL_FILL_TARGET_PERCENT = 50;
-    static constexpr uint32_t AM824_LABEL = 0x40; // 24-bit audio label
-    static constexpr uint32_t LABEL_SHIFT = 24; // Shift for 24-bit label
+    AmdtpStreamFormat format_;
+
+    // MIDI byte queues, multiplexed into every packet's MIDI slots (none without MIDI slots)
+    MidiMultiplexer midi_;
 
     // Stats counters (now internal to this class)
     std::chrono::steady_clock::time_point lastStatsTime_;
@@ -84,6 +84,14 @@ public:
      */
     std::expected<void, IOKitError> configure(IOFWSpeed speed, uint32_t channel);
 
+    /**
+     * @brief Sets the per-packet payload (CIP header + data blocks) reserved with the IRM.
+     * Must be called before `setupLocalPortAndChannel`. Defaults to 72 bytes (stereo AM824).
+     *
+     * @param bytes Largest isoch payload the stream will send, excluding the 4-byte isoch header.
+     */
+    void setIRMPacketSize(uint32_t bytes) { irmPacketSize_ = bytes; }
+
     /**
      * @brief Gets the NuDCL Pool reference created during initialization.
      *
@@ -184,6 +192,7 @@ private:
     IOFWSpeed configuredSpeed_{kFWSpeed100MBit};
     uint32_t configuredChannel_{kAnyAvailableIsochChannel};
     uint32_t activeChannel_{kAnyAvailableIsochChannel}; // Negotiated channel
+    uint32_t irmPacketSize_{72}; // Bandwidth to reserve per packet (8 bytes CIP header + 64 bytes samples)
 
     // State
     bool initialized_{false};
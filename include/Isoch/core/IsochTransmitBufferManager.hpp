@@ -27,16 +27,22 @@ public:
     size_t getClientAudioBufferSize() const override;
     size_t getAudioPayloadSizePerPacket() const override;
 
+    const TransmitPacketDescriptor* getPacketDescriptors() const override { return packets_.data(); }
+    uint32_t getPacketCount() const override { return static_cast<uint32_t>(packets_.size()); }
+    void bindPacketDCL(uint32_t packetIndex, NuDCLSendPacketRef dcl) override;
+
     const IOVirtualRange& getBufferRange() const override;
     size_t getTotalBufferSize() const override;
 
 private:
     void calculateBufferLayout();
+    void buildPacketDescriptors();
 
     std::shared_ptr<spdlog::logger> logger_;
     TransmitterConfig config_; // Store local copy
     uint32_t totalPackets_{0};
     size_t audioPayloadSizePerPacket_{0}; // Calculated based on channels/format
+    size_t clientBufferUsableSize_{0};    // clientBufferSize rounded down to whole packets
 
     // Buffer management
     uint8_t* mainBuffer_{nullptr};
@@ -49,6 +55,9 @@ private:
     uint8_t* cipHeaderArea_{nullptr};   // Pre-filled area
     uint32_t* timestampArea_{nullptr};  // Timestamp area
 
+    // One entry per packet, resolved from the pointers above (see TransmitPacketDescriptor)
+    std::vector<TransmitPacketDescriptor> packets_;
+
     // Buffer section sizes (aligned)
     size_t clientBufferSize_aligned_{0};
     size_t isochHeaderTotalSize_aligned_{0};
@@ -3,6 +3,7 @@
 #include "Isoch/interfaces/ITransmitDCLManager.hpp"
 #include "Isoch/interfaces/ITransmitBufferManager.hpp"
 #include "Isoch/core/TransmitterTypes.hpp"
+#include "Isoch/core/DCLSegmentTable.hpp"
 #include <vector>
 #include <mutex>
 #include <atomic>
@@ -41,6 +42,14 @@ public:
         const IsochHeaderData* isochHeaderTemplate
     ) override;
 
+    std::expected<void, IOKitError> setDCLRanges(
+        uint32_t packetIndex,
+        NuDCLSendPacketRef dcl,
+        const IOVirtualRange ranges[],
+        uint32_t numRanges) override;
+
+    NuDCLSendPacketRef getDCLRef(uint32_t groupIndex, uint32_t packetIndexInGroup) override;
+
      std::expected<void, IOKitError> notifySegmentUpdate(
          IOFireWireLibLocalIsochPortRef localPort,
          uint32_t groupIndexToNotify) override;
@@ -64,8 +73,7 @@ private:
     void handleDCLOverrun(NuDCLRef dcl);
 
     // Internal helpers
-    NuDCLSendPacketRef getDCLRef(uint32_t groupIndex, uint32_t packetIndexInGroup); // Removed const qualifier
-    IOReturn notifyDCLUpdates(IOFireWireLibLocalIsochPortRef localPort, NuDCLRef dcls[], uint32_t count);
+    IOReturn notifyDCLUpdates(IOFireWireLibLocalIsochPortRef localPort, void* dcls[], uint32_t count);
     IOReturn notifyJumpUpdate(IOFireWireLibLocalIsochPortRef localPort, NuDCLRef* dclRefPtr);
 
 
@@ -80,6 +88,7 @@ private:
     NuDCLSendPacketRef overrunDCL_{nullptr};
     std::vector<DCLCallbackInfo> callbackInfos_; // Store refcon data for each group
      std::vector<CFMutableSetRef> updateBags_; // Update bags per segment completion DCL
+    DCLSegmentTable<IOVirtualRange> segments_; // Per-segment Notify lists + last ranges, built with the program
 
     // State
     bool dclProgramCreated_{false};
@@ -67,6 +67,17 @@ public:
      * @return std::expected<void, IOKitError> Success or error code
      */
     std::expected<void, IOKitError> stop(IOFireWireLibIsochChannelRef channel);
+
+    /**
+     * @brief Stop and restart a running channel without releasing it
+     *
+     * Used for in-place overrun recovery: the channel, its bandwidth and the DCL
+     * program stay allocated, the hardware just resumes from the program start.
+     *
+     * @param channel FireWire isochronous channel
+     * @return std::expected<void, IOKitError> Success or error code
+     */
+    std::expected<void, IOKitError> restart(IOFireWireLibIsochChannelRef channel);
     
     /**
      * @brief Get current transport state
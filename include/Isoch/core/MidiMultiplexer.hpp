@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Isoch/utils/RingBuffer.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief Per-port MIDI byte queues multiplexed into the MIDI conformant slots of AM824 data blocks.
+ *
+ * IEC 61883-6 (MPX-MIDI) puts eight MIDI ports on each MIDI conformant slot: the data block
+ * whose DBC is d carries port d mod 8 of every slot, slot k serving ports 8k .. 8k+7. A slot
+ * holds either one byte (label 0x81) or nothing (0x80). Each port is held to the MIDI wire
+ * rate of 3125 bytes/s, counted in data blocks rather than host time, so a device's DIN
+ * output never falls behind however fast its queue is fed; idle time earns no credit.
+ *
+ * push() is lock-free with one producer per port; fill() is the consumer and is real-time
+ * safe. reset() must not run concurrently with either.
+ */
+class MidiMultiplexer {
+public:
+    static constexpr uint32_t kPortsPerSlot = 8;
+    static constexpr uint32_t kBytesPerSecond = 3125;    ///< 31.25 kbaud, 10 bits per byte
+    static constexpr uint32_t kDefaultQueueBytes = 1024; ///< Per port (rounded up to a power of two)
+
+    /**
+     * @param midiSlots MIDI conformant slots per data block (AmdtpStreamFormat::midiSlots)
+     * @param sampleRate Data blocks per second, the clock the rate limit runs on
+     */
+    MidiMultiplexer(uint32_t midiSlots, uint32_t sampleRate, uint32_t queueBytes = kDefaultQueueBytes);
+
+    MidiMultiplexer(const MidiMultiplexer&) = delete;
+    MidiMultiplexer& operator=(const MidiMultiplexer&) = delete;
+
+    uint32_t ports() const { return static_cast<uint32_t>(ports_.size()); }
+
+    /// Queue count bytes for port, all or nothing (false if the port is unknown or its queue too full)
+    bool push(uint32_t port, const uint8_t* bytes, size_t count);
+
+    /// Bytes waiting for port
+    size_t queued(uint32_t port) const;
+
+    /**
+     * @brief Write the MIDI slots of frames consecutive data blocks, in wire byte order.
+     * @param blocks First data block; blocks are dbs quadlets apart
+     * @param firstSlot Quadlet index of the first MIDI slot in a block (the audio slot count)
+     * @param dbc Data block counter of the first block, from the packet's CIP header
+     */
+    void fill(uint32_t* blocks, size_t frames, uint32_t dbs, uint32_t firstSlot, uint8_t dbc);
+
+    /// Drop everything queued and restart the rate clock
+    void reset();
+
+private:
+    struct Port {
+        explicit Port(uint32_t queueBytes) : queue(queueBytes) {}
+        raul::RingBuffer queue;
+        uint64_t nextByteAt{0};   // clock_ value from which the port may send its next byte
+    };
+
+    uint32_t midiSlots_;
+    uint32_t ticksPerByte_;       // sampleRate: clock_ advances kBytesPerSecond per data block
+    std::vector<std::unique_ptr<Port>> ports_;
+    uint64_t clock_{0};           // data blocks filled since reset(), in kBytesPerSecond units
+};
+
+} // namespace Isoch
+} // namespace FWA
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief When one transmit packet goes out, on the bus clock and on the host clock.
+ */
+struct PacketTime {
+    uint64_t hostNano{0};    ///< Host time (ns) at the start of the packet's cycle
+    uint32_t cycleTime{0};   ///< Cycle-timer value of that cycle (seconds:7, cycle:13, offset 0)
+};
+
+/**
+ * @brief Maps future transmit cycles to bus and host time from one clock reading per group.
+ *
+ * The transmitter anchors it once per DCL completion with a cycle-timer value and the host
+ * time it was read at, then asks for the time of each packet it prepares by the cycle index
+ * the packet goes out in. The bus time is exact; the host time is the anchor plus the
+ * elapsed bus time at 125 us per cycle (3072 offset ticks). Re-anchoring every group keeps
+ * the drift between the two clocks, a few ppm, to nanoseconds over one ring.
+ *
+ * The anchor is best taken from a live cycle-timer read paired with the host time right
+ * after it. Anchoring with the completion stamp instead makes every host time late by the
+ * callback latency.
+ *
+ * Pure logic with no clock or allocation; all methods are real-time safe.
+ */
+class PacketTimeInterpolator {
+public:
+    static constexpr uint64_t kNanosPerCycle = 125000;
+
+    /// Clock pair for the group being prepared: cycleTime read at host time hostNano
+    void anchor(uint32_t cycleTime, uint64_t hostNano);
+
+    /// Forget the anchor: at() returns zeros until the next anchor()
+    void reset() { anchored_ = false; }
+
+    bool isAnchored() const { return anchored_; }
+
+    /**
+     * @param cycle Cycle index (seconds * 8000 + cycle) the packet goes out in; it may be up to
+     *              64 s before or after the anchor across the 128 s wrap
+     */
+    PacketTime at(uint32_t cycle) const;
+
+    /// Cycle-timer value, offset 0, of a cycle index
+    static constexpr uint32_t cycleTimeOf(uint32_t cycle) {
+        return ((cycle / 8000 % 128) << 25) | ((cycle % 8000) << 12);
+    }
+
+private:
+    bool anchored_{false};
+    uint32_t anchorCycle_{0};   // cycle index of the anchor reading ...
+    uint32_t anchorOffset_{0};  // ... and its offset ticks into that cycle
+    uint64_t anchorHost_{0};
+};
+
+} // namespace Isoch
+} // namespace FWA
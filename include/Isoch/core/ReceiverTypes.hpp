@@ -4,6 +4,8 @@
 #include <memory>
 #include <vector> // Added for ProcessedSample vector
 #include <spdlog/logger.h>
+#include "shared/SharedMemoryStructures.hpp" // For RTShmRing::RingView
+#include "Isoch/utils/FrameRingBuffer.hpp"
 
 namespace FWA {
 namespace Isoch {
@@ -84,6 +86,8 @@ struct ReceiverConfig {
     uint32_t timeout{1000};           ///< Timeout for no-data detection in milliseconds
     bool doIRMAllocations{true};      ///< Whether to use IRM allocations
     uint32_t irmPacketSize{72};       ///< Packet size for IRM allocations
+    RTShmRing::RingView captureRing{}; ///< If valid, processed frames are also written to this daemon->driver shm ring (float32)
+    RTShmRing::RingView clockRing{};   ///< If valid, the PLL publishes the bus clock into this segment's clock record (normally the playback ring)
     std::shared_ptr<spdlog::logger> logger; ///< Logger for diagnostics
 };
 
@@ -149,5 +153,8 @@ struct ProcessedAudioFrame {
     uint64_t presentationNanos{0};///< Host time (in nanoseconds) when this sample should be presented
 };
 
+/// Receiver → application ring, one ProcessedAudioFrame per slot
+using AppRingBuffer = raul::FrameRingBuffer<ProcessedAudioFrame>;
+
 } // namespace Isoch
 } // namespace FWA
\ No newline at end of file
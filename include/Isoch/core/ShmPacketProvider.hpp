@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Isoch/interfaces/ITransmitPacketProvider.hpp"
+#include "Isoch/core/AdaptiveLatencyController.hpp"
+#include "Isoch/core/AmdtpStreamFormat.hpp"
+#include "shared/SharedMemoryStructures.hpp"
+#include <atomic>
+#include <spdlog/spdlog.h>
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief Packet provider that reads audio straight out of the driver's shared-memory ring.
+ *
+ * fillPacketData() encodes AM824 directly from the mapped RTShmRing frame area into the DCL
+ * payload buffer and then retires the frames, so there is exactly one pass over each sample
+ * between the CoreAudio IO cycle and the DMA buffer. No intermediate queue, no heap traffic.
+ *
+ * The provider is the ring's only consumer while it is installed; RingBufferManager must not
+ * pop from the same ring at the same time.
+ */
+class ShmPacketProvider : public ITransmitPacketProvider {
+public:
+    ShmPacketProvider(std::shared_ptr<spdlog::logger> logger,
+                      RTShmRing::RingView ring,
+                      const AmdtpStreamFormat& format);
+    ~ShmPacketProvider() override;
+
+    // Prevent Copy
+    ShmPacketProvider(const ShmPacketProvider&) = delete;
+    ShmPacketProvider& operator=(const ShmPacketProvider&) = delete;
+
+    // Audio arrives through shared memory; client pushes are rejected.
+    using ITransmitPacketProvider::pushAudioData;
+    bool pushAudioData(const void* buffer, size_t bufferSizeInBytes) override;
+
+    PreparedPacketData fillPacketData(
+        uint8_t* targetBuffer,
+        size_t targetBufferSize,
+        const TransmitPacketInfo& info
+    ) override;
+
+    bool isReadyForStreaming() const override;
+    void reset() override;
+
+    [[nodiscard]] uint64_t getAvailableFrames() const { return RTShmRing::AvailableFrames(ring_); }
+    // Current adaptive prime/target fill in frames
+    [[nodiscard]] uint32_t getTargetFillFrames() const { return latency_.target(); }
+
+private:
+    void encodeFrames(const std::byte* src, uint32_t frames, uint32_t* dst) const;
+    void handleUnderrun(const TransmitPacketInfo& info);
+
+    std::shared_ptr<spdlog::logger> logger_;
+    RTShmRing::RingView ring_;
+    uint32_t numChannels_;        // audio slots per AM824 data block
+    uint32_t blockQuadlets_;      // DBS: audio plus MIDI slots per data block
+    uint32_t ringChannels_;       // channels per frame in the shm ring
+    bool formatSupported_{false};
+
+    std::atomic<bool> primed_{false};   // ring reached the latency target; cleared on underrun
+    std::atomic<size_t> underrunCount_{0};
+    std::atomic<uint64_t> totalPulledFrames_{0};
+
+    // Chooses the prime/target fill at runtime (starts at 50% of the ring)
+    AdaptiveLatencyController latency_;
+
+    static constexpr uint32_t AM824_LABEL = 0x40; // 24-bit audio label
+    static constexpr uint32_t LABEL_SHIFT = 24; // Shift for 24-bit label
+};
+
+} // namespace Isoch
+} // namespace FWA
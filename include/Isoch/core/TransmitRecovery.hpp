@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief Ring geometry and limits for TransmitRecovery.
+ */
+struct TransmitRecoveryConfig {
+    uint32_t numGroups{8};              ///< Groups (segments) in the circular DCL program
+    uint32_t packetsPerGroup{16};       ///< Packets, i.e. cycles, per group
+    uint32_t callbackGroupInterval{1};  ///< Groups between completion callbacks
+    uint32_t maxLagCycles{0};           ///< Callback lag that counts as falling behind; 0 = ring minus two groups
+    uint32_t maxRecoveries{4};          ///< Recoveries tolerated within recoveryWindowCycles ...
+    uint32_t recoveryWindowCycles{8000};///< ... before giving up (8000 cycles = 1 s)
+};
+
+enum class TransmitStreamState : uint8_t {
+    Stopped,      ///< Not streaming
+    Starting,     ///< Transport started, waiting for the first completion to anchor timing
+    Running,      ///< Filling one group per completion
+    Recovering,   ///< Ring re-primed with NO_DATA, waiting for an in-time completion to resync
+    Failed        ///< Too many recoveries; the stream has to be stopped
+};
+
+enum class GroupAction : uint8_t {
+    Idle,       ///< Leave the ring alone (stopped, failed, or draining a stale backlog)
+    Fill,       ///< Refill the completed group from the timing generator
+    Resync,     ///< Restart timing at GroupDecision::resyncCycle, keeping the DBC, then fill
+    Reprime,    ///< Fell behind: overwrite every packet with NO_DATA and fill nothing
+    Fail        ///< Stop the stream
+};
+
+struct GroupDecision {
+    GroupAction action{GroupAction::Idle};
+    uint32_t resyncCycle{0};   ///< Cycle index the refilled group's first packet goes out in (Resync only)
+};
+
+/**
+ * @brief Overrun detection and in-place recovery for the circular transmit DCL program.
+ *
+ * The transmitter asks it what to do at every DCL completion and on the overrun callback.
+ * It falls behind when completions arrive out of sequence or when the bus cycle at callback
+ * time is more than maxLagCycles past the completion (the group about to be filled would go
+ * out stale). Recovery never touches the channel or the buffers: the ring is re-primed with
+ * NO_DATA packets, completions that are still too late are drained, and the first in-time
+ * completion re-anchors DBC/SYT at the cycle the refilled group will really go out in next.
+ * Data resumes on that group's next pass, so a stall of any length costs at most about one
+ * ring (numGroups groups) of silence after it ends.
+ *
+ * Each completion refills the group that has just gone out, for its next pass: the hardware
+ * is already sending the group after it, so that one can never be written safely, while the
+ * completed group leaves the callback almost a full ring of slack.
+ *
+ * Pure logic on 32-bit cycle-timer values, driven by a real or simulated completion source.
+ */
+class TransmitRecovery {
+public:
+    explicit TransmitRecovery(const TransmitRecoveryConfig& config = {});
+
+    void start();   ///< Any state -> Starting; clears the recovery history
+    void stop();    ///< Any state -> Stopped
+
+    /**
+     * @param completedGroup Group whose completion callback this is
+     * @param completionCycleTime Cycle-timer value the hardware stamped on the completion
+     * @param nowCycleTime Cycle-timer value now (completionCycleTime if unknown)
+     */
+    GroupDecision onGroupComplete(uint32_t completedGroup, uint32_t completionCycleTime, uint32_t nowCycleTime);
+
+    /// DCL overrun callback: Reprime (and restart the transport), Fail, or Idle when not streaming
+    GroupAction onOverrun(uint32_t nowCycleTime);
+
+    /// Refill could not be queued (pre-render worker a ring behind): Reprime, Fail, or Idle when
+    /// not streaming. The transport keeps running; the next in-time completion resyncs.
+    GroupAction onRenderBacklog(uint32_t nowCycleTime);
+
+    TransmitStreamState state() const { return state_; }
+    uint32_t recoveries() const { return recoveries_; }
+    uint32_t ringCycles() const { return ringCycles_; }
+    uint32_t maxLagCycles() const { return maxLag_; }
+
+private:
+    GroupAction beginRecovery(uint32_t nowCycle);
+    GroupDecision resync(uint32_t completedGroup, uint32_t completionCycle, uint32_t lag);
+
+    TransmitRecoveryConfig config_;
+    uint32_t ringCycles_;
+    uint32_t maxLag_;
+
+    TransmitStreamState state_{TransmitStreamState::Stopped};
+    uint32_t expectedGroup_{0};
+    uint32_t recoveries_{0};        // since start()
+    uint32_t windowStart_{0};       // cycle index the current recovery window opened at
+    uint32_t windowRecoveries_{0};
+};
+
+} // namespace Isoch
+} // namespace FWA
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief What the render worker needs to prepare one group, captured in the completion callback.
+ */
+struct TransmitRenderJob {
+    static constexpr uint32_t kNoResync = 0xFFFFFFFF;
+    static constexpr uint32_t kAllGroups = 0xFFFFFFFF;
+
+    uint32_t group{0};                  ///< Group to render for its next pass; kAllGroups: re-prime the ring (flush)
+    uint32_t resyncCycle{kNoResync};    ///< Restart timing here (keeping the DBC) before rendering
+    uint32_t anchorCycleTime{0};        ///< Bus clock reading for the packet timestamps ...
+    uint64_t anchorHostNano{0};         ///< ... and the host time it was read at
+};
+
+/**
+ * @brief Real-time worker that renders transmit groups off the DCL completion callback.
+ *
+ * The completion callback submit()s each group the hardware has finished with; the worker
+ * renders it (provider pull, AM824, CIP headers) straight into that group's DMA slots,
+ * which the hardware will not read again for almost a ring. The callback later
+ * takeRendered()s the finished groups, in submission order, and only updates their DCL
+ * ranges and notifies the hardware. The callback's cost is then a constant per group,
+ * independent of channel count and conversion cost; rendering gets up to a ring of slack
+ * instead of the callback's budget.
+ *
+ * Single producer (the callback thread), single worker. submit(), takeRendered(), pending()
+ * and flush() are a few atomic loads and stores: no lock, no allocation, no wakeup and never
+ * a wait for the worker, which polls every quarter group instead. Only stop() waits for it;
+ * it belongs on teardown paths, with no callback left running.
+ */
+class TransmitRenderPipeline {
+public:
+    /// Runs on the worker thread, once per submitted job, in order (plus a kAllGroups job per flush())
+    using RenderFn = void(*)(const TransmitRenderJob& job, void* refCon);
+
+    /// @param capacity Jobs in flight (submitted but not yet taken); the ring's group count
+    explicit TransmitRenderPipeline(uint32_t capacity);
+    ~TransmitRenderPipeline();
+
+    TransmitRenderPipeline(const TransmitRenderPipeline&) = delete;
+    TransmitRenderPipeline& operator=(const TransmitRenderPipeline&) = delete;
+
+    /**
+     * @brief Start the worker; jobs from before start() are dropped.
+     * @param periodNanos Time between submissions (one group), for the worker's real-time policy
+     * @return false if already running or render is null
+     */
+    bool start(RenderFn render, void* refCon, uint64_t periodNanos);
+
+    /// Stop and join the worker; unrendered jobs are dropped. Safe to call when not running.
+    void stop();
+
+    bool isRunning() const { return worker_.joinable(); }
+
+    /// Queue a job for the worker; false if capacity jobs are already in flight
+    bool submit(const TransmitRenderJob& job);
+
+    /// Next rendered group in submission order; false if the oldest job is not rendered yet.
+    /// Jobs dropped by flush() are passed over; kAllGroups once the latest flush's re-prime is
+    /// done, ahead of every group rendered after it.
+    bool takeRendered(uint32_t& group);
+
+    /// Jobs submitted but not yet taken, dropped ones included until the worker has passed them
+    uint32_t pending() const;
+
+    /**
+     * @brief Drop every job not yet taken, without waiting for the worker.
+     *
+     * The worker finishes the job it is on (its result is discarded), then renders a job with
+     * group kAllGroups before anything submitted after the flush: the ring is re-primed on the
+     * worker, which owns the timing state and the DMA slots. takeRendered() reports it done.
+     * Without a running worker the jobs are simply dropped.
+     */
+    void flush();
+
+private:
+    void run(uint64_t periodNanos);
+
+    const uint32_t capacity_;
+    std::vector<TransmitRenderJob> jobs_;
+
+    RenderFn render_{nullptr};
+    void* refCon_{nullptr};
+
+    // Monotonic job counts; the slot for job n is n % capacity_
+    alignas(64) std::atomic<uint32_t> submitted_{0};   // written by the producer
+    alignas(64) std::atomic<uint32_t> rendered_{0};    // written by the worker
+    alignas(64) uint32_t taken_{0};                    // producer only
+    std::atomic<uint32_t> skipUntil_{0};               // jobs before this are dropped unrendered
+    std::atomic<uint32_t> flushes_{0};                 // flush() calls (producer)
+    alignas(64) std::atomic<uint32_t> flushesDone_{0}; // flushes re-primed by the worker
+    uint32_t flushesTaken_{0};                         // producer only
+    std::atomic<bool> stopping_{false};
+
+    std::thread worker_;
+};
+
+} // namespace Isoch
+} // namespace FWA
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief Faults the transmit DCL completion callback counts instead of reporting one by one.
+ */
+enum class TransmitterEvent : uint32_t {
+    BufferUnderrun,     ///< Data packet sent with silence: the provider was short of samples
+    SkippedPacket,      ///< Packet had no descriptor/DCL and was left as on the previous lap
+    DCLUpdateError,     ///< SetDCLRanges failed for a packet
+    NotifyError,        ///< Segment Notify() failed; the hardware may send stale data
+    LateCallback,       ///< Completion callback ran longer than its budget
+    OverrunRecovery,    ///< Fell behind the hardware; ring re-primed and timing resynchronized in place
+    Count
+};
+
+inline constexpr size_t kTransmitterEventCount = static_cast<size_t>(TransmitterEvent::Count);
+
+/**
+ * @brief Plain copy of the event counters: totals, or the difference between two totals.
+ */
+struct TransmitterEventSnapshot {
+    std::array<uint64_t, kTransmitterEventCount> counts{};
+
+    uint64_t operator[](TransmitterEvent e) const { return counts[static_cast<size_t>(e)]; }
+
+    uint64_t total() const {
+        uint64_t sum = 0;
+        for (uint64_t c : counts) sum += c;
+        return sum;
+    }
+
+    /// Events counted since `earlier` (an older snapshot of the same counters)
+    TransmitterEventSnapshot since(const TransmitterEventSnapshot& earlier) const {
+        TransmitterEventSnapshot d;
+        for (size_t i = 0; i < kTransmitterEventCount; ++i) d.counts[i] = counts[i] - earlier.counts[i];
+        return d;
+    }
+};
+
+/**
+ * @brief Monotonic per-event counters, written from the real-time path.
+ *
+ * record() is one relaxed fetch_add: no lock, no callback, no allocation, so an underrun
+ * storm costs the DCL completion callback nothing beyond the counting. Each counter sits
+ * on its own cache line so the reader never bounces the writer's line. Counters are never
+ * reset; readers work with differences between snapshots.
+ */
+class TransmitterEventCounters {
+public:
+    void record(TransmitterEvent e, uint64_t n = 1) noexcept {
+        counters_[static_cast<size_t>(e)].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    TransmitterEventSnapshot snapshot() const noexcept {
+        TransmitterEventSnapshot s;
+        for (size_t i = 0; i < kTransmitterEventCount; ++i)
+            s.counts[i] = counters_[i].value.load(std::memory_order_relaxed);
+        return s;
+    }
+
+private:
+    struct alignas(64) Counter {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<Counter, kTransmitterEventCount> counters_;
+};
+
+/**
+ * @brief Low-priority thread that turns the counters into at most one report per interval.
+ *
+ * Every interval it snapshots the counters and, if anything was counted since the last
+ * report, calls the sink once with the per-event difference and the running totals. The
+ * sink runs on the dispatcher thread, so it may lock, log and call client callbacks.
+ * stop() delivers whatever was counted after the last report before returning.
+ */
+class TransmitterEventDispatcher {
+public:
+    using Sink = void(*)(const TransmitterEventSnapshot& delta,
+                         const TransmitterEventSnapshot& totals, void* refCon);
+
+    static constexpr std::chrono::milliseconds kDefaultInterval{250};
+
+    explicit TransmitterEventDispatcher(const TransmitterEventCounters& counters,
+                                        std::chrono::milliseconds interval = kDefaultInterval);
+    ~TransmitterEventDispatcher();
+
+    TransmitterEventDispatcher(const TransmitterEventDispatcher&) = delete;
+    TransmitterEventDispatcher& operator=(const TransmitterEventDispatcher&) = delete;
+
+    /// Start reporting to sink; events counted before start() are not reported
+    void start(Sink sink, void* refCon);
+
+    /// Stop the thread after a final report; safe to call when not running, and from the sink
+    /// (the thread is then joined by the next start() or stop() on another thread)
+    void stop();
+
+    bool isRunning() const { return thread_.joinable() && !stopping_; }
+    std::chrono::milliseconds interval() const { return interval_; }
+
+private:
+    void run();
+    void dispatch();
+
+    const TransmitterEventCounters& counters_;
+    const std::chrono::milliseconds interval_;
+
+    Sink sink_{nullptr};
+    void* refCon_{nullptr};
+    TransmitterEventSnapshot reported_;   // totals at the last report (dispatcher thread only)
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::atomic<bool> stopping_{false};   // written under mutex_, read lock-free by isRunning()
+    std::thread thread_;
+};
+
+} // namespace Isoch
+} // namespace FWA
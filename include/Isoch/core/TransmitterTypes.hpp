@@ -5,6 +5,8 @@
 #include <functional> // For std::function if used later, though not for basic callbacks
 #include <spdlog/logger.h>
 #include <IOKit/firewire/IOFireWireFamilyCommon.h> // For IOFWSpeed
+#include "shared/SharedMemoryStructures.hpp"       // For RTShmRing::RingView
+#include "Isoch/core/AmdtpStreamFormat.hpp"
 
 // Forward declare RingBuffer if needed, or include header
 // Assumes RingBuffer lives in the raul namespace globally
@@ -32,19 +34,39 @@ struct TransmitterConfig {
 
     // Audio Format & Rate
     double sampleRate{44100.0};        ///< Target audio sample rate in Hz.
-    uint32_t numChannels{2};           ///< Number of audio channels (e.g., 2 for stereo).
-                                       ///< Note: Currently assumes interleaved stereo float in provider.
+    uint32_t numChannels{2};           ///< Audio (MBLA) slots per data block; pushed/ring audio is interleaved int32.
+    uint32_t midiSlots{0};             ///< MIDI conformant slots appended after the audio slots (8 ports each).
+    AmdtpTransmissionMode transmissionMode{AmdtpTransmissionMode::Blocking}; ///< Blocking: SYT_INTERVAL blocks or NO_DATA per cycle.
+                                       ///< NonBlocking: the cycle's own blocks every cycle (lower, steadier latency).
 
     // FireWire Isochronous Parameters
     IOFWSpeed initialSpeed{kFWSpeed400MBit}; ///< Initial speed for channel allocation/negotiation.
     uint32_t initialChannel{0xFFFFFFFF};   ///< Initial channel (0xFFFFFFFF = any available).
     bool doIRMAllocations{true};       ///< Whether to use Isochronous Resource Manager for bandwidth/channel.
-    uint32_t irmPacketPayloadSize{72}; ///< Maximum PAYLOAD size (CIPHdr + AudioData) in bytes for IRM bandwidth calculation.
-                                       ///< Example: 8 bytes CIP Header + 64 bytes Audio Data = 72 bytes.
+    uint32_t irmPacketPayloadSize{0};  ///< Maximum PAYLOAD size (CIPHdr + AudioData) in bytes for IRM bandwidth calculation.
+                                       ///< 0 = derive from the stream format (stereo 44.1kHz: 8 + 64 = 72 bytes).
                                        ///< The Isochronous Header (4 bytes) is NOT included here.
 
+    // Data Source
+    RTShmRing::RingView sharedMemoryRing{}; ///< If valid, audio is read directly from this driver->daemon shm ring
+                                            ///< (ShmPacketProvider) and pushAudioData() is unused.
+
     // Timing & Sync (Potentially add more later)
     uint32_t numStartupCycleMatchBits{0}; ///< For cycle-matching start (0 usually sufficient for transmitter).
+
+    // Threading
+    bool preRenderPipeline{false};     ///< Render groups (provider pull, AM824, CIP) on a real-time worker thread;
+                                       ///< the DCL completion callback then only updates DCL ranges and notifies.
+
+    /// Data block layout and packet sizing implied by the fields above
+    AmdtpStreamFormat streamFormat() const {
+        return { numChannels, midiSlots, static_cast<uint32_t>(sampleRate + 0.5), transmissionMode };
+    }
+
+    /// IRM payload to reserve: the explicit override, else what the stream format needs
+    uint32_t irmPayloadBytes() const {
+        return irmPacketPayloadSize ? irmPacketPayloadSize : streamFormat().irmPayloadBytes();
+    }
 };
 
 // --- Messages & Callbacks ---
@@ -55,13 +77,14 @@ struct TransmitterConfig {
 enum class TransmitterMessage : uint32_t {
     StreamStarted = 0x2000,   ///< Isochronous stream transmission has successfully started.
     StreamStopped,            ///< Isochronous stream transmission has successfully stopped.
-    BufferUnderrun,           ///< Packet provider ran out of client data; silence or NO_DATA sent. (param1=segment, param2=packet)
+    BufferUnderrun,           ///< Packet provider ran out of client data. Counted, not sent per packet: see EventSummary.
     OverrunError,             ///< DCL program overrun occurred (hardware couldn't keep up).
-    OverrunRecoveryAttempt,   ///< Attempting automatic recovery from overrun.
+    OverrunRecoveryAttempt,   ///< Attempting automatic in-place recovery from overrun (param1=recoveries since start).
     OverrunRecoveryFailed,    ///< Automatic recovery from overrun failed; stream stopped.
     AllocatePort,             ///< Remote port allocation occurred (param1=speed, param2=channel). (Info)
     ReleasePort,              ///< Remote port was released. (Info)
     TimestampAdjust,          ///< Internal timestamp adjustment occurred (param1=expected cycle, param2=actual cycle). (Debug/Info)
+    EventSummary,             ///< At most once per report interval, if anything was counted (param1=underrun packets, param2=other faults since the last summary). Breakdown: AmdtpTransmitter::getEventCounters().
     Error                     ///< Generic or unrecoverable error occurred.
 };
 
@@ -127,8 +150,9 @@ struct TransmitPacketInfo {
     uint32_t segmentIndex;        ///< Index of the buffer group (segment) this packet belongs to.
     uint32_t packetIndexInGroup;  ///< Index of this packet within its group (0 to packetsPerGroup-1).
     uint32_t absolutePacketIndex; ///< Index of this packet since stream start (wraps).
-    uint64_t hostTimestampNano;   ///< Estimated host time (nanoseconds) when this packet is expected to be sent.
-    uint32_t firewireTimestamp;   ///< FireWire cycle time (seconds:cycles:offset) associated with this packet's DCL.
+    uint64_t hostTimestampNano;   ///< Host time (nanoseconds, mach_absolute_time scale) at the start of the cycle this packet is sent in.
+    uint32_t firewireTimestamp;   ///< FireWire cycle time (seconds:cycles, offset 0) of the cycle this packet is sent in.
+    uint8_t dataBlockCounter;     ///< DBC in this packet's CIP header: the first data block's counter (selects MIDI ports).
 
     // Add other relevant info if needed, e.g.:
     // uint64_t absoluteSampleFrameIndex; // Estimated sample frame index for the start of this packet
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+namespace FWA {
+namespace Isoch {
+
+/**
+ * @brief Streaming 4-point cubic (Catmull-Rom) varispeed resampler for interleaved PCM.
+ *
+ * Works on 24-bit samples in 32-bit containers, the format IsochPacketProvider expects.
+ * The read position advances by step() input frames per output frame. The step can change
+ * between calls, and the position carries across calls. A step of exactly 1.0 reproduces
+ * the input bit for bit, delayed by two frames.
+ *
+ * Interpolation runs in float. The per-frame channel loop uses SSE2 or NEON in groups of
+ * four channels and does the tail in scalar code.
+ * All buffers are allocated in the constructor. process() does not allocate.
+ */
+class VarispeedResampler {
+public:
+    VarispeedResampler(uint32_t channels, uint32_t maxInputFrames);
+    ~VarispeedResampler();
+
+    VarispeedResampler(const VarispeedResampler&) = delete;
+    VarispeedResampler& operator=(const VarispeedResampler&) = delete;
+
+    void reset();
+
+    /// Input frames consumed per output frame (> 1 shortens the stream). Clamped to +/-1%.
+    void setStep(double inputFramesPerOutputFrame);
+    [[nodiscard]] double step() const { return step_; }
+
+    /// Upper bound on process() output for inFrames input frames at the current step.
+    [[nodiscard]] uint32_t maxOutputFrames(uint32_t inFrames) const;
+
+    /// Resample inFrames (<= maxInputFrames) interleaved frames. Returns frames written, which
+    /// is at most min(maxOutFrames, maxOutputFrames(inFrames)).
+    uint32_t process(const int32_t* in, uint32_t inFrames, int32_t* out, uint32_t maxOutFrames);
+
+    [[nodiscard]] uint32_t channels() const { return channels_; }
+
+private:
+    static constexpr uint32_t kHistory = 3;   // frames carried over between calls
+
+    void interpolateFrame(const float* x, float t, int32_t* out) const;
+
+    uint32_t channels_;
+    uint32_t maxInputFrames_;
+    double step_{1.0};
+    double pos_{1.0};                          // read position in work_ frames, >= 1
+    std::unique_ptr<float[]> work_;            // (kHistory + maxInputFrames) x channels
+};
+
+/**
+ * @brief PI servo that turns ring fill into a resampler step.
+ *
+ * The bus/host ratio from AudioClockPLL gives the nominal step. The servo adds a small
+ * correction (at most maxCorrection) from the smoothed fill error, so the ring settles at
+ * its target instead of drifting towards underrun or overrun.
+ */
+class RateServo {
+public:
+    struct Config {
+        double kp{2e-4};              ///< correction per unit of relative fill error
+        double ki{2e-6};              ///< integral gain, per update
+        double maxCorrection{1e-3};   ///< +/-1000 ppm
+        double smoothing{0.05};       ///< one-pole low-pass on the observed fill
+    };
+
+    RateServo() = default;
+    explicit RateServo(const Config& config) : config_(config) {}
+
+    void reset();
+
+    /// Call once per produced chunk. busPerHost is device rate / host rate (1.0 if unknown).
+    /// Returns the input frames per output frame to use for the next chunk.
+    double update(double fill, double target, double busPerHost);
+
+    [[nodiscard]] double correction() const { return correction_; }
+
+private:
+    Config config_{};
+    double smoothedFill_{-1.0};
+    double integral_{0.0};
+    double correction_{0.0};
+};
+
+} // namespace Isoch
+} // namespace FWA
@@ -9,6 +9,20 @@
 namespace FWA {
 namespace Isoch {
 
+/**
+ * @brief Everything the DCL callback needs to prepare one packet, resolved once at setup.
+ *
+ * Index = groupIndex * packetsPerGroup + packetIndexInGroup. The table is immutable while
+ * streaming, so it is read without locking; 32 bytes keeps two packets per cache line.
+ */
+struct TransmitPacketDescriptor {
+    uint8_t* payload{nullptr};                ///< AM824 data blocks in the client audio area
+    CIPHeader* cipHeader{nullptr};
+    IsochHeaderData* isochHeader{nullptr};
+    NuDCLSendPacketRef dcl{nullptr};          ///< Send-packet DCL, bound after the program is created
+};
+static_assert(sizeof(TransmitPacketDescriptor) == 4 * sizeof(void*), "descriptor stays four pointers");
+
 class ITransmitBufferManager {
 public:
     virtual ~ITransmitBufferManager() = default;
@@ -26,6 +40,12 @@ public:
     virtual size_t getClientAudioBufferSize() const = 0;
     virtual size_t getAudioPayloadSizePerPacket() const = 0; // Calculated size based on config
 
+    // Per-packet descriptor table (built by setupBuffers, lock-free to read afterwards)
+    virtual const TransmitPacketDescriptor* getPacketDescriptors() const = 0;
+    virtual uint32_t getPacketCount() const = 0;
+    // Record a packet's DCL; only during setup, before the callback can run
+    virtual void bindPacketDCL(uint32_t packetIndex, NuDCLSendPacketRef dcl) = 0;
+
     // Get overall range for port creation
     virtual const IOVirtualRange& getBufferRange() const = 0;
     virtual size_t getTotalBufferSize() const = 0;
@@ -40,6 +40,17 @@ public:
         const IsochHeaderData* isochHeaderTemplate // Pointer to the prepared Isoch header
     ) = 0;
 
+    // Same, for a DCL already resolved (see TransmitPacketDescriptor::dcl); no index lookup.
+    // packetIndex is group * packetsPerGroup + packet; unchanged ranges are not re-sent.
+    virtual std::expected<void, IOKitError> setDCLRanges(
+        uint32_t packetIndex,
+        NuDCLSendPacketRef dcl,
+        const IOVirtualRange ranges[],
+        uint32_t numRanges) = 0;
+
+    // Send-packet DCL for a packet, or nullptr if the program has not been created
+    virtual NuDCLSendPacketRef getDCLRef(uint32_t groupIndex, uint32_t packetIndexInGroup) = 0;
+
     // Method to notify the hardware about updated DCLs in a segment
     virtual std::expected<void, IOKitError> notifySegmentUpdate(
          IOFireWireLibLocalIsochPortRef localPort,
@@ -3,6 +3,7 @@
 #include <memory>
 #include <expected>
 #include "Isoch/core/TransmitterTypes.hpp"
+#include "Isoch/utils/AM824Encoder.hpp"
 #include "FWA/Error.h"
 
 namespace FWA {
@@ -15,6 +16,19 @@ public:
     // Method called by client (e.g., XPC bridge) to push audio data INTO the provider
     virtual bool pushAudioData(const void* buffer, size_t bufferSizeInBytes) = 0;
 
+    // Same, for interleaved samples in any AM824InputFormat (float32, int16, packed int24, int32).
+    // Providers that convert on ingest override this; the default only takes int32.
+    virtual bool pushAudioData(const void* buffer, size_t bufferSizeInBytes, AM824InputFormat format) {
+        return format == AM824InputFormat::Int32 && pushAudioData(buffer, bufferSizeInBytes);
+    }
+
+    // Queue MIDI bytes for a port of the stream's MIDI conformant slots (8 ports per slot).
+    // All or nothing; one producer thread per port. Providers without MIDI slots reject it.
+    virtual bool pushMidiData(uint32_t port, const uint8_t* bytes, size_t count) {
+        (void)port; (void)bytes; (void)count;
+        return false;
+    }
+
     // Method called by AmdtpTransmitter to get data FOR a packet
     // It should read from its internal buffer (e.g., ring buffer) and write
     // formatted audio data directly into the provided targetBuffer.
@@ -29,6 +43,11 @@ public:
 
     // Optional: Reset internal buffer state
     virtual void reset() = 0;
+
+    // Optional: Fill level and the level the provider aims for, in bytes. Lets a pushing
+    // client steer its rate (e.g. ShmIsochBridge's resampler). 0 = not reported.
+    virtual size_t getBufferedBytes() const { return 0; }
+    virtual size_t getTargetFillBytes() const { return 0; }
 };
 
 } // namespace Isoch
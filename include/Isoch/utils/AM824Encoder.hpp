@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace FWA {
+namespace Isoch {
+
+/// Host sample layouts the AM824 encoder accepts
+enum class AM824InputFormat : uint8_t {
+    Int32,        ///< 24-bit sample in the low bits of an int32 (upper byte ignored)
+    Float32,      ///< [-1, 1) float, scaled by 2^23, rounded to nearest and clamped
+    PackedInt24,  ///< 3 bytes per sample, little-endian
+    Int16         ///< 16-bit sample, sent as the top 16 bits of the 24 (low byte 0)
+};
+
+/**
+ * @brief Interleaved host samples -> big-endian AM824 quadlets (label 0x40, 24-bit MBLA).
+ *
+ * Samples are independent, so any channel count is just samples = frames x channels.
+ * The kernel is chosen once at startup: AVX2 or SSE4.1 on x86, NEON on ARM, scalar
+ * otherwise. Every kernel is bit-exact with the scalar reference, including NaN and
+ * out-of-range floats. encode() is real-time safe.
+ */
+namespace AM824 {
+
+constexpr uint32_t kAudioLabel = 0x40;
+constexpr uint32_t kMidiLabel = 0x80;   ///< MIDI conformant slot carrying no MIDI bytes
+
+enum class Isa : uint8_t { Scalar, SSE41, AVX2, NEON };
+
+using EncodeFn = void (*)(const void* src, size_t samples, uint32_t* dst);
+
+/// Encode with the best kernel for this CPU
+void encode(AM824InputFormat format, const void* src, size_t samples, uint32_t* dst);
+
+/// Kernel for a specific instruction set, or nullptr if this build/CPU lacks it
+EncodeFn kernel(AM824InputFormat format, Isa isa);
+
+/**
+ * Spread frames x audioChannels packed quadlets (as written by encode()) in place to
+ * dbs-quadlet data blocks, filling each block's slots past audioChannels with empty
+ * MIDI quadlets. dst must hold frames x dbs quadlets. No-op when dbs == audioChannels.
+ */
+void spreadDataBlocks(uint32_t* dst, size_t frames, uint32_t audioChannels, uint32_t dbs);
+
+/// Instruction set encode() uses
+Isa activeIsa();
+
+const char* isaName(Isa isa);
+
+constexpr size_t bytesPerSample(AM824InputFormat format) {
+    switch (format) {
+    case AM824InputFormat::PackedInt24: return 3;
+    case AM824InputFormat::Int16: return 2;
+    default: return 4;
+    }
+}
+
+} // namespace AM824
+} // namespace Isoch
+} // namespace FWA
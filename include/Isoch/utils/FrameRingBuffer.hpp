@@ -0,0 +1,173 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+#ifndef RAUL_FRAMERINGBUFFER_HPP
+#define RAUL_FRAMERINGBUFFER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace raul {
+
+/**
+   A lock-free single-reader/single-writer ring of whole frames.
+
+   A frame is Channels consecutive values of T. Capacity is rounded up to a
+   power of two frames and indices are free-running, so every frame slot is
+   usable and wraparound is a mask. write_frames() and read_frames() move as
+   many whole frames as fit in one call and never split a frame, unlike the
+   byte-oriented RingBuffer.
+
+   The write index, the read index and each side's cached copy of the other
+   index sit on separate cache lines, so producer and consumer cores only
+   share a line when one of them actually runs out of room or data.
+   @ingroup raul
+*/
+template <typename T, uint32_t Channels = 1>
+class FrameRingBuffer
+{
+    static_assert(std::is_trivially_copyable_v<T>, "frames are moved with memcpy");
+    static_assert(Channels > 0, "a frame needs at least one channel");
+
+public:
+    static constexpr uint32_t channels = Channels;
+    static constexpr size_t   frame_bytes = sizeof(T) * Channels;
+
+    /// @param frames Capacity in frames (rounded up to a power of two).
+    explicit FrameRingBuffer(uint32_t frames)
+        : _frames(round_up(frames))
+        , _mask(_frames - 1)
+        , _buf(static_cast<T*>(::operator new[](_frames * frame_bytes, std::align_val_t(kLine))))
+    {
+    }
+
+    FrameRingBuffer(const FrameRingBuffer&) = delete;
+    FrameRingBuffer& operator=(const FrameRingBuffer&) = delete;
+
+    /**
+       Reset (empty) the buffer.
+       NOT thread-safe; only call when there are no readers or writers.
+    */
+    void reset()
+    {
+        _write.index.store(0, std::memory_order_relaxed);
+        _read.index.store(0, std::memory_order_relaxed);
+        _write.cached_other = 0;
+        _read.cached_other = 0;
+    }
+
+    [[nodiscard]] uint32_t capacity() const { return _frames; }
+
+    /// Frames available for reading
+    [[nodiscard]] uint32_t read_space() const
+    {
+        return _write.index.load(std::memory_order_acquire) - _read.index.load(std::memory_order_relaxed);
+    }
+
+    /// Frames available for writing
+    [[nodiscard]] uint32_t write_space() const
+    {
+        return _frames - (_write.index.load(std::memory_order_relaxed) - _read.index.load(std::memory_order_acquire));
+    }
+
+    /// Write up to frames frames (frames * Channels values). Returns frames written.
+    uint32_t write_frames(const T* src, uint32_t frames)
+    {
+        const uint32_t w = _write.index.load(std::memory_order_relaxed);
+        uint32_t space = _frames - (w - _write.cached_other);
+        if (space < frames) {
+            _write.cached_other = _read.index.load(std::memory_order_acquire);
+            space = _frames - (w - _write.cached_other);
+        }
+        const uint32_t n = std::min(frames, space);
+        if (n == 0) {
+            return 0;
+        }
+        const uint32_t start = w & _mask;
+        const uint32_t first = std::min(n, _frames - start);
+        std::memcpy(_buf.get() + size_t(start) * Channels, src, first * frame_bytes);
+        if (first < n) {
+            std::memcpy(_buf.get(), src + size_t(first) * Channels, (n - first) * frame_bytes);
+        }
+        _write.index.store(w + n, std::memory_order_release);
+        return n;
+    }
+
+    /// Read up to frames frames into dst. Returns frames read.
+    uint32_t read_frames(T* dst, uint32_t frames)
+    {
+        const uint32_t n = peek_frames(dst, frames);
+        if (n) {
+            _read.index.store(_read.index.load(std::memory_order_relaxed) + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    /// Like read_frames() but leaves the frames in the buffer
+    uint32_t peek_frames(T* dst, uint32_t frames)
+    {
+        const uint32_t r = _read.index.load(std::memory_order_relaxed);
+        uint32_t avail = _read.cached_other - r;
+        if (avail < frames) {
+            _read.cached_other = _write.index.load(std::memory_order_acquire);
+            avail = _read.cached_other - r;
+        }
+        const uint32_t n = std::min(frames, avail);
+        if (n == 0) {
+            return 0;
+        }
+        const uint32_t start = r & _mask;
+        const uint32_t first = std::min(n, _frames - start);
+        std::memcpy(dst, _buf.get() + size_t(start) * Channels, first * frame_bytes);
+        if (first < n) {
+            std::memcpy(dst + size_t(first) * Channels, _buf.get(), (n - first) * frame_bytes);
+        }
+        return n;
+    }
+
+    /// Drop up to frames frames without reading them. Returns frames dropped.
+    uint32_t skip_frames(uint32_t frames)
+    {
+        const uint32_t r = _read.index.load(std::memory_order_relaxed);
+        _read.cached_other = _write.index.load(std::memory_order_acquire);
+        const uint32_t n = std::min(frames, _read.cached_other - r);
+        _read.index.store(r + n, std::memory_order_release);
+        return n;
+    }
+
+private:
+    static constexpr size_t kLine = 64;
+
+    static uint32_t round_up(uint32_t n)
+    {
+        uint32_t p = 1;
+        while (p < n && p < (1u << 31)) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    struct AlignedDelete {
+        void operator()(T* p) const noexcept { ::operator delete[](p, std::align_val_t(kLine)); }
+    };
+
+    /// One side's index plus its cached view of the other side's index
+    struct alignas(kLine) Side {
+        std::atomic<uint32_t> index{0};
+        uint32_t              cached_other{0};
+    };
+
+    Side _write;                              ///< written by the producer only
+    Side _read;                               ///< written by the consumer only
+    alignas(kLine) const uint32_t _frames;    ///< capacity, power of two
+    const uint32_t _mask;
+    std::unique_ptr<T[], AlignedDelete> _buf;
+};
+
+} // namespace raul
+
+#endif // RAUL_FRAMERINGBUFFER_HPP
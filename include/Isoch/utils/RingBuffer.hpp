@@ -3,18 +3,21 @@
 #ifndef RAUL_RINGBUFFER_HPP
 #define RAUL_RINGBUFFER_HPP
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <limits>
 #include <spdlog/spdlog.h>
-
-// Include ARM NEON headers
-#ifdef __ARM_NEON
-#include <arm_neon.h>
+#if __cplusplus >= 202002L
+#include <bit>
 #endif
 
+#include "Isoch/utils/RingBufferCopy.hpp"
+
 namespace raul {
 
 /**
@@ -26,18 +29,39 @@ namespace raul {
 class RingBuffer
 {
 public:
+    /// A contiguous region of the buffer
+    template <typename T>
+    struct Span {
+        T*       data{nullptr};
+        uint32_t size{0};
+    };
+
+    /**
+       Up to two regions that together cover a reservation. The second one is
+       only non-empty when the reservation wraps around the end of the buffer.
+    */
+    template <typename T>
+    struct Regions {
+        Span<T> first;
+        Span<T> second;
+
+        [[nodiscard]] uint32_t size() const { return first.size + second.size; }
+        explicit operator bool() const { return first.size != 0; }
+    };
+
     /**
        Create a new RingBuffer.
-       @param size Size in bytes (note this may be rounded up).
+       @param size Size in bytes (note this may be rounded up, to at least 64).
     */
     explicit RingBuffer(uint32_t size, std::shared_ptr<spdlog::logger> logger = nullptr)
-        : _size(next_power_of_two(size))
+        : _size(next_power_of_two(std::max<uint32_t>(size, kAlignment)))
         , _size_mask(_size - 1)
-        , _buf(static_cast<char*>(std::aligned_alloc(64, _size)))
+        , _buf(static_cast<char*>(std::aligned_alloc(kAlignment, _size)))
         , _logger(logger)
+        , _copy(copy::kernels())
     {
         if (_logger) {
-            _logger->debug("[RingBuffer] Initialized with size: {} bytes", _size);
+            _logger->debug("[RingBuffer] Initialized with size: {} bytes, {} copy", _size, _copy.name);
             _logger->debug("[RingBuffer] Size in samples: {}", _size / sizeof(int32_t));
         }
         assert(read_space() == 0);
@@ -80,6 +104,13 @@ public:
     /// Return the capacity (i.e. total write space when empty)
     [[nodiscard]] uint32_t capacity() const { return _size - 1; }
 
+    /**
+       Copy transfers of at least bytes with non-temporal stores (disabled by
+       default). Only worth it for large transfers the other side will not
+       touch while they are still in cache. Not thread-safe; set before use.
+    */
+    void set_non_temporal_threshold(uint32_t bytes) { _nt_threshold = bytes; }
+
     /// Read from the RingBuffer without advancing the read head
     uint32_t peek(uint32_t size, void* dst)
     {
@@ -123,7 +154,7 @@ public:
         
         if (w + size <= _size) {
             // Contiguous write
-            neon_memcpy(&_buf[w], src, size);
+            copy_bytes(&_buf[w], src, size);
             std::atomic_thread_fence(std::memory_order_release);
             _write_head = (w + size) & _size_mask;
         } else {
@@ -133,8 +164,8 @@ public:
             assert(w + this_size <= _size);
             
             // Use optimized copy for both parts
-            neon_memcpy(&_buf[w], src, this_size);
-            neon_memcpy(&_buf[0], 
+            copy_bytes(&_buf[w], src, this_size);
+            copy_bytes(&_buf[0], 
                        static_cast<const uint8_t*>(src) + this_size, 
                        size - this_size);
                        
@@ -148,7 +179,71 @@ public:
         return size;
     }
 
+    /**
+       Reserve exactly size bytes for writing in place, or nothing if there is
+       not enough space. Nothing becomes visible to the reader until
+       commit_write(); an unused reservation is simply dropped.
+    */
+    Regions<char> reserve_write(uint32_t size)
+    {
+        const uint32_t r = _read_head.load(std::memory_order_acquire);
+        const uint32_t w = _write_head.load(std::memory_order_relaxed);
+        if (size == 0 || write_space_internal(r, w) < size) {
+            return {};
+        }
+        return regions<char>(w, size);
+    }
+
+    /// Publish size bytes of the last write reservation
+    void commit_write(uint32_t size)
+    {
+        const uint32_t w = _write_head.load(std::memory_order_relaxed);
+        _write_head.store((w + size) & _size_mask, std::memory_order_release);
+        prefetch_next_write();
+    }
+
+    /**
+       Reserve exactly size bytes for reading in place, or nothing if fewer are
+       available. The regions stay valid until commit_read().
+    */
+    Regions<const char> reserve_read(uint32_t size) const
+    {
+        const uint32_t r = _read_head.load(std::memory_order_relaxed);
+        const uint32_t w = _write_head.load(std::memory_order_acquire);
+        if (size == 0 || read_space_internal(r, w) < size) {
+            return {};
+        }
+        return regions<const char>(r, size);
+    }
+
+    /// Release size bytes of the last read reservation back to the writer
+    void commit_read(uint32_t size)
+    {
+        const uint32_t r = _read_head.load(std::memory_order_relaxed);
+        _read_head.store((r + size) & _size_mask, std::memory_order_release);
+        prefetch_next_read();
+    }
+
 private:
+    static constexpr uint32_t kAlignment = 64;
+
+    /// aligned_alloc'ed memory has to go back through free()
+    struct FreeDeleter {
+        void operator()(char* p) const noexcept { std::free(p); }
+    };
+
+    template <typename T>
+    Regions<T> regions(uint32_t start, uint32_t size) const
+    {
+        Regions<T> out;
+        const uint32_t first = std::min(size, _size - start);
+        out.first = {_buf.get() + start, first};
+        if (first < size) {
+            out.second = {_buf.get(), size - first};
+        }
+        return out;
+    }
+
     static uint32_t next_power_of_two(uint32_t s)
     {
 #if __cplusplus >= 202002L
@@ -185,14 +280,14 @@ private:
         
         if (r + size <= _size) {
             // Contiguous read - use optimized copy
-            neon_memcpy(dst, &_buf[r], size);
+            copy_bytes(dst, &_buf[r], size);
         } else {
             // Split read across boundary
             const uint32_t first_size = _size - r;
             
             // Use optimized copy for both parts
-            neon_memcpy(dst, &_buf[r], first_size);
-            neon_memcpy(static_cast<uint8_t*>(dst) + first_size, 
+            copy_bytes(dst, &_buf[r], first_size);
+            copy_bytes(static_cast<uint8_t*>(dst) + first_size, 
                        &_buf[0], 
                        size - first_size);
         }
@@ -202,7 +297,7 @@ private:
     
     // Prefetch the next likely write location
     void prefetch_next_write() const {
-#ifdef __ARM_NEON
+#if defined(__ARM_NEON) || defined(RAUL_COPY_X86)
         const uint32_t next_write = (_write_head + 64) & _size_mask;
         __builtin_prefetch(&_buf[next_write], 1, 0);
 #endif
@@ -210,49 +305,25 @@ private:
     
     // Prefetch the next likely read location
     void prefetch_next_read() const {
-#ifdef __ARM_NEON
+#if defined(__ARM_NEON) || defined(RAUL_COPY_X86)
         const uint32_t next_read = (_read_head + 64) & _size_mask;
         __builtin_prefetch(&_buf[next_read], 0, 0);
 #endif
     }
 
-    // NEON-optimized memcpy
-    static void neon_memcpy(void* dst, const void* src, size_t size) {
-#ifdef __ARM_NEON
-        uint8_t* d = static_cast<uint8_t*>(dst);
-        const uint8_t* s = static_cast<const uint8_t*>(src);
-        // For small copies (<128 B) use the compiler’s inline memcpy
-        if (size < 128) {
-            std::memcpy(d, s, size);
-            return;
-        }
-        // Aligned bulk copy – 64-byte step, unroll ×4
-        size_t i = 0;
-        for (; i + 64 <= size; i += 64) {
-            uint8x16x4_t v = vld1q_u8_x4(s + i);   // four 16-B loads
-            vst1q_u8_x4(d + i, v);                 // four stores
-        }
-        // Remaining multiples of 16 B
-        size_t simd_end = size - ((size - i) % 16);
-        for (; i < simd_end; i += 16) {
-            vst1q_u8(d + i, vld1q_u8(s + i));
-        }
-        // Tail (<16 B)
-        for (; i < size; ++i) {
-            d[i] = s[i];
-        }
-#else
-        // Fall back to standard memcpy if NEON not available
-        std::memcpy(dst, src, size);
-#endif
+    // SIMD copy picked at construction; see RingBufferCopy.hpp
+    void copy_bytes(void* dst, const void* src, size_t size) const {
+        (size >= _nt_threshold ? _copy.streaming : _copy.regular)(dst, src, size);
     }
 
     std::atomic<uint32_t> _write_head{0}; ///< Write index into _buf
     std::atomic<uint32_t> _read_head{0};  ///< Read index into _buf
     uint32_t _size;                       ///< Size (capacity) in bytes
     uint32_t _size_mask;                  ///< Mask for fast modulo
-    std::unique_ptr<char[]> _buf;         ///< Contents
+    std::unique_ptr<char[], FreeDeleter> _buf; ///< Contents
     std::shared_ptr<spdlog::logger> _logger;
+    copy::Kernels _copy;                  ///< Copy kernels for this CPU
+    uint32_t _nt_threshold{std::numeric_limits<uint32_t>::max()}; ///< Non-temporal from this size
 };
 
 } // namespace raul
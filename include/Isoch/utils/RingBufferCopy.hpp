@@ -0,0 +1,216 @@
+// SPDX-License-Identifier: GPL-3.0-or-later
+#ifndef RAUL_RINGBUFFERCOPY_HPP
+#define RAUL_RINGBUFFERCOPY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RAUL_COPY_X86 1
+#endif
+
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+namespace raul {
+
+/**
+   Copy kernels used by RingBuffer.
+
+   On x86 the streaming (non-temporal store) kernel is picked at runtime from
+   the CPU's features: AVX2 where available, SSE2 elsewhere. Streaming only
+   pays off for transfers much larger than the cache that will not be read
+   back soon. For regular copies the libc memcpy is already dispatched to the
+   CPU and measured faster than the plain SSE2/AVX2 loops (see the
+   RingBuffer benchmark), so it stays the default; the loops are kept for
+   that comparison. Copies under 128 bytes go to the compiler's inline memcpy.
+*/
+namespace copy {
+
+using Kernel = void (*)(void* dst, const void* src, size_t size);
+
+struct Kernels {
+    Kernel      regular;
+    Kernel      streaming;   ///< non-temporal stores (same as regular where unsupported)
+    const char* name;
+};
+
+inline void scalar(void* dst, const void* src, size_t size)
+{
+    std::memcpy(dst, src, size);
+}
+
+#ifdef __ARM_NEON
+inline void neon(void* dst, const void* src, size_t size)
+{
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    // For small copies (<128 B) use the compiler’s inline memcpy
+    if (size < 128) {
+        std::memcpy(d, s, size);
+        return;
+    }
+    // Aligned bulk copy – 64-byte step, unroll ×4
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        uint8x16x4_t v = vld1q_u8_x4(s + i);   // four 16-B loads
+        vst1q_u8_x4(d + i, v);                 // four stores
+    }
+    // Remaining multiples of 16 B
+    size_t simd_end = size - ((size - i) % 16);
+    for (; i < simd_end; i += 16) {
+        vst1q_u8(d + i, vld1q_u8(s + i));
+    }
+    // Tail (<16 B)
+    for (; i < size; ++i) {
+        d[i] = s[i];
+    }
+}
+#endif
+
+#ifdef RAUL_COPY_X86
+__attribute__((target("sse2")))
+inline void sse2(void* dst, const void* src, size_t size)
+{
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    if (size < 128) {
+        std::memcpy(d, s, size);
+        return;
+    }
+    size_t i = 0;
+    for (; i + 64 <= size; i += 64) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 32));
+        const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 48));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i), a);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i + 16), b);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i + 32), c);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i + 48), e);
+    }
+    for (; i + 16 <= size; i += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(d + i),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)));
+    }
+    std::memcpy(d + i, s + i, size - i);
+}
+
+__attribute__((target("sse2")))
+inline void sse2_stream(void* dst, const void* src, size_t size)
+{
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    if (size < 128) {
+        std::memcpy(d, s, size);
+        return;
+    }
+    // Streaming stores need an aligned destination
+    size_t i = (16 - (reinterpret_cast<uintptr_t>(d) & 15)) & 15;
+    std::memcpy(d, s, i);
+    for (; i + 64 <= size; i += 64) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 16));
+        const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 32));
+        const __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + 48));
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + i), a);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + i + 16), b);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + i + 32), c);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + i + 48), e);
+    }
+    for (; i + 16 <= size; i += 16) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(d + i),
+                         _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)));
+    }
+    std::memcpy(d + i, s + i, size - i);
+    _mm_sfence(); // order the streamed data before the caller publishes the write head
+}
+
+__attribute__((target("avx2")))
+inline void avx2(void* dst, const void* src, size_t size)
+{
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    if (size < 128) {
+        std::memcpy(d, s, size);
+        return;
+    }
+    size_t i = 0;
+    for (; i + 128 <= size; i += 128) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + 64));
+        const __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + 96));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i), a);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i + 32), b);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i + 64), c);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i + 96), e);
+    }
+    for (; i + 32 <= size; i += 32) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(d + i),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)));
+    }
+    std::memcpy(d + i, s + i, size - i);
+}
+
+__attribute__((target("avx2")))
+inline void avx2_stream(void* dst, const void* src, size_t size)
+{
+    uint8_t* d = static_cast<uint8_t*>(dst);
+    const uint8_t* s = static_cast<const uint8_t*>(src);
+    if (size < 128) {
+        std::memcpy(d, s, size);
+        return;
+    }
+    size_t i = (32 - (reinterpret_cast<uintptr_t>(d) & 31)) & 31;
+    std::memcpy(d, s, i);
+    for (; i + 128 <= size; i += 128) {
+        const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+        const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + 32));
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + 64));
+        const __m256i e = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + 96));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + i), a);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + i + 32), b);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + i + 64), c);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + i + 96), e);
+    }
+    for (; i + 32 <= size; i += 32) {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(d + i),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)));
+    }
+    std::memcpy(d + i, s + i, size - i);
+    _mm_sfence();
+}
+#endif // RAUL_COPY_X86
+
+/// Best kernels for this CPU
+inline Kernels detect()
+{
+#if defined(RAUL_COPY_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {scalar, avx2_stream, "memcpy/avx2-nt"};
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return {scalar, sse2_stream, "memcpy/sse2-nt"};
+    }
+#elif defined(__ARM_NEON)
+    return {neon, neon, "neon"};
+#endif
+    return {scalar, scalar, "scalar"};
+}
+
+/// Detected once per process; call outside real-time code the first time
+inline const Kernels& kernels()
+{
+    static const Kernels k = detect();
+    return k;
+}
+
+} // namespace copy
+} // namespace raul
+
+#endif // RAUL_RINGBUFFERCOPY_HPP
@@ -1,56 +1,159 @@
 // Single-producer / single-consumer ring buffer for Core Audio plug-in <-> daemon
 // Build with Clang 16 or newer, -std=c++20
+//
+// Segment layout (one ring per segment, all offsets cache-line aligned):
+//
+//   [ControlBlock_POD][ChunkDesc_POD x descCapacity][audio: capacityFrames x bytesPerFrame]
+//
+// The control block also carries a seqlock-protected bus-clock record (ClockRecord_POD) that the
+// daemon's AudioClockPLL publishes and the driver reads to produce its zero timestamps.
+//
+// Audio is stored as interleaved frames in a power-of-two frame ring, so the
+// segment is sized for the real channel count and latency target instead of
+// worst-case fixed slots. Each push() also publishes a small descriptor that
+// carries the IO-cycle timestamp and sequence number, which keeps the per-chunk
+// SPSC sequence semantics the driver and daemon already rely on.
 
 #pragma once
-#include <CoreAudio/AudioServerPlugIn.h>   // AudioTimeStamp, AudioBufferList
+#if defined(__APPLE__)
+#include <CoreAudio/AudioServerPlugIn.h>   // AudioTimeStamp
+#endif
 #include <atomic>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include "shared/ShmWakeup.hpp"
 
 // ---------- Cache-line constant (compile-time!) ----------
 constexpr std::size_t kDestructiveCL = 64;   // 64 bytes is correct on every Apple CPU since 2008
 
 // ---------- Tunables ----------
-constexpr std::size_t kMaxFramesPerChunk = 4096;
+constexpr std::size_t kMaxFramesPerChunk = 4096;                  // largest IO cycle accepted by push()
 constexpr std::size_t kMaxChannels       = 32;
 constexpr std::size_t kMaxBytesPerSample = 4;                     // 32-bit float / int
 constexpr std::size_t kMaxBytesPerFrame  = kMaxChannels * kMaxBytesPerSample;
-constexpr std::size_t kRingCapacityPow2  = 128;                   // must be power-of-two
+constexpr std::size_t kRingCapacityPow2  = 128;                   // chunk descriptors, must be power-of-two
 static_assert((kRingCapacityPow2 & (kRingCapacityPow2 - 1)) == 0,
               "kRingCapacityPow2 must be a power of two");
 
-constexpr std::size_t kAudioDataBytes = kMaxFramesPerChunk * kMaxBytesPerFrame;
-constexpr uint32_t kShmVersion = 1;
+// Default playback ring: stereo 32-bit, 8192 frames (~170 ms @ 48 kHz, ~43 ms @ 192 kHz)
+constexpr uint32_t kDefaultRingChannels       = 2;
+constexpr uint32_t kDefaultRingBytesPerSample = 4;
+constexpr uint32_t kDefaultRingFramesPow2     = 8192;
+
+// Capture (daemon -> driver) ring lives in its own segment named <playback name> + kCaptureShmSuffix.
+// Default capture ring: stereo float32, same depth as playback.
+constexpr const char* kCaptureShmSuffix = "_in";
+constexpr uint32_t kDefaultCaptureChannels       = 2;
+constexpr uint32_t kDefaultCaptureBytesPerSample = 4;
+constexpr uint32_t kDefaultCaptureFramesPow2     = 8192;
+// The receiver fills the capture ring whether or not the driver is reading it. Once more than
+// one IO buffer plus kCaptureTrimThresholdFrames is queued, the driver drops the oldest frames
+// down to one IO buffer plus kCaptureTargetFillFrames, so input latency cannot build up.
+constexpr uint32_t kCaptureTargetFillFrames    = 64;
+constexpr uint32_t kCaptureTrimThresholdFrames = 256;
+
+constexpr uint32_t kShmVersion = 4;
 
 namespace RTShmRing {
 
 // --- POD Structures for Shared Memory ---
-struct alignas(kDestructiveCL) AudioChunk_POD
+
+// Platform-neutral mirror of the AudioTimeStamp fields the daemon consumes.
+struct TimeStamp_POD
+{
+    double   sampleTime {0.0};
+    uint64_t hostTime   {0};    // mach_absolute_time ticks, on both rings
+    double   rateScalar {0.0};
+    uint32_t flags      {0};
+    uint32_t reserved   {0};
+};
+
+// Device sample time <-> host time mapping published by the daemon. Written by one thread under
+// a seqlock; never read or written directly, only through PublishClock() / ReadClock().
+struct alignas(kDestructiveCL) ClockRecord_POD
 {
-    AudioTimeStamp timeStamp   {};
-    uint32_t       frameCount  {0};
-    uint32_t       dataBytes   {0};
-    uint64_t       sequence    {0};
-    std::byte      audio[kAudioDataBytes] {};
+    uint32_t seq                {0};    // odd while an update is in progress
+    uint32_t pad                {0};
+    uint64_t seed               {0};    // changes on every clock discontinuity; 0 = nothing published
+    double   anchorSampleTime   {0.0};  // device sample time at the anchor
+    uint64_t anchorHostTime     {0};    // host time (mach_absolute_time ticks) at the anchor
+    double   hostTicksPerSample {0.0};  // current slope, drift included
+    double   rateScalar         {0.0};  // device rate / nominal rate as estimated by the PLL
+    double   sampleRate         {0.0};  // nominal rate
+};
+
+struct alignas(kDestructiveCL) ChunkDesc_POD
+{
+    TimeStamp_POD timeStamp  {};
+    uint64_t      startFrame {0};   // absolute frame index of the first frame
+    uint32_t      frameCount {0};
+    uint32_t      dataBytes  {0};
+    uint64_t      sequence   {0};
 };
 
 struct alignas(kDestructiveCL) ControlBlock_POD
 {
-    uint32_t abiVersion {0};
-    uint32_t capacity   {0};
-    uint64_t writeIndex {0};
-    char     pad0[kDestructiveCL - sizeof(uint32_t)*2 - sizeof(uint64_t)];
-    uint64_t readIndex  {0};
-    char     pad1[kDestructiveCL - sizeof(uint64_t)];
+    // --- geometry, written once by the creator ---
+    uint32_t abiVersion     {0};
+    uint32_t capacity       {0};    // chunk descriptors (power of two)
+    uint32_t capacityFrames {0};    // audio frames (power of two)
+    uint32_t bytesPerFrame  {0};
+    uint32_t channels       {0};
+    uint32_t bytesPerSample {0};
+    uint64_t descOffset     {0};    // from start of segment
+    uint64_t audioOffset    {0};    // from start of segment
+    uint64_t segmentBytes   {0};
+    char     pad0[kDestructiveCL - sizeof(uint32_t)*6 - sizeof(uint64_t)*3];
+    // --- producer line ---
+    uint64_t writeIndex      {0};   // chunks published
+    uint64_t frameWriteIndex {0};   // frames published
+    uint32_t wakeSeq         {0};   // bumped by the producer before waking a parked reader (futex word)
+    char     pad1[kDestructiveCL - sizeof(uint64_t)*2 - sizeof(uint32_t)];
+    // --- consumer line ---
+    uint64_t readIndex       {0};   // chunks consumed
+    uint64_t frameReadIndex  {0};   // frames consumed
+    uint32_t readerParked    {0};   // 1 while the reader is (about to be) blocked on wakeSeq
+    char     pad2[kDestructiveCL - sizeof(uint64_t)*2 - sizeof(uint32_t)];
     uint32_t overrunCount  {0};
     uint32_t underrunCount {0};
+    // --- bus clock line (daemon writes, driver reads) ---
+    ClockRecord_POD clock {};
 };
+static_assert(sizeof(ControlBlock_POD) == 5 * kDestructiveCL, "ControlBlock_POD layout changed");
 
-struct alignas(kDestructiveCL) SharedRingBuffer_POD
+// View of a mapped segment; trivially copyable, never owns the mapping.
+struct RingView
 {
-    ControlBlock_POD control;
-    AudioChunk_POD   ring[kRingCapacityPow2];
+    ControlBlock_POD* control = nullptr;
+    ChunkDesc_POD*    desc    = nullptr;
+    std::byte*        audio   = nullptr;
+
+    explicit operator bool() const noexcept { return control && desc && audio; }
+};
+
+// Plain value copy of a ClockRecord_POD.
+struct ClockSnapshot
+{
+    uint64_t seed               {0};
+    double   anchorSampleTime   {0.0};
+    uint64_t anchorHostTime     {0};
+    double   hostTicksPerSample {0.0};
+    double   rateScalar         {0.0};
+    double   sampleRate         {0.0};
+
+    bool valid() const noexcept { return seed != 0 && hostTicksPerSample > 0.0; }
+};
+
+// What the consumer gets back for each popped chunk (audio is copied separately).
+struct ChunkInfo
+{
+    TimeStamp_POD timeStamp  {};
+    uint64_t      startFrame {0};
+    uint64_t      sequence   {0};
+    uint32_t      frameCount {0};
+    uint32_t      dataBytes  {0};
 };
 
 // --- Helper Functions for Atomic Access (Proxies) ---
@@ -60,8 +163,20 @@ inline std::atomic<uint64_t>& WriteIndexProxy(ControlBlock_POD& cb) noexcept {
 inline std::atomic<uint64_t>& ReadIndexProxy(ControlBlock_POD& cb) noexcept {
     return *reinterpret_cast<std::atomic<uint64_t>*>(&cb.readIndex);
 }
-inline std::atomic<uint64_t>& SequenceProxy(AudioChunk_POD& chunk) noexcept {
-    return *reinterpret_cast<std::atomic<uint64_t>*>(&chunk.sequence);
+inline std::atomic<uint64_t>& FrameWriteIndexProxy(ControlBlock_POD& cb) noexcept {
+    return *reinterpret_cast<std::atomic<uint64_t>*>(&cb.frameWriteIndex);
+}
+inline std::atomic<uint64_t>& FrameReadIndexProxy(ControlBlock_POD& cb) noexcept {
+    return *reinterpret_cast<std::atomic<uint64_t>*>(&cb.frameReadIndex);
+}
+inline std::atomic<uint64_t>& SequenceProxy(ChunkDesc_POD& desc) noexcept {
+    return *reinterpret_cast<std::atomic<uint64_t>*>(&desc.sequence);
+}
+inline std::atomic<uint32_t>& WakeSeqProxy(ControlBlock_POD& cb) noexcept {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(&cb.wakeSeq);
+}
+inline std::atomic<uint32_t>& ReaderParkedProxy(ControlBlock_POD& cb) noexcept {
+    return *reinterpret_cast<std::atomic<uint32_t>*>(&cb.readerParked);
 }
 inline std::atomic<uint32_t>& OverrunCountProxy(ControlBlock_POD& cb) noexcept {
     return *reinterpret_cast<std::atomic<uint32_t>*>(&cb.overrunCount);
@@ -70,54 +185,414 @@ inline std::atomic<uint32_t>& UnderrunCountProxy(ControlBlock_POD& cb) noexcept
     return *reinterpret_cast<std::atomic<uint32_t>*>(&cb.underrunCount);
 }
 
-// --- Modified push/pop using POD types and proxies ---
-inline bool push(ControlBlock_POD&       cb,
-                 AudioChunk_POD*         ring,
-                 const AudioBufferList*  src,
-                 const AudioTimeStamp&   ts,
-                 uint32_t                frames,
-                 uint32_t                bytesPerFrame) noexcept
-{
-    if (!src || !ring || frames == 0) return false;
-    if (frames > kMaxFramesPerChunk)  return false;
-    const uint64_t rd = ReadIndexProxy(cb).load(std::memory_order_acquire);
-    const uint64_t wr = WriteIndexProxy(cb).load(std::memory_order_relaxed);
-    if (wr - rd >= cb.capacity)       return false;
-    const uint64_t slot = wr & (cb.capacity - 1);
-    AudioChunk_POD& c   = ring[slot];
-    const uint32_t totalBytes = frames * bytesPerFrame;
-    if (totalBytes > kAudioDataBytes) return false;
-    c.timeStamp  = ts;
-    c.frameCount = frames;
-    c.dataBytes  = totalBytes;
-    std::byte* dst = c.audio;
-    for (UInt32 i = 0; i < src->mNumberBuffers; ++i) {
-        const AudioBuffer& b = src->mBuffers[i];
-        std::memcpy(dst, b.mData, b.mDataByteSize);
-        dst += b.mDataByteSize;
+// --- Layout helpers ---
+constexpr bool IsPow2(uint64_t v) noexcept { return v != 0 && (v & (v - 1)) == 0; }
+
+constexpr std::size_t AlignUp(std::size_t v, std::size_t a) noexcept { return (v + a - 1) & ~(a - 1); }
+
+constexpr std::size_t DescOffset() noexcept { return AlignUp(sizeof(ControlBlock_POD), kDestructiveCL); }
+
+constexpr std::size_t AudioOffset(uint32_t descCapacity) noexcept {
+    return AlignUp(DescOffset() + std::size_t(descCapacity) * sizeof(ChunkDesc_POD), kDestructiveCL);
+}
+
+// Bytes needed for a ring of the given geometry; 0 if the geometry is invalid.
+constexpr std::size_t SegmentBytes(uint32_t capacityFrames,
+                                   uint32_t channels,
+                                   uint32_t bytesPerSample,
+                                   uint32_t descCapacity = kRingCapacityPow2) noexcept
+{
+    if (!IsPow2(capacityFrames) || !IsPow2(descCapacity)) return 0;
+    if (channels == 0 || channels > kMaxChannels) return 0;
+    if (bytesPerSample == 0 || bytesPerSample > kMaxBytesPerSample) return 0;
+    const std::size_t audioBytes = std::size_t(capacityFrames) * channels * bytesPerSample;
+    return AlignUp(AudioOffset(descCapacity) + audioBytes, kDestructiveCL);
+}
+
+// Creator side: zero the region and write the header. Returns an empty view on bad geometry.
+inline RingView InitRing(void* base,
+                         std::size_t mappedBytes,
+                         uint32_t capacityFrames,
+                         uint32_t channels,
+                         uint32_t bytesPerSample,
+                         uint32_t descCapacity = kRingCapacityPow2) noexcept
+{
+    const std::size_t need = SegmentBytes(capacityFrames, channels, bytesPerSample, descCapacity);
+    if (!base || need == 0 || mappedBytes < need) return {};
+    std::memset(base, 0, need);
+    auto* cb           = static_cast<ControlBlock_POD*>(base);
+    cb->capacity       = descCapacity;
+    cb->capacityFrames = capacityFrames;
+    cb->channels       = channels;
+    cb->bytesPerSample = bytesPerSample;
+    cb->bytesPerFrame  = channels * bytesPerSample;
+    cb->descOffset     = DescOffset();
+    cb->audioOffset    = AudioOffset(descCapacity);
+    cb->segmentBytes   = need;
+    std::atomic_thread_fence(std::memory_order_release);
+    std::atomic_ref<uint32_t>(cb->abiVersion).store(kShmVersion, std::memory_order_release);
+    auto* bytes = static_cast<std::byte*>(base);
+    return { cb, reinterpret_cast<ChunkDesc_POD*>(bytes + cb->descOffset), bytes + cb->audioOffset };
+}
+
+// Attacher side: validate the header against the mapping. Returns an empty view on mismatch.
+inline RingView AttachRing(void* base, std::size_t mappedBytes) noexcept
+{
+    if (!base || mappedBytes < sizeof(ControlBlock_POD)) return {};
+    auto* cb = static_cast<ControlBlock_POD*>(base);
+    if (std::atomic_ref<uint32_t>(cb->abiVersion).load(std::memory_order_acquire) != kShmVersion) return {};
+    const std::size_t need = SegmentBytes(cb->capacityFrames, cb->channels, cb->bytesPerSample, cb->capacity);
+    if (need == 0 || need > mappedBytes || cb->segmentBytes != need) return {};
+    if (cb->bytesPerFrame != cb->channels * cb->bytesPerSample) return {};
+    if (cb->descOffset != DescOffset() || cb->audioOffset != AudioOffset(cb->capacity)) return {};
+    auto* bytes = static_cast<std::byte*>(base);
+    return { cb, reinterpret_cast<ChunkDesc_POD*>(bytes + cb->descOffset), bytes + cb->audioOffset };
+}
+
+// --- Frame copies with wrap-around ---
+inline void CopyIntoRing(const RingView& r, uint64_t frameIndex, const std::byte* src, uint32_t frames) noexcept
+{
+    const ControlBlock_POD& cb = *r.control;
+    const uint32_t first  = uint32_t(frameIndex & (cb.capacityFrames - 1));
+    const uint32_t part1  = frames < cb.capacityFrames - first ? frames : cb.capacityFrames - first;
+    std::memcpy(r.audio + std::size_t(first) * cb.bytesPerFrame, src, std::size_t(part1) * cb.bytesPerFrame);
+    if (part1 < frames) {
+        std::memcpy(r.audio, src + std::size_t(part1) * cb.bytesPerFrame, std::size_t(frames - part1) * cb.bytesPerFrame);
     }
+}
+
+inline void CopyFromRing(const RingView& r, uint64_t frameIndex, std::byte* dst, uint32_t frames) noexcept
+{
+    const ControlBlock_POD& cb = *r.control;
+    const uint32_t first  = uint32_t(frameIndex & (cb.capacityFrames - 1));
+    const uint32_t part1  = frames < cb.capacityFrames - first ? frames : cb.capacityFrames - first;
+    std::memcpy(dst, r.audio + std::size_t(first) * cb.bytesPerFrame, std::size_t(part1) * cb.bytesPerFrame);
+    if (part1 < frames) {
+        std::memcpy(dst + std::size_t(part1) * cb.bytesPerFrame, r.audio, std::size_t(frames - part1) * cb.bytesPerFrame);
+    }
+}
+
+// --- push/pop ---
+
+// Writable counterpart of FrameSpans (defined below) for producers that render in place.
+struct WritableFrameSpans
+{
+    std::byte* first        = nullptr;
+    uint32_t   firstFrames  = 0;
+    std::byte* second       = nullptr;
+    uint32_t   secondFrames = 0;
+
+    uint32_t frames() const noexcept { return firstFrames + secondFrames; }
+};
+
+// Producer: reserve room for `frames` frames plus one descriptor. Returns empty spans (and the
+// caller counts an overrun) if either ring is full. Nothing is visible to the consumer until
+// CommitFrames(); a reservation may simply be abandoned.
+inline WritableFrameSpans ReserveFrames(const RingView& r, uint32_t frames) noexcept
+{
+    WritableFrameSpans out;
+    if (!r || frames == 0 || frames > kMaxFramesPerChunk) return out;
+    ControlBlock_POD& cb = *r.control;
+    if (frames > cb.capacityFrames) return out;
+
+    const uint64_t rd  = ReadIndexProxy(cb).load(std::memory_order_acquire);
+    const uint64_t wr  = WriteIndexProxy(cb).load(std::memory_order_relaxed);
+    if (wr - rd >= cb.capacity) return out;
+    const uint64_t frd = FrameReadIndexProxy(cb).load(std::memory_order_acquire);
+    const uint64_t fwr = FrameWriteIndexProxy(cb).load(std::memory_order_relaxed);
+    if (fwr - frd + frames > cb.capacityFrames) return out;
+
+    const uint32_t first = uint32_t(fwr & (cb.capacityFrames - 1));
+    const uint32_t part1 = frames < cb.capacityFrames - first ? frames : cb.capacityFrames - first;
+    out.first       = r.audio + std::size_t(first) * cb.bytesPerFrame;
+    out.firstFrames = part1;
+    if (part1 < frames) {
+        out.second       = r.audio;
+        out.secondFrames = frames - part1;
+    }
+    return out;
+}
+
+// Producer: publish `frames` frames written into the last reservation as one chunk.
+inline void CommitFrames(const RingView& r, uint32_t frames, const TimeStamp_POD& ts) noexcept
+{
+    ControlBlock_POD& cb = *r.control;
+    const uint64_t wr  = WriteIndexProxy(cb).load(std::memory_order_relaxed);
+    const uint64_t fwr = FrameWriteIndexProxy(cb).load(std::memory_order_relaxed);
+
+    ChunkDesc_POD& d = r.desc[wr & (cb.capacity - 1)];
+    d.timeStamp  = ts;
+    d.startFrame = fwr;
+    d.frameCount = frames;
+    d.dataBytes  = frames * cb.bytesPerFrame;
     std::atomic_thread_fence(std::memory_order_release);
-    SequenceProxy(c).store(wr + 1, std::memory_order_relaxed);
+    SequenceProxy(d).store(wr + 1, std::memory_order_relaxed);
+    FrameWriteIndexProxy(cb).store(fwr + frames, std::memory_order_release);
     WriteIndexProxy(cb).store(wr + 1, std::memory_order_release);
+}
+
+// Producer: copy `frames` interleaved frames (bytesPerFrame as in the header) and publish one chunk.
+// Fails (and the caller counts an overrun) if either the frame ring or the descriptor ring is full.
+inline bool push(const RingView&      r,
+                 const void*          interleaved,
+                 uint32_t             frames,
+                 const TimeStamp_POD& ts) noexcept
+{
+    if (!interleaved) return false;
+    const WritableFrameSpans spans = ReserveFrames(r, frames);
+    if (spans.frames() != frames || frames == 0) return false;
+    CopyIntoRing(r, FrameWriteIndexProxy(*r.control).load(std::memory_order_relaxed),
+                 static_cast<const std::byte*>(interleaved), frames);
+    CommitFrames(r, frames, ts);
     return true;
 }
 
-inline bool pop(ControlBlock_POD& cb,
-                AudioChunk_POD*   ring,
-                AudioChunk_POD&   out) noexcept
+#if defined(__APPLE__)
+inline TimeStamp_POD ToPOD(const AudioTimeStamp& ts) noexcept
+{
+    TimeStamp_POD out;
+    out.sampleTime = ts.mSampleTime;
+    out.hostTime   = ts.mHostTime;
+    out.rateScalar = ts.mRateScalar;
+    out.flags      = ts.mFlags;
+    return out;
+}
+
+inline bool push(const RingView&       r,
+                 const void*           interleaved,
+                 uint32_t              frames,
+                 const AudioTimeStamp& ts) noexcept
 {
+    return push(r, interleaved, frames, ToPOD(ts));
+}
+#endif
+
+// Consumer: copy the next chunk's frames into `dst` (room for dstFrames frames) and retire it.
+// Copies only frameCount * bytesPerFrame bytes. Frames beyond dstFrames are dropped.
+inline bool pop(const RingView& r,
+                ChunkInfo&      out,
+                void*           dst,
+                uint32_t        dstFrames) noexcept
+{
+    if (!r || !dst) return false;
+    ControlBlock_POD& cb = *r.control;
     const uint64_t wr = WriteIndexProxy(cb).load(std::memory_order_acquire);
     const uint64_t rd = ReadIndexProxy(cb).load(std::memory_order_relaxed);
     if (rd == wr) return false;
-    const uint64_t slot = rd & (cb.capacity - 1);
-    AudioChunk_POD& c   = ring[slot];
+    ChunkDesc_POD& d = r.desc[rd & (cb.capacity - 1)];
     const uint64_t expectedSequence = rd + 1;
-    if (SequenceProxy(c).load(std::memory_order_acquire) != expectedSequence) {
+    if (SequenceProxy(d).load(std::memory_order_acquire) != expectedSequence) {
          return false;
     }
-    std::memcpy(&out, &c, sizeof(AudioChunk_POD));
+    out.timeStamp  = d.timeStamp;
+    out.startFrame = d.startFrame;
+    out.sequence   = d.sequence;
+    out.frameCount = d.frameCount < dstFrames ? d.frameCount : dstFrames;
+    out.dataBytes  = out.frameCount * cb.bytesPerFrame;
+    CopyFromRing(r, d.startFrame, static_cast<std::byte*>(dst), out.frameCount);
+    FrameReadIndexProxy(cb).store(d.startFrame + d.frameCount, std::memory_order_release);
     ReadIndexProxy(cb).store(rd + 1, std::memory_order_release);
     return true;
 }
 
-} // namespace RTShmRing
\ No newline at end of file
+// --- Frame-granular consumer (zero-copy) ---
+//
+// Alternative to pop() for consumers that read the frame area in place, e.g. a packet provider
+// that encodes straight from shared memory into DMA buffers. A ring must be drained either with
+// pop() or with PeekFrames()/ConsumeFrames(), never both.
+
+// Up to two contiguous runs of readable frames (the second is non-empty only across the wrap).
+struct FrameSpans
+{
+    const std::byte* first        = nullptr;
+    uint32_t         firstFrames  = 0;
+    const std::byte* second       = nullptr;
+    uint32_t         secondFrames = 0;
+
+    uint32_t frames() const noexcept { return firstFrames + secondFrames; }
+};
+
+inline uint64_t AvailableFrames(const RingView& r) noexcept
+{
+    ControlBlock_POD& cb = *r.control;
+    return FrameWriteIndexProxy(cb).load(std::memory_order_acquire) -
+           FrameReadIndexProxy(cb).load(std::memory_order_relaxed);
+}
+
+// Returns spans for at most maxFrames frames starting at the read position. Nothing is retired
+// until ConsumeFrames(); the spans stay valid until then.
+inline FrameSpans PeekFrames(const RingView& r, uint32_t maxFrames) noexcept
+{
+    FrameSpans out;
+    if (!r) return out;
+    ControlBlock_POD& cb = *r.control;
+    const uint64_t avail = AvailableFrames(r);
+    const uint32_t n     = avail < maxFrames ? uint32_t(avail) : maxFrames;
+    if (n == 0) return out;
+    const uint64_t frd   = FrameReadIndexProxy(cb).load(std::memory_order_relaxed);
+    const uint32_t first = uint32_t(frd & (cb.capacityFrames - 1));
+    const uint32_t part1 = n < cb.capacityFrames - first ? n : cb.capacityFrames - first;
+    out.first       = r.audio + std::size_t(first) * cb.bytesPerFrame;
+    out.firstFrames = part1;
+    if (part1 < n) {
+        out.second       = r.audio;
+        out.secondFrames = n - part1;
+    }
+    return out;
+}
+
+// Retire `frames` frames (<= AvailableFrames) plus every chunk descriptor they fully cover, so
+// the producer regains both frame and descriptor space.
+inline void ConsumeFrames(const RingView& r, uint32_t frames) noexcept
+{
+    if (!r || frames == 0) return;
+    ControlBlock_POD& cb = *r.control;
+    const uint64_t frd = FrameReadIndexProxy(cb).load(std::memory_order_relaxed) + frames;
+    const uint64_t wr  = WriteIndexProxy(cb).load(std::memory_order_acquire);
+    uint64_t rd        = ReadIndexProxy(cb).load(std::memory_order_relaxed);
+    while (rd != wr) {
+        const ChunkDesc_POD& d = r.desc[rd & (cb.capacity - 1)];
+        if (d.startFrame + d.frameCount > frd) break;
+        ++rd;
+    }
+    FrameReadIndexProxy(cb).store(frd, std::memory_order_release);
+    ReadIndexProxy(cb).store(rd, std::memory_order_release);
+}
+
+// Retire all but the newest keepFrames frames, e.g. a backlog queued while nobody was reading.
+// Consumer-side, like ConsumeFrames(). Returns the frames dropped.
+inline uint64_t DropOldestFrames(const RingView& r, uint64_t keepFrames) noexcept
+{
+    if (!r) return 0;
+    const uint64_t avail = AvailableFrames(r);
+    if (avail <= keepFrames) return 0;
+    ConsumeFrames(r, uint32_t(avail - keepFrames));   // avail never exceeds capacityFrames
+    return avail - keepFrames;
+}
+
+// Capture reader, before reading one IO buffer of ioFrames: enforce the latency bound described
+// at kCaptureTrimThresholdFrames. Returns the frames dropped (0 almost always).
+inline uint64_t TrimCaptureBacklog(const RingView& r, uint32_t ioFrames) noexcept
+{
+    if (!r || AvailableFrames(r) <= uint64_t(ioFrames) + kCaptureTrimThresholdFrames) return 0;
+    return DropOldestFrames(r, uint64_t(ioFrames) + kCaptureTargetFillFrames);
+}
+
+// --- Event-driven wakeups ---
+//
+// The reader parks on wakeSeq only after publishing readerParked and re-checking that the ring is
+// empty; the writer checks readerParked only after publishing writeIndex. With a full fence on both
+// sides at least one of them sees the other, so no wakeup is lost. While the reader is busy draining
+// the ring readerParked stays 0 and the producer never leaves user space.
+
+// Producer: call after a successful push(). Issues a wake syscall only if the reader is parked,
+// i.e. on the empty -> non-empty transition.
+inline void SignalReader(const RingView& r) noexcept
+{
+    if (!r) return;
+    ControlBlock_POD& cb = *r.control;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ReaderParkedProxy(cb).load(std::memory_order_relaxed) != 0) {
+        WakeSeqProxy(cb).fetch_add(1, std::memory_order_release);
+        ShmWake(&cb.wakeSeq);
+    }
+}
+
+// Unconditional wake, e.g. to let the reader observe a shutdown request.
+inline void WakeReader(const RingView& r) noexcept
+{
+    if (!r) return;
+    WakeSeqProxy(*r.control).fetch_add(1, std::memory_order_release);
+    ShmWake(&r.control->wakeSeq);
+}
+
+inline bool HasData(const RingView& r) noexcept
+{
+    ControlBlock_POD& cb = *r.control;
+    return WriteIndexProxy(cb).load(std::memory_order_acquire) != ReadIndexProxy(cb).load(std::memory_order_relaxed);
+}
+
+// Consumer: block until the ring is non-empty, a wake arrives, or timeoutUs elapses.
+// Returns true if data is available.
+inline bool WaitForData(const RingView& r, uint32_t timeoutUs) noexcept
+{
+    if (!r) return false;
+    ControlBlock_POD& cb = *r.control;
+    if (HasData(r)) return true;
+    const uint32_t seq = WakeSeqProxy(cb).load(std::memory_order_acquire);
+    ReaderParkedProxy(cb).store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!HasData(r)) {
+        ShmWait(&cb.wakeSeq, seq, timeoutUs);
+    }
+    ReaderParkedProxy(cb).store(0, std::memory_order_relaxed);
+    return HasData(r);
+}
+
+// --- Bus clock (seqlock) ---
+//
+// Single writer: bump seq to odd, store the fields, bump seq to even. Readers retry while seq is odd
+// or changed under them. Every field goes through atomic_ref so a torn read is a retry, not a data
+// race, and the reader never blocks the writer.
+
+// Writer (daemon): publish a new mapping. Pass seed 0 to retract the clock.
+inline void PublishClock(ControlBlock_POD& cb, const ClockSnapshot& s) noexcept
+{
+    ClockRecord_POD& c = cb.clock;
+    std::atomic_ref<uint32_t> seq(c.seq);
+    const uint32_t start = seq.load(std::memory_order_relaxed);
+    seq.store(start + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::atomic_ref<uint64_t>(c.seed).store(s.seed, std::memory_order_relaxed);
+    std::atomic_ref<double>(c.anchorSampleTime).store(s.anchorSampleTime, std::memory_order_relaxed);
+    std::atomic_ref<uint64_t>(c.anchorHostTime).store(s.anchorHostTime, std::memory_order_relaxed);
+    std::atomic_ref<double>(c.hostTicksPerSample).store(s.hostTicksPerSample, std::memory_order_relaxed);
+    std::atomic_ref<double>(c.rateScalar).store(s.rateScalar, std::memory_order_relaxed);
+    std::atomic_ref<double>(c.sampleRate).store(s.sampleRate, std::memory_order_relaxed);
+    seq.store(start + 2, std::memory_order_release);
+}
+
+// Reader (driver, real-time safe): copy a consistent record. Gives up after maxTries collisions
+// with the writer, which only happens if the writer stalls mid-update.
+inline bool ReadClock(ControlBlock_POD& cb, ClockSnapshot& out, uint32_t maxTries = 64) noexcept
+{
+    ClockRecord_POD& c = cb.clock;
+    std::atomic_ref<uint32_t> seq(c.seq);
+    for (uint32_t attempt = 0; attempt < maxTries; ++attempt) {
+        const uint32_t before = seq.load(std::memory_order_acquire);
+        if (before & 1u) continue;
+        ClockSnapshot s;
+        s.seed               = std::atomic_ref<uint64_t>(c.seed).load(std::memory_order_relaxed);
+        s.anchorSampleTime   = std::atomic_ref<double>(c.anchorSampleTime).load(std::memory_order_relaxed);
+        s.anchorHostTime     = std::atomic_ref<uint64_t>(c.anchorHostTime).load(std::memory_order_relaxed);
+        s.hostTicksPerSample = std::atomic_ref<double>(c.hostTicksPerSample).load(std::memory_order_relaxed);
+        s.rateScalar         = std::atomic_ref<double>(c.rateScalar).load(std::memory_order_relaxed);
+        s.sampleRate         = std::atomic_ref<double>(c.sampleRate).load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (seq.load(std::memory_order_relaxed) == before) {
+            out = s;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Latest point on the `period`-sample grid at or before hostNow, extrapolated along the published
+// clock. This is what the HAL asks for as the device's zero timestamp.
+inline bool ZeroTimeStampAt(const ClockSnapshot& c,
+                            uint64_t             hostNow,
+                            uint32_t             period,
+                            double&              outSampleTime,
+                            uint64_t&            outHostTime) noexcept
+{
+    if (!c.valid() || period == 0) return false;
+    const double hostDelta = double(int64_t(hostNow - c.anchorHostTime));
+    const double sampleNow = c.anchorSampleTime + hostDelta / c.hostTicksPerSample;
+    const double zero      = std::floor(sampleNow / period) * period;
+    const double hostOff   = (zero - c.anchorSampleTime) * c.hostTicksPerSample;
+    outSampleTime = zero;
+    outHostTime   = c.anchorHostTime + uint64_t(int64_t(std::llround(hostOff)));
+    return true;
+}
+
+} // namespace RTShmRing
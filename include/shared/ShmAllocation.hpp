@@ -0,0 +1,150 @@
+// Mapping helper for the real-time shared audio segments.
+//
+// MapShm() maps an already-sized POSIX shm object and gets it ready for the IO thread before the
+// first IO cycle: huge pages where the platform offers them for shared memory, every page
+// pre-faulted writable, the range mlock'ed, and residency verified with mincore(). The returned
+// ShmMapping reports what was actually achieved so callers can log it.
+//
+// Pre-faulting never changes segment contents: each page is touched with an atomic add of zero,
+// which is safe even while the peer process is already using the ring.
+
+#pragma once
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace RTShmRing {
+
+struct ShmMapOptions
+{
+    bool tryHugePages = true;   // Linux: MADV_HUGEPAGE on segments of at least one huge page
+    bool prefault     = true;   // write-touch every page now instead of on the IO thread
+    bool lock         = true;   // mlock the whole range
+};
+
+struct ShmMapping
+{
+    void*       base          = nullptr;
+    std::size_t bytes         = 0;   // mapped length
+    std::size_t pageSize      = 0;   // base page size, or huge page size if huge pages back the range
+    std::size_t hugeBytes     = 0;   // bytes backed by huge pages (Linux, from smaps)
+    std::size_t lockedBytes   = 0;   // bytes successfully mlock'ed
+    std::size_t residentBytes = 0;   // bytes resident after pre-faulting (mincore)
+    int         lockErrno     = 0;   // errno from mlock, 0 on success
+
+    explicit operator bool() const noexcept { return base != nullptr; }
+};
+
+constexpr std::size_t kHugePageBytes = 2u * 1024u * 1024u;
+
+inline std::size_t BasePageSize() noexcept
+{
+    static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+// Number of bytes in [base, base+bytes) currently resident in RAM.
+inline std::size_t ResidentBytes(void* base, std::size_t bytes) noexcept
+{
+    const std::size_t page  = BasePageSize();
+    const std::size_t pages = (bytes + page - 1) / page;
+#if defined(__APPLE__)
+    std::vector<char> vec(pages);
+#else
+    std::vector<unsigned char> vec(pages);
+#endif
+    if (::mincore(base, bytes, vec.data()) != 0) return 0;
+    std::size_t resident = 0;
+    for (auto v : vec) resident += (v & 1) ? page : 0;
+    return resident;
+}
+
+// Write-fault every page without modifying its contents.
+inline void PrefaultPages(void* base, std::size_t bytes) noexcept
+{
+    auto* p = static_cast<unsigned char*>(base);
+    const std::size_t page = BasePageSize();
+    for (std::size_t off = 0; off < bytes; off += page) {
+        __atomic_fetch_add(p + off, static_cast<unsigned char>(0), __ATOMIC_RELAXED);
+    }
+}
+
+#if defined(__linux__)
+// Bytes of the mapping starting at base that the kernel maps with PMD (huge) pages.
+inline std::size_t QueryHugeBytes(void* base) noexcept
+{
+    std::FILE* f = std::fopen("/proc/self/smaps", "r");
+    if (!f) return 0;
+    char line[512];
+    bool inRange = false;
+    std::size_t hugeKb = 0;
+    const auto want = reinterpret_cast<uintptr_t>(base);
+    while (std::fgets(line, sizeof(line), f)) {
+        unsigned long lo = 0, hi = 0;
+        if (std::sscanf(line, "%lx-%lx ", &lo, &hi) == 2) {
+            inRange = (lo == want);
+            continue;
+        }
+        std::size_t kb = 0;
+        if (inRange && (std::sscanf(line, "ShmemPmdMapped: %zu kB", &kb) == 1 ||
+                        std::sscanf(line, "FilePmdMapped: %zu kB", &kb) == 1)) {
+            hugeKb += kb;
+        }
+    }
+    std::fclose(f);
+    return hugeKb * 1024u;
+}
+#endif
+
+// Map `bytes` of fd read/write shared and prepare it for real-time use. Returns an empty mapping
+// if mmap fails; every other step is best effort and reflected in the report.
+inline ShmMapping MapShm(int fd, std::size_t bytes, const ShmMapOptions& opts = {}) noexcept
+{
+    ShmMapping m;
+    // No MAP_POPULATE: pages must be faulted after the huge-page advice to be eligible for it.
+    void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return m;
+    m.base     = p;
+    m.bytes    = bytes;
+    m.pageSize = BasePageSize();
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (opts.tryHugePages && bytes >= kHugePageBytes) {
+        (void)::madvise(p, bytes, MADV_HUGEPAGE);
+    }
+#endif
+    (void)::madvise(p, bytes, MADV_WILLNEED);
+
+    if (opts.prefault) {
+        PrefaultPages(p, bytes);
+    }
+    if (opts.lock) {
+        if (::mlock(p, bytes) == 0) {
+            m.lockedBytes = bytes;
+        } else {
+            m.lockErrno = errno;
+        }
+    }
+
+#if defined(__linux__)
+    m.hugeBytes = QueryHugeBytes(p);
+    if (m.hugeBytes > 0) m.pageSize = kHugePageBytes;
+#endif
+    m.residentBytes = ResidentBytes(p, bytes);
+    return m;
+}
+
+inline void UnmapShm(ShmMapping& m) noexcept
+{
+    if (!m.base) return;
+    if (m.lockedBytes) ::munlock(m.base, m.bytes);
+    ::munmap(m.base, m.bytes);
+    m = {};
+}
+
+} // namespace RTShmRing
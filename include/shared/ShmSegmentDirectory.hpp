@@ -0,0 +1,187 @@
+// Segment directory: several independently sized RTShmRings in one shared-memory segment.
+//
+//   [DirectoryHeader_POD: slots + entries][ring 0][ring 1]...[ring N-1]
+//
+// Each ring is a complete RTShmRing region (control block, descriptors, audio) at a cache-line
+// aligned offset, tagged with the device GUID and stream direction it carries. Rings share
+// nothing but the mapping, so a backlog on one stream never holds up another.
+//
+// Lookup by (guid, direction) goes through a small open-addressed slot table in the header and
+// ends in a RingView resolved once at attach time, so the hot path does no scanning and no
+// header validation.
+
+#pragma once
+#include "shared/SharedMemoryStructures.hpp"
+
+namespace RTShmRing {
+
+enum class StreamDirection : uint32_t {
+    Playback = 0,   // driver -> daemon
+    Capture  = 1,   // daemon -> driver
+};
+
+constexpr uint32_t kDirectoryMagic    = 0x46574144;                 // 'FWAD'
+constexpr uint32_t kDirectoryVersion  = 1;
+constexpr uint32_t kMaxDirectoryRings = 16;
+constexpr uint32_t kDirectorySlots    = 2 * kMaxDirectoryRings;     // load factor <= 1/2
+static_assert((kDirectorySlots & (kDirectorySlots - 1)) == 0, "kDirectorySlots must be a power of two");
+
+// What the creator asks for, one per ring.
+struct RingSpec
+{
+    uint64_t        guid           {0};
+    StreamDirection direction      {StreamDirection::Playback};
+    uint32_t        capacityFrames {kDefaultRingFramesPow2};
+    uint32_t        channels       {kDefaultRingChannels};
+    uint32_t        bytesPerSample {kDefaultRingBytesPerSample};
+    uint32_t        descCapacity   {kRingCapacityPow2};
+};
+
+// Written once by the creator, read-only afterwards.
+struct DirectoryEntry_POD
+{
+    uint64_t guid      {0};
+    uint32_t direction {0};
+    uint32_t reserved  {0};
+    uint64_t offset    {0};   // ring region, from start of segment
+    uint64_t bytes     {0};   // ring region size (SegmentBytes of its geometry)
+};
+
+struct alignas(kDestructiveCL) DirectoryHeader_POD
+{
+    uint32_t magic        {0};    // stored last by the creator
+    uint32_t version      {0};
+    uint32_t ringCount    {0};
+    uint32_t reserved     {0};
+    uint64_t segmentBytes {0};
+    uint8_t  slots[kDirectorySlots] {};   // entry index + 1, 0 = empty
+    DirectoryEntry_POD entries[kMaxDirectoryRings] {};
+};
+
+// Process-local view with every ring resolved.
+struct DirectoryView
+{
+    DirectoryHeader_POD* header = nullptr;
+    uint32_t             count  = 0;
+    RingView             rings[kMaxDirectoryRings] {};
+
+    explicit operator bool() const noexcept { return header != nullptr; }
+};
+
+constexpr std::size_t DirectoryHeaderBytes() noexcept { return AlignUp(sizeof(DirectoryHeader_POD), kDestructiveCL); }
+
+constexpr uint32_t DirectorySlot(uint64_t guid, StreamDirection direction) noexcept
+{
+    // splitmix64 finaliser; GUIDs of one vendor differ mostly in their low bits
+    uint64_t h = guid ^ (uint64_t(direction) << 63) ^ uint64_t(direction);
+    h ^= h >> 30; h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27; h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return uint32_t(h & (kDirectorySlots - 1));
+}
+
+// Total segment size for the given rings; 0 if any geometry is invalid or there are too many.
+constexpr std::size_t DirectorySegmentBytes(const RingSpec* specs, uint32_t count) noexcept
+{
+    if (!specs || count == 0 || count > kMaxDirectoryRings) return 0;
+    std::size_t total = DirectoryHeaderBytes();
+    for (uint32_t i = 0; i < count; ++i) {
+        const std::size_t ring = SegmentBytes(specs[i].capacityFrames, specs[i].channels,
+                                              specs[i].bytesPerSample, specs[i].descCapacity);
+        if (ring == 0) return 0;
+        total += ring;
+    }
+    return total;
+}
+
+// Index of the ring carrying (guid, direction), or -1.
+inline int FindRingIndex(const DirectoryView& dir, uint64_t guid, StreamDirection direction) noexcept
+{
+    if (!dir) return -1;
+    uint32_t slot = DirectorySlot(guid, direction);
+    for (uint32_t probe = 0; probe < kDirectorySlots; ++probe, slot = (slot + 1) & (kDirectorySlots - 1)) {
+        const uint32_t tag = dir.header->slots[slot];
+        if (tag == 0) return -1;
+        const DirectoryEntry_POD& e = dir.header->entries[tag - 1];
+        if (e.guid == guid && e.direction == uint32_t(direction)) return int(tag - 1);
+    }
+    return -1;
+}
+
+inline RingView FindRing(const DirectoryView& dir, uint64_t guid, StreamDirection direction) noexcept
+{
+    const int index = FindRingIndex(dir, guid, direction);
+    return index < 0 ? RingView{} : dir.rings[index];
+}
+
+// Creator side: lay out and initialise every ring, then publish the header. Fails on bad
+// geometry, a duplicate (guid, direction), or a mapping that is too small.
+inline DirectoryView InitDirectory(void* base, std::size_t mappedBytes, const RingSpec* specs, uint32_t count) noexcept
+{
+    DirectoryView dir;
+    const std::size_t need = DirectorySegmentBytes(specs, count);
+    if (!base || need == 0 || mappedBytes < need) return dir;
+
+    auto* bytes  = static_cast<std::byte*>(base);
+    auto* header = static_cast<DirectoryHeader_POD*>(base);
+    std::memset(base, 0, DirectoryHeaderBytes());
+
+    DirectoryView building;
+    building.header = header;
+    std::size_t offset = DirectoryHeaderBytes();
+    for (uint32_t i = 0; i < count; ++i) {
+        const RingSpec& s = specs[i];
+        if (FindRingIndex(building, s.guid, s.direction) >= 0) return dir;   // duplicate key
+        const std::size_t ringBytes = SegmentBytes(s.capacityFrames, s.channels, s.bytesPerSample, s.descCapacity);
+        const RingView ring = InitRing(bytes + offset, ringBytes, s.capacityFrames, s.channels, s.bytesPerSample, s.descCapacity);
+        if (!ring) return dir;
+
+        DirectoryEntry_POD& e = header->entries[i];
+        e.guid      = s.guid;
+        e.direction = uint32_t(s.direction);
+        e.offset    = offset;
+        e.bytes     = ringBytes;
+        uint32_t slot = DirectorySlot(s.guid, s.direction);
+        while (header->slots[slot] != 0) slot = (slot + 1) & (kDirectorySlots - 1);
+        header->slots[slot] = uint8_t(i + 1);
+
+        building.rings[i] = ring;
+        building.count    = i + 1;
+        offset += ringBytes;
+    }
+    header->ringCount    = count;
+    header->segmentBytes = need;
+    header->version      = kDirectoryVersion;
+    std::atomic_thread_fence(std::memory_order_release);
+    std::atomic_ref<uint32_t>(header->magic).store(kDirectoryMagic, std::memory_order_release);
+    return building;
+}
+
+// Attacher side: validate the header and every ring against the mapping.
+inline DirectoryView AttachDirectory(void* base, std::size_t mappedBytes) noexcept
+{
+    DirectoryView dir;
+    if (!base || mappedBytes < DirectoryHeaderBytes()) return dir;
+    auto* header = static_cast<DirectoryHeader_POD*>(base);
+    if (std::atomic_ref<uint32_t>(header->magic).load(std::memory_order_acquire) != kDirectoryMagic) return dir;
+    if (header->version != kDirectoryVersion) return dir;
+    if (header->ringCount == 0 || header->ringCount > kMaxDirectoryRings) return dir;
+    if (header->segmentBytes > mappedBytes) return dir;
+
+    auto* bytes = static_cast<std::byte*>(base);
+    for (uint32_t i = 0; i < header->ringCount; ++i) {
+        const DirectoryEntry_POD& e = header->entries[i];
+        if (e.offset < DirectoryHeaderBytes() || e.offset % kDestructiveCL != 0) return {};
+        if (e.offset + e.bytes > header->segmentBytes) return {};
+        dir.rings[i] = AttachRing(bytes + e.offset, e.bytes);
+        if (!dir.rings[i]) return {};
+    }
+    for (uint32_t slot = 0; slot < kDirectorySlots; ++slot) {
+        if (header->slots[slot] > header->ringCount) return {};
+    }
+    dir.header = header;
+    dir.count  = header->ringCount;
+    return dir;
+}
+
+} // namespace RTShmRing
@@ -0,0 +1,58 @@
+// Process-shared wait/wake on a 32-bit word living in shared memory.
+//
+// macOS: os_sync_wait_on_address (macOS 14.4+) with the SHARED flag, so the kernel keys the
+//        wait queue on the physical page rather than the per-process address.
+// Linux: futex(2) without FUTEX_PRIVATE_FLAG for the same reason.
+// Anything else falls back to a short sleep, which keeps callers correct but not event-driven.
+
+#pragma once
+#include <cstdint>
+
+#if defined(__APPLE__)
+#include <os/os_sync_wait_on_address.h>
+#include <os/clock.h>
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+namespace RTShmRing {
+
+// Block while *word == expected, for at most timeoutUs microseconds. Spurious returns are allowed;
+// callers always re-check their condition.
+inline void ShmWait(uint32_t* word, uint32_t expected, uint32_t timeoutUs) noexcept
+{
+#if defined(__APPLE__)
+    os_sync_wait_on_address_with_timeout(word, expected, sizeof(uint32_t),
+                                         OS_SYNC_WAIT_ON_ADDRESS_SHARED,
+                                         OS_CLOCK_MACH_ABSOLUTE_TIME,
+                                         static_cast<uint64_t>(timeoutUs) * 1000u);
+#elif defined(__linux__)
+    struct timespec ts;
+    ts.tv_sec  = timeoutUs / 1000000u;
+    ts.tv_nsec = static_cast<long>(timeoutUs % 1000000u) * 1000;
+    ::syscall(SYS_futex, word, FUTEX_WAIT, expected, &ts, nullptr, 0);
+#else
+    (void)word; (void)expected;
+    std::this_thread::sleep_for(std::chrono::microseconds(timeoutUs < 500 ? timeoutUs : 500));
+#endif
+}
+
+// Wake one waiter blocked in ShmWait on word (there is only ever one reader per ring).
+inline void ShmWake(uint32_t* word) noexcept
+{
+#if defined(__APPLE__)
+    os_sync_wake_by_address_any(word, sizeof(uint32_t), OS_SYNC_WAKE_BY_ADDRESS_SHARED);
+#elif defined(__linux__)
+    ::syscall(SYS_futex, word, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+#else
+    (void)word;
+#endif
+}
+
+} // namespace RTShmRing
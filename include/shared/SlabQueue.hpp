@@ -0,0 +1,175 @@
+// Fixed-capacity single-producer / single-consumer queue of byte buffers backed by one slab.
+//
+// All storage is allocated once by allocate() (outside the audio path); reserve()/commit() hand
+// the producer a slot to write into in place and pop() retires it, so steady-state operation
+// never touches the heap and copies each byte at most once. The consumer can block in
+// waitForData() on the publish counter instead of sleep-polling; the producer only issues a
+// wake when the consumer is actually parked.
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace RTShmRing {
+
+class SlabQueue
+{
+public:
+    SlabQueue() = default;
+    SlabQueue(const SlabQueue&) = delete;
+    SlabQueue& operator=(const SlabQueue&) = delete;
+
+    // Not real-time safe. slots must be a power of two; slotBytes is rounded up to a cache line.
+    bool allocate(uint32_t slots, std::size_t slotBytes)
+    {
+        if (slots == 0 || (slots & (slots - 1)) != 0 || slotBytes == 0) return false;
+        release();
+        const std::size_t stride = (slotBytes + kLine - 1) & ~(kLine - 1);
+        slab_.reset(new (std::align_val_t(kLine), std::nothrow) std::byte[std::size_t(slots) * stride]);
+        sizes_.reset(new (std::nothrow) uint32_t[slots]);
+        if (!slab_ || !sizes_) {
+            release();
+            return false;
+        }
+        slots_ = slots;
+        slotBytes_ = slotBytes;
+        stride_ = stride;
+        writeIdx_.store(0, std::memory_order_relaxed);
+        readIdx_.store(0, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Not real-time safe; neither side may be using the queue.
+    void release() noexcept
+    {
+        slab_.reset();
+        sizes_.reset();
+        slots_ = 0;
+        slotBytes_ = 0;
+        stride_ = 0;
+    }
+
+    bool allocated() const noexcept { return slots_ != 0; }
+    std::size_t slotBytes() const noexcept { return slotBytes_; }
+    uint32_t capacity() const noexcept { return slots_; }
+
+    std::size_t size() const noexcept
+    {
+        return writeIdx_.load(std::memory_order_acquire) - readIdx_.load(std::memory_order_acquire);
+    }
+
+    // --- producer ---
+
+    // Slot to write up to slotBytes() into, or nullptr if the queue is full or not allocated.
+    // Nothing is visible to the consumer until commit(); an unused reservation is simply dropped.
+    std::byte* reserve() noexcept
+    {
+        if (!slots_) return nullptr;
+        const std::size_t wr = writeIdx_.load(std::memory_order_relaxed);
+        if (wr - readIdx_.load(std::memory_order_acquire) >= slots_) return nullptr;
+        return slotAt(wr);
+    }
+
+    // Publish the last reservation holding `bytes` bytes (<= slotBytes()).
+    void commit(std::size_t bytes) noexcept
+    {
+        const std::size_t wr = writeIdx_.load(std::memory_order_relaxed);
+        sizes_[wr & (slots_ - 1)] = static_cast<uint32_t>(bytes);
+        writeIdx_.store(wr + 1, std::memory_order_release);
+        publishSeq_.fetch_add(1, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (consumerParked_.load(std::memory_order_relaxed)) {
+            publishSeq_.notify_one();
+        }
+    }
+
+    // reserve + memcpy + commit. False if full or bytes > slotBytes().
+    bool push(const void* data, std::size_t bytes) noexcept
+    {
+        if (bytes > slotBytes_) return false;
+        std::byte* dst = reserve();
+        if (!dst) return false;
+        std::memcpy(dst, data, bytes);
+        commit(bytes);
+        return true;
+    }
+
+    // --- consumer ---
+
+    // Oldest committed buffer, or false if empty. Stays valid until pop().
+    bool front(const std::byte*& data, std::size_t& bytes) const noexcept
+    {
+        const std::size_t rd = readIdx_.load(std::memory_order_relaxed);
+        if (rd == writeIdx_.load(std::memory_order_acquire)) return false;
+        data = slotAt(rd);
+        bytes = sizes_[rd & (slots_ - 1)];
+        return true;
+    }
+
+    void pop() noexcept
+    {
+        readIdx_.store(readIdx_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Retire everything committed so far, e.g. stale buffers left over from a previous run.
+    // Consumer-side only; the producer may keep running.
+    void discard() noexcept
+    {
+        readIdx_.store(writeIdx_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Block until something is committed or wake() is called. Returns true if data is available.
+    bool waitForData() noexcept
+    {
+        const uint32_t seq = publishSeq_.load(std::memory_order_acquire);
+        if (!empty()) return true;
+        consumerParked_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (empty()) {
+            publishSeq_.wait(seq, std::memory_order_acquire);
+        }
+        consumerParked_.store(false, std::memory_order_relaxed);
+        return !empty();
+    }
+
+    // Release a consumer blocked in waitForData(), e.g. for shutdown.
+    void wake() noexcept
+    {
+        publishSeq_.fetch_add(1, std::memory_order_release);
+        publishSeq_.notify_one();
+    }
+
+private:
+    static constexpr std::size_t kLine = 64;
+
+    struct AlignedDelete {
+        void operator()(std::byte* p) const noexcept { ::operator delete[](p, std::align_val_t(kLine)); }
+    };
+
+    bool empty() const noexcept
+    {
+        return readIdx_.load(std::memory_order_relaxed) == writeIdx_.load(std::memory_order_acquire);
+    }
+
+    std::byte* slotAt(std::size_t index) const noexcept
+    {
+        return slab_.get() + (index & (slots_ - 1)) * stride_;
+    }
+
+    std::unique_ptr<std::byte[], AlignedDelete> slab_;
+    std::unique_ptr<uint32_t[]> sizes_;
+    uint32_t slots_ = 0;
+    std::size_t slotBytes_ = 0;
+    std::size_t stride_ = 0;
+
+    alignas(kLine) std::atomic<std::size_t> writeIdx_{0};
+    alignas(kLine) std::atomic<std::size_t> readIdx_{0};
+    alignas(kLine) std::atomic<uint32_t> publishSeq_{0};
+    std::atomic<bool> consumerParked_{false};
+};
+
+} // namespace RTShmRing
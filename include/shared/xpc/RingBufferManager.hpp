@@ -1,5 +1,6 @@
 #pragma once
 #include <shared/SharedMemoryStructures.hpp>
+#include <shared/ShmSegmentDirectory.hpp>
 #include <atomic>
 #include <thread>
 
@@ -10,9 +11,29 @@ public:
 
     // Accepts isCreator: true if this process created the SHM, false if attaching
     bool map(int shmFd, bool isCreator);
+    // Capture (daemon -> driver) segment; no reader thread, the AMDTP receiver is the producer
+    bool mapCapture(int shmFd, bool isCreator);
     void unmap();                 // daemon shutdown
     bool isMapped() const { return shm_ != nullptr; }
 
+    // Ring view for a zero-copy consumer (TransmitterConfig::sharedMemoryRing, passed in through
+    // AudioDeviceStream::createTransmitterForDevicePlug). Only valid in this process.
+    RTShmRing::RingView ring() const { return ring_; }
+    // While set, readerLoop stops draining the ring so the direct consumer owns it. Whoever creates
+    // a transmitter on ring() sets this first; until then the ring keeps its single reader here.
+    void setDirectConsumer(bool direct) { directConsumer_.store(direct, std::memory_order_release); }
+    // Ring view for ReceiverConfig::captureRing (AudioDeviceStream::createReceiverForDevicePlug);
+    // empty until mapCapture() succeeds. Only valid in this process.
+    RTShmRing::RingView captureRing() const { return captureRing_; }
+
+    // Multi-stream segment: one ring per (device GUID, direction). No reader thread; each ring is
+    // drained by its own stream (ShmPacketProvider / AmdtpReceiver), so streams never block each other.
+    bool mapDirectory(int shmFd, bool isCreator, const RTShmRing::RingSpec* specs, uint32_t count);
+    // O(1); empty view if the directory is not mapped or has no such ring.
+    RTShmRing::RingView directoryRing(uint64_t guid, RTShmRing::StreamDirection direction) const {
+        return RTShmRing::FindRing(directory_, guid, direction);
+    }
+
 private:
     RingBufferManager() = default;
     ~RingBufferManager();
@@ -20,10 +41,18 @@ private:
     void readerLoop();            // background thread
 
     // --- SHM pointers ---
-    RTShmRing::SharedRingBuffer_POD *shm_ = nullptr;
+    void                        *shm_ = nullptr;
     size_t                       shmSize_ = 0;
+    RTShmRing::RingView          ring_;
+    void                        *captureShm_ = nullptr;
+    size_t                       captureShmSize_ = 0;
+    RTShmRing::RingView          captureRing_;
+    void                        *directoryShm_ = nullptr;
+    size_t                       directoryShmSize_ = 0;
+    RTShmRing::DirectoryView     directory_;
 
     // --- thread control ---
     std::atomic<bool>            running_{false};
+    std::atomic<bool>            directConsumer_{false};
     std::thread                  reader_;
 };
@@ -1,36 +1,65 @@
 #pragma once
 #include <shared/SharedMemoryStructures.hpp>
+#include <shared/SlabQueue.hpp>
 #include "Isoch/core/AmdtpTransmitter.hpp"
+#include "Isoch/core/VarispeedResampler.hpp"
 #include <atomic>
-#include <condition_variable>
-#include <mutex>
+#include <memory>
 #include <thread>
-#include <array>
-#include <vector>
 
 class ShmIsochBridge
 {
 public:
     static ShmIsochBridge& instance();
-    // Pass the packet‐provider; we will call pushAudioData on it directly
-    void start(FWA::Isoch::ITransmitPacketProvider* provider);
+    // Largest chunk a slot holds: one full IO cycle of the default ring, interleaved 32-bit samples
+    static constexpr size_t kMaxChunkBytes = kMaxFramesPerChunk * kDefaultRingChannels * kDefaultRingBytesPerSample;
+
+    // Pass the packet‐provider; we will call pushAudioData on it directly.
+    // The resampler is allocated here. Chunks queued while the bridge was stopped are dropped.
+    void start(FWA::Isoch::ITransmitPacketProvider* provider, uint32_t channels = kDefaultRingChannels);
     void stop();
-    void enqueue(const RTShmRing::AudioChunk_POD& chunk);          // called from RingBufferManager
+
+    // Ring whose clock record carries the PLL's bus/host ratio. Chunks are resampled from the
+    // CoreAudio (host) clock to the bus clock so the provider's fill stays at its target.
+    // nullptr: no ratio, the servo still trims on fill alone.
+    void setClockSource(RTShmRing::ControlBlock_POD* control) noexcept
+    {
+        clock_.store(control, std::memory_order_release);
+    }
+
+    // Producer side (RingBufferManager reader thread): write a chunk straight into a slab slot.
+    // reserve() returns nullptr if the bridge is stopped or the queue is full; a reservation
+    // that outlives stop() is dropped by commit().
+    std::byte* reserve() noexcept
+    {
+        return running_.load(std::memory_order_acquire) ? queue_.reserve() : nullptr;
+    }
+    void commit(size_t bytes) noexcept
+    {
+        if (running_.load(std::memory_order_acquire)) queue_.commit(bytes);
+    }
+    size_t maxChunkBytes() const noexcept { return queue_.slotBytes(); }
+
+    // Copying convenience for callers that already hold the chunk elsewhere
+    void enqueue(const std::byte* audio, size_t bytes);
 
 private:
-    ShmIsochBridge() = default;
+    ShmIsochBridge();
     ~ShmIsochBridge();
 
     void worker();                                             // single producer → single consumer
 
-    struct QueueItem {
-        std::vector<std::byte> data;
-    };
+    // SPSC slab queue (power-of-two slot count), allocated once by the constructor: the ring
+    // reader can reach it as soon as the segment is mapped, so it is never reallocated
+    static constexpr uint32_t kQCap = 64;
+    RTShmRing::SlabQueue queue_;
 
-    // lock-free SPSC ring (power-of-two size)
-    static constexpr size_t kQCap = 256;
-    std::array<QueueItem, kQCap> q_;
-    std::atomic<size_t> writeIdx_{0}, readIdx_{0};
+    // Host-clock → bus-clock rate conversion, run on the worker thread
+    std::unique_ptr<FWA::Isoch::VarispeedResampler> resampler_;
+    FWA::Isoch::RateServo servo_;
+    std::unique_ptr<int32_t[]> resampled_;
+    uint32_t resampledFrames_ = 0;
+    std::atomic<RTShmRing::ControlBlock_POD*> clock_{nullptr};
 
     std::atomic<bool> running_{false};
     std::thread       thread_;
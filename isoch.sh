@@ -180,8 +180,6 @@ IGNORE_FOLDERS=("components")
 IGNORE_FILES=( 
     "AmdtTransmitStreamProcessor.cpp" 
     "AmdtTransmitStreamProcessor.hpp" 
-    "CIPHeaderHandler.cpp"
-    "CIPHeaderHandler.hpp"
     "AmdtpHelpers.cpp"
     "AmdtpHelpers.hpp")
 
@@ -82,7 +82,9 @@ std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> AudioDeviceStream:
                                                                                         unsigned int numSegments,
                                                                                         unsigned int bufferSize,
                                                                                         IOFWSpeed speed,
-                                                                                        IOFireWireLibDeviceRef interface
+                                                                                        IOFireWireLibDeviceRef interface,
+                                                                                        RTShmRing::RingView playbackRing,
+                                                                                        RTShmRing::RingView captureRing
                                                                                         )
 {
     if (!audioDevice) {
@@ -131,6 +133,8 @@ std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> AudioDeviceStream:
                 config.packetsPerGroup = stream->m_cyclesPerSegment;
                 config.packetDataSize = stream->m_bufferSize;
                 config.callbackGroupInterval = 1; // Default to callback every group
+                config.captureRing = captureRing;
+                config.clockRing = playbackRing;
                 
                 // Create a component factory for the receiver
                 auto receiver = Isoch::ReceiverFactory::createStandardReceiver(config);
@@ -172,6 +176,7 @@ std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> AudioDeviceStream:
                 txConfig.sampleRate = 44100.0; // Default sample rate
                 txConfig.numChannels = 2;      // Default stereo
                 txConfig.initialSpeed = speed;
+                txConfig.sharedMemoryRing = playbackRing;
                 
                 // Create the transmitter
                 auto transmitter = Isoch::AmdtpTransmitter::create(txConfig);
@@ -225,7 +230,9 @@ std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> AudioDeviceStream:
                                                                                                              unsigned int cyclesPerSegment,
                                                                                                              unsigned int numSegments,
                                                                                                              unsigned int cycleBufferSize,
-                                                                                                             IOFireWireLibDeviceRef interface
+                                                                                                             IOFireWireLibDeviceRef interface,
+                                                                                                             RTShmRing::RingView captureRing,
+                                                                                                             RTShmRing::RingView clockRing
                                                                                                              )
 {
     // Use the general create method with specific parameters for a receiver
@@ -242,7 +249,9 @@ std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> AudioDeviceStream:
                   numSegments,
                   cycleBufferSize,
                   kFWSpeed100MBit,  // Default speed, can be changed later
-                  interface
+                  interface,
+                  clockRing,        // The clock record lives in the playback segment
+                  captureRing
                   );
 }
 
@@ -257,7 +266,8 @@ std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> AudioDeviceStream:
                                                                                                                 unsigned int cyclesPerSegment,
                                                                                                                 unsigned int numSegments,
                                                                                                                 unsigned int transmitBufferSize,
-                                                                                                                IOFireWireLibDeviceRef interface
+                                                                                                                IOFireWireLibDeviceRef interface,
+                                                                                                                RTShmRing::RingView playbackRing
                                                                                                                 )
 {
     // Use the general create method with specific parameters for a transmitter
@@ -274,7 +284,8 @@ std::expected<std::shared_ptr<AudioDeviceStream>, IOKitError> AudioDeviceStream:
                   numSegments,
                   transmitBufferSize,
                   kFWSpeed100MBit,        // Default speed, can be changed later
-                  interface
+                  interface,
+                  playbackRing
                   );
 }
 
@@ -843,7 +854,7 @@ std::expected<void, IOKitError> AudioDeviceStream::checkIOReturn(IOReturn result
     return {};
 }
 
-raul::RingBuffer* AudioDeviceStream::getReceiverRingBuffer() const {
+Isoch::AppRingBuffer* AudioDeviceStream::getReceiverRingBuffer() const {
     // Check if the variant holds an AmdtpReceiver
     if (std::holds_alternative<std::shared_ptr<Isoch::AmdtpReceiver>>(m_streamImpl)) {
         // Get the receiver shared_ptr
@@ -463,7 +463,7 @@ void IsoStreamHandler::handleMessageImpl(uint32_t msg, uint32_t param1, uint32_t
         switch (txMsg) {
             case Isoch::TransmitterMessage::StreamStarted: m_logger->info("IsoStreamHandler: AMDTP TX Stream Started"); break;
             case Isoch::TransmitterMessage::StreamStopped: m_logger->info("IsoStreamHandler: AMDTP TX Stream Stopped"); break;
-//            case Isoch::TransmitterMessage::BufferUnderrun: m_logger->warn("IsoStreamHandler: AMDTP TX Buffer Underrun (Seg={}, Pkt={})", param1, param2); break;
+            case Isoch::TransmitterMessage::EventSummary: m_logger->warn("IsoStreamHandler: AMDTP TX {} underrun packets, {} other faults", param1, param2); break;
             case Isoch::TransmitterMessage::OverrunError: m_logger->error("IsoStreamHandler: AMDTP TX DCL Overrun error occurred"); break;
             // Add cases for other transmitter messages as needed
             case Isoch::TransmitterMessage::Error: m_logger->error("IsoStreamHandler: AMDTP TX Generic Error occurred"); break;
@@ -570,7 +570,7 @@ void IsoStreamHandler::makeThreadRealtime(std::thread& th) {
 }
 
 // Helper method to get ring buffer from AudioDeviceStream
-raul::RingBuffer* IsoStreamHandler::getInputStreamRingBuffer() {
+Isoch::AppRingBuffer* IsoStreamHandler::getInputStreamRingBuffer() {
     if (m_inputStream) {
         return m_inputStream->getReceiverRingBuffer();
     }
@@ -586,7 +586,7 @@ void IsoStreamHandler::consumerLoop() {
     pthread_setname_np("FWA_RingConsumerDiscard"); // Set thread name
 #endif
 
-    raul::RingBuffer* ringBuffer = getInputStreamRingBuffer();
+    Isoch::AppRingBuffer* ringBuffer = getInputStreamRingBuffer();
     if (!ringBuffer) {
         m_logger->error("Consumer loop: Ring buffer is null. Exiting.");
         return;
@@ -615,24 +615,16 @@ void IsoStreamHandler::consumerLoop() {
 
     // Buffer for reading from ring buffer
     Isoch::ProcessedAudioFrame frameBuffer[READ_CHUNK_FRAMES];
-    const size_t frameSize = sizeof(Isoch::ProcessedAudioFrame);
-    const size_t framesToRead = READ_CHUNK_FRAMES; // Read this many frames
+    const uint32_t framesToRead = READ_CHUNK_FRAMES; // Read up to this many frames
 
     uint64_t totalFramesProcessed = 0; // Changed name for clarity
     auto lastLogTime = std::chrono::steady_clock::now();
 
     while (m_consumerRunning) {
-        // Try to read a chunk of frames
-        size_t bytesToRead = framesToRead * frameSize;
-        size_t bytesRead = ringBuffer->read(bytesToRead, frameBuffer);
-
-        if (bytesRead > 0) {
-            if (bytesRead % frameSize != 0) {
-                m_logger->error("Consumer loop: Read partial frame data ({} bytes)! Buffer corruption?", bytesRead);
-                continue; // Skip corrupted chunk
-            }
+        // Take whatever whole frames are ready, up to one chunk
+        const size_t framesReadInChunk = ringBuffer->read_frames(frameBuffer, framesToRead);
 
-            size_t framesReadInChunk = bytesRead / frameSize;
+        if (framesReadInChunk > 0) {
             totalFramesProcessed += framesReadInChunk;
 
 #if RECORD
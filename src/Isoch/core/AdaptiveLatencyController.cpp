@@ -0,0 +1,103 @@
+#include "Isoch/core/AdaptiveLatencyController.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace FWA {
+namespace Isoch {
+
+AdaptiveLatencyController::AdaptiveLatencyController(const AdaptiveLatencyConfig& config)
+    : config_(config)
+{
+    // Fill in defaults relative to capacity and keep min <= initial <= max.
+    if (config_.minTarget == 0) config_.minTarget = std::max<uint32_t>(1, config_.capacity / 16);
+    if (config_.maxTarget == 0) config_.maxTarget = static_cast<uint32_t>((uint64_t(config_.capacity) * 7) / 8);
+    if (config_.maxTarget > config_.capacity) config_.maxTarget = config_.capacity;
+    if (config_.minTarget > config_.maxTarget) config_.minTarget = config_.maxTarget;
+    if (config_.initialTarget == 0) config_.initialTarget = config_.capacity / 2;
+    config_.initialTarget = std::clamp(config_.initialTarget, config_.minTarget, config_.maxTarget);
+    if (config_.windowObservations == 0) config_.windowObservations = 1;
+    reset();
+}
+
+void AdaptiveLatencyController::reset() noexcept {
+    target_.store(config_.initialTarget, std::memory_order_relaxed);
+    observations_ = 0;
+    windowMin_ = UINT32_MAX;
+    windowMax_ = 0;
+    windowUnderrun_ = false;
+    lastJitter_ = 0;
+    stableWindows_ = 0;
+    trimPending_ = false;
+    grows_ = 0;
+    shrinks_ = 0;
+}
+
+uint32_t AdaptiveLatencyController::clampTarget(double value) const noexcept {
+    const double clamped = std::clamp(value, double(config_.minTarget), double(config_.maxTarget));
+    return static_cast<uint32_t>(std::lround(clamped));
+}
+
+uint32_t AdaptiveLatencyController::jitterFloor(uint32_t jitter) const noexcept {
+    return clampTarget(std::ceil(config_.safetyFactor * jitter));
+}
+
+void AdaptiveLatencyController::observe(uint32_t fill) noexcept {
+    windowMin_ = std::min(windowMin_, fill);
+    windowMax_ = std::max(windowMax_, fill);
+    if (++observations_ >= config_.windowObservations) {
+        closeWindow();
+    }
+}
+
+void AdaptiveLatencyController::noteUnderrun() noexcept {
+    if (windowUnderrun_) return;
+    windowUnderrun_ = true;
+    const uint32_t current = target();
+    const uint32_t grown = std::max(clampTarget(current * config_.growFactor), jitterFloor(lastJitter_));
+    if (grown > current) {
+        target_.store(grown, std::memory_order_relaxed);
+        ++grows_;
+    }
+    stableWindows_ = 0;
+    trimPending_ = false;
+}
+
+void AdaptiveLatencyController::closeWindow() noexcept {
+    // An underrun drains the ring, so that window's excursion says nothing about steady-state jitter.
+    if (!windowUnderrun_ && windowMax_ >= windowMin_) {
+        lastJitter_ = windowMax_ - windowMin_;
+    }
+
+    const uint32_t current = target();
+    const uint32_t floor = jitterFloor(lastJitter_);
+    if (windowUnderrun_) {
+        stableWindows_ = 0;
+    } else if (current < floor) {
+        target_.store(floor, std::memory_order_relaxed);
+        ++grows_;
+        stableWindows_ = 0;
+        trimPending_ = false;
+    } else if (++stableWindows_ >= config_.stableWindowsToShrink && current > floor) {
+        const uint32_t step = std::max<uint32_t>(1, static_cast<uint32_t>((current - floor) * config_.shrinkFraction));
+        target_.store(std::max(floor, current - step), std::memory_order_relaxed);
+        ++shrinks_;
+        trimPending_ = true;
+    }
+
+    observations_ = 0;
+    windowMin_ = UINT32_MAX;
+    windowMax_ = 0;
+    windowUnderrun_ = false;
+}
+
+uint32_t AdaptiveLatencyController::trimAmount(uint32_t fill) noexcept {
+    if (!trimPending_) return 0;
+    // Leave the sawtooth of bursty producers alone; only cut what sits above it.
+    const uint32_t ceiling = target() + std::max(lastJitter_, config_.minTarget);
+    if (fill <= ceiling) return 0;
+    trimPending_ = false;
+    return fill - target();
+}
+
+} // namespace Isoch
+} // namespace FWA
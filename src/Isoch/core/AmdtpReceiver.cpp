@@ -7,7 +7,7 @@
 #include "Isoch/core/IsochPacketProcessor.hpp"
 #include "Isoch/core/IsochMonitoringManager.hpp"
 #include "Isoch/core/AudioClockPLL.hpp"     // Include the new AudioClockPLL header
-#include "Isoch/utils/RingBuffer.hpp"       // Include RingBuffer header
+#include "Isoch/utils/FrameRingBuffer.hpp"  // Frame-typed application ring
 #include <spdlog/spdlog.h>
 #include <mach/mach.h>
 #include <mach/thread_policy.h>
@@ -206,21 +206,21 @@ std::expected<void, IOKitError> AmdtpReceiver::setupComponents(IOFireWireLibNubR
 
     // --- Instantiate PLL and Ring Buffer ---
     pll_ = std::make_unique<AudioClockPLL>(logger_);
+    // Empty unless the stream was created with a clock ring; the driver then stays on the nominal rate
+    pll_->setClockPublishTarget(config_.clockRing);
 
     // Configure Ring Buffer Size (Example: ~200ms at 48kHz Stereo Float)
-    const size_t frameSize = sizeof(ProcessedAudioFrame); // float L, float R, uint64_t ts
     const size_t desiredLatencyMs = 200;
     const size_t sampleRate = 48000; // TODO: Get actual rate from config/FDF later
     const size_t framesForLatency = (sampleRate * desiredLatencyMs) / 1000;
-    // Calculate power-of-two size, ensure it's large enough for buffer + safety margin
-    const size_t ringBufferSize = framesForLatency * frameSize * 2;
-    appRingBuffer_ = std::make_unique<raul::RingBuffer>(ringBufferSize, logger_);
+    // Rounded up to a power of two frames; x2 leaves a safety margin
+    appRingBuffer_ = std::make_unique<AppRingBuffer>(static_cast<uint32_t>(framesForLatency * 2));
     if (!appRingBuffer_) {
          if (logger_) logger_->error("Failed to create application ring buffer");
          return std::unexpected(IOKitError::NoMemory);
     }
-     if (logger_) logger_->info("Application Ring Buffer created with size: {} bytes (for {} frames)",
-                              ringBufferSize, ringBufferSize / frameSize);
+     if (logger_) logger_->info("Application Ring Buffer created with {} frames ({} bytes)",
+                              appRingBuffer_->capacity(), appRingBuffer_->capacity() * AppRingBuffer::frame_bytes);
     // --- End Instantiation ---
 
     // 9. Create IsochMonitoringManager (unchanged)
@@ -457,6 +457,41 @@ void AmdtpReceiver::setGroupCompletionCallback(GroupCompletionCallback callback,
 
 // --- Implement New Handlers ---
 
+void AmdtpReceiver::writeCaptureRing(const std::vector<ProcessedSample>& samples, uint64_t presentationHostTime) {
+    const RTShmRing::RingView& ring = config_.captureRing;
+    const uint32_t channels = ring.control->channels;
+    if (ring.control->bytesPerSample != sizeof(float) || channels == 0) {
+        return;
+    }
+
+    const uint32_t frames = static_cast<uint32_t>(samples.size());
+    const RTShmRing::WritableFrameSpans spans = RTShmRing::ReserveFrames(ring, frames);
+    if (spans.frames() != frames) {
+        // Driver is not draining (or not attached); drop this packet and count it.
+        RTShmRing::OverrunCountProxy(*ring.control).fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    auto writeSpan = [channels](float* out, const ProcessedSample* in, uint32_t count) {
+        for (uint32_t f = 0; f < count; ++f) {
+            out[0] = in[f].sampleL;
+            if (channels > 1) out[1] = in[f].sampleR;
+            for (uint32_t ch = 2; ch < channels; ++ch) out[ch] = 0.0f;
+            out += channels;
+        }
+    };
+    writeSpan(reinterpret_cast<float*>(spans.first), samples.data(), spans.firstFrames);
+    if (spans.secondFrames) {
+        writeSpan(reinterpret_cast<float*>(spans.second), samples.data() + spans.firstFrames, spans.secondFrames);
+    }
+
+    RTShmRing::TimeStamp_POD ts;
+    ts.sampleTime = static_cast<double>(samples[0].absoluteSampleIndex);
+    ts.hostTime = presentationHostTime; // host ticks, 0 until the PLL has locked
+    ts.rateScalar = 1.0;
+    RTShmRing::CommitFrames(ring, frames, ts);
+}
+
 // Static handler called by IsochPacketProcessor
 void AmdtpReceiver::handleProcessedDataStatic(const std::vector<ProcessedSample>& samples,
                                              const PacketTimingInfo& timing,
@@ -482,16 +517,35 @@ void AmdtpReceiver::handleProcessedData(const std::vector<ProcessedSample>& samp
     // Update the PLL state. It will internally handle initialization check.
     pll_->update(timing, nowHostTimeAbs); // Pass absolute time
 
+    // --- Capture ring for the CoreAudio driver: written regardless of PLL state, no allocation ---
+    if (config_.captureRing && !samples.empty()) {
+        const uint64_t presentationHostTime = pll_->isInitialized() ? pll_->getPresentationHostTime(samples[0].absoluteSampleIndex) : 0;
+        writeCaptureRing(samples, presentationHostTime);
+    }
+
     // --- Write processed samples to the application ring buffer ---
     if (!samples.empty()) {
         // Only proceed if PLL is initialized and ready to provide timestamps
         if (pll_->isInitialized()) {
             if (logger_) logger_->trace("Writing {} samples to App Ring Buffer. First AbsIdx: {}", samples.size(), samples[0].absoluteSampleIndex);
 
-            ProcessedAudioFrame frame; // Reuse frame struct
+            // Frames are staged on the stack and handed to the ring in bulk, not one write per frame
+            constexpr uint32_t kBatchFrames = 64;
+            ProcessedAudioFrame batch[kBatchFrames];
+            uint32_t batched = 0;
+            bool ringFull = false;
+            auto flush = [&] {
+                const uint32_t written = appRingBuffer_->write_frames(batch, batched);
+                if (written != batched) {
+                    if (logger_) logger_->error("Application ring full, dropped {} of {} frames", batched - written, batched);
+                    ringFull = true;
+                }
+                batched = 0;
+            };
             for (const auto& sample : samples) {
                 // Calculate presentation time using the PLL
                 // This now happens *inside* the loop for potentially better accuracy per frame
+                ProcessedAudioFrame& frame = batch[batched];
                 frame.presentationNanos = pll_->getPresentationTimeNs(sample.absoluteSampleIndex);
 
                 // Check for valid timestamp (e.g., PLL might return 0 if it can't estimate yet)
@@ -504,14 +558,12 @@ void AmdtpReceiver::handleProcessedData(const std::vector<ProcessedSample>& samp
                 frame.sampleL = sample.sampleL;
                 frame.sampleR = sample.sampleR;
 
-                // Write frame to appRingBuffer_
-                size_t written = appRingBuffer_->write(sizeof(frame), &frame);
-                if (written != sizeof(frame)) {
-                     if (logger_) logger_->error("Failed to write complete frame (AbsIdx {}) to ring buffer! Buffer full?", sample.absoluteSampleIndex);
-                     // Handle ring buffer full - break is reasonable for now
-                     break;
+                if (++batched == kBatchFrames) {
+                    flush();
+                    if (ringFull) break;
                 }
             }
+            if (batched && !ringFull) flush();
              if (logger_ && !samples.empty()) logger_->trace("Finished writing samples. Last AbsIdx: {}", samples.back().absoluteSampleIndex);
 
         } else {
@@ -787,7 +839,7 @@ std::expected<void, IOKitError> AmdtpReceiver::synchronizeAndInitializePLL() {
     return {};
 }
 
-raul::RingBuffer* AmdtpReceiver::getAppRingBuffer() const {
+AppRingBuffer* AmdtpReceiver::getAppRingBuffer() const {
     return appRingBuffer_.get(); // Simply return the raw pointer from unique_ptr
 }
 
@@ -0,0 +1,98 @@
+#include "Isoch/core/AmdtpTimingGenerator.hpp"
+
+namespace FWA {
+namespace Isoch {
+
+AmdtpTimingGenerator::AmdtpTimingGenerator(uint32_t sampleRate, uint32_t transferDelayTicks,
+                                           AmdtpTransmissionMode mode)
+    : rate_(findAmdtpRate(sampleRate)),
+      mode_(mode),
+      interval_(rate_ ? rate_->sytInterval : 0),
+      stepTicks_(rate_ ? rate_->ticksPerPacket : 0),
+      stepRemainder_(rate_ ? rate_->ticksRemainder : 0),
+      denominator_(rate_ ? rate_->ticksDenominator : 1),
+      delayCycles_(transferDelayTicks / kTicksPerCycle),
+      delayTicks_(transferDelayTicks % kTicksPerCycle)
+{
+    reset(0);
+}
+
+uint32_t AmdtpTimingGenerator::framesPerPacket() const {
+    if (!rate_) return 0;
+    return mode_ == AmdtpTransmissionMode::NonBlocking ? (rate_->sampleRate + kCyclesPerSecond - 1) / kCyclesPerSecond
+                                                       : interval_;
+}
+
+void AmdtpTimingGenerator::reset(uint32_t startCycle, uint8_t dbc) {
+    cycle_ = startCycle % kCyclesPerWrap;
+    packetCycle_ = cycle_;
+    packetTicks_ = 0;
+    fraction_ = 0;
+    secondCycle_ = 0;
+    secondFrame_ = 0;
+    dbc_ = dbc;
+}
+
+// Presentation time (cycle index, ticks into it) + transfer delay, as cycle-timer low bits
+uint16_t AmdtpTimingGenerator::syt(uint32_t cycle, uint32_t ticks) const {
+    ticks += delayTicks_;
+    const uint32_t carry = ticks >= kTicksPerCycle;
+    ticks -= carry * kTicksPerCycle;
+    const uint32_t sytCycle = (cycle + delayCycles_ + carry) & 0xF;
+    return static_cast<uint16_t>((sytCycle << 12) | ticks);
+}
+
+CycleTiming AmdtpTimingGenerator::next() {
+    if (mode_ == AmdtpTransmissionMode::NonBlocking) return nextNonBlocking();
+
+    CycleTiming t;
+    t.dbc = dbc_;
+    if (packetCycle_ == cycle_ && interval_) {
+        t.syt = syt(packetCycle_, packetTicks_);
+        t.dataBlocks = static_cast<uint8_t>(interval_);
+        dbc_ = static_cast<uint8_t>(dbc_ + interval_);
+
+        // Next packet: every step is longer than one cycle and shorter than three
+        fraction_ += stepRemainder_;
+        const uint32_t extra = fraction_ >= denominator_;
+        fraction_ -= extra * denominator_;
+        packetTicks_ += stepTicks_ + extra;
+        while (packetTicks_ >= kTicksPerCycle) {
+            packetTicks_ -= kTicksPerCycle;
+            packetCycle_ = nextCycle(packetCycle_);
+        }
+    }
+    cycle_ = nextCycle(cycle_);
+    return t;
+}
+
+CycleTiming AmdtpTimingGenerator::nextNonBlocking() {
+    CycleTiming t;
+    t.dbc = dbc_;
+    if (rate_) {
+        // Frames presented by the end of this cycle; a second is exactly 8000 cycles and rate frames
+        const uint32_t rate = rate_->sampleRate;
+        const uint32_t end = static_cast<uint32_t>((uint64_t(secondCycle_ + 1) * rate + kCyclesPerSecond - 1) / kCyclesPerSecond);
+        const uint32_t blocks = end - secondFrame_;
+
+        // SYT belongs to the block whose DBC is a multiple of SYT_INTERVAL, if the packet has one
+        const uint32_t toSyt = (interval_ - dbc_ % interval_) % interval_;
+        if (toSyt < blocks) {
+            const uint64_t ticks = uint64_t(secondFrame_ + toSyt) * kTicksPerCycle * kCyclesPerSecond / rate;
+            t.syt = syt(cycle_, static_cast<uint32_t>(ticks % kTicksPerCycle));
+        }
+        t.dataBlocks = static_cast<uint8_t>(blocks);
+        dbc_ = static_cast<uint8_t>(dbc_ + blocks);
+
+        secondFrame_ = end;
+        if (++secondCycle_ == kCyclesPerSecond) {
+            secondCycle_ = 0;
+            secondFrame_ = 0;
+        }
+    }
+    cycle_ = nextCycle(cycle_);
+    return t;
+}
+
+} // namespace Isoch
+} // namespace FWA
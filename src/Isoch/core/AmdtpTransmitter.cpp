@@ -4,14 +4,51 @@
 #include "Isoch/core/IsochTransmitDCLManager.hpp"
 #include "Isoch/core/IsochTransportManager.hpp"
 #include "Isoch/core/IsochPacketProvider.hpp"
+#include "Isoch/core/ShmPacketProvider.hpp"
 #include <mach/mach_time.h> // For mach_absolute_time
 #include <CoreServices/CoreServices.h> // For endian swap
+#include <algorithm>
 #include <vector>
 #include <chrono> // For timing/sleep 
+#include <thread>
 
 namespace FWA {
 namespace Isoch {
 
+namespace {
+uint64_t machToNanos(uint64_t machTime) {
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0) {
+        mach_timebase_info(&timebase);
+    }
+    return machTime * timebase.numer / timebase.denom;
+}
+
+// The transmitter whose DCL callback this thread is in, if any
+thread_local const AmdtpTransmitter* tInCallback = nullptr;
+
+// Counts a DCL callback in flight for stopTransmit(). Entered before the running_ check: the
+// increment and the check pair (seq_cst) with stopTransmit clearing running_, then draining.
+class CallbackScope {
+public:
+    CallbackScope(const AmdtpTransmitter* owner, std::atomic<uint32_t>& inFlight)
+        : inFlight_(inFlight), previous_(tInCallback) {
+        inFlight_.fetch_add(1);
+        tInCallback = owner;
+    }
+    ~CallbackScope() {
+        tInCallback = previous_;
+        inFlight_.fetch_sub(1, std::memory_order_release);
+    }
+    CallbackScope(const CallbackScope&) = delete;
+    CallbackScope& operator=(const CallbackScope&) = delete;
+
+private:
+    std::atomic<uint32_t>& inFlight_;
+    const AmdtpTransmitter* previous_;
+};
+} // namespace
+
 // --- Factory Method ---
 std::shared_ptr<AmdtpTransmitter> AmdtpTransmitter::create(const TransmitterConfig& config) {
     // Using make_shared with a helper struct to handle enable_shared_from_this properly
@@ -42,6 +79,10 @@ std::expected<void, IOKitError> AmdtpTransmitter::startTransmit() {
             logger_->warn("startTransmit: Already running.");
             return {}; // Not an error
         }
+        if (stopping_) {
+            logger_->warn("startTransmit: Stop still in progress.");
+            return std::unexpected(IOKitError::Busy);
+        }
         if (!portChannelManager_ || !dclManager_ || !transportManager_ || !packetProvider_ || !bufferManager_) {
             logger_->error("startTransmit: Required components not available.");
             return std::unexpected(IOKitError::NotReady);
@@ -52,48 +93,43 @@ std::expected<void, IOKitError> AmdtpTransmitter::startTransmit() {
         // --- 1. Reset State ---
         initializeCIPState(); // Reset DBC, SYT state, first callback flag etc.
 
+        // The pre-render worker has to be up before the first completion can submit to it
+        if (pipeline_ && !pipeline_->start(RenderGroup_Helper, this,
+                                          uint64_t(config_.packetsPerGroup) * PacketTimeInterpolator::kNanosPerCycle)) {
+            logger_->error("startTransmit: Failed to start the pre-render worker.");
+            return std::unexpected(IOKitError::InternalError);
+        }
+
         // --- 2. Initial DCL Memory Preparation Loop ---
         // Pre-fill the *memory* associated with *all* DCLs with initial safe values
         logger_->debug("Performing initial memory preparation for DCL ring...");
         uint32_t totalPacketsToPrep = config_.numGroups * config_.packetsPerGroup;
+        const TransmitPacketDescriptor* packets = bufferManager_->getPacketDescriptors();
+        const uint32_t packetCount = bufferManager_->getPacketCount();
 
         for (uint32_t absPktIdx = 0; absPktIdx < totalPacketsToPrep; ++absPktIdx) {
             uint32_t g = absPktIdx / config_.packetsPerGroup;
             uint32_t p = absPktIdx % config_.packetsPerGroup;
 
             // --- 2a. Get Buffer Pointers ---
-            auto cipHdrPtrExp = bufferManager_->getPacketCIPHeaderPtr(g, p);
-            uint8_t* audioDataTargetPtr = nullptr;
-            if(bufferManager_->getClientAudioBufferPtr() && bufferManager_->getClientAudioBufferSize() > 0) {
-               audioDataTargetPtr = bufferManager_->getClientAudioBufferPtr()
-                               + (absPktIdx * bufferManager_->getAudioPayloadSizePerPacket()) % bufferManager_->getClientAudioBufferSize();
-            }
-            auto isochHdrPtrExp = bufferManager_->getPacketIsochHeaderPtr(g, p); // For template update
-
-            if (!cipHdrPtrExp || !audioDataTargetPtr || !isochHdrPtrExp) {
+            const TransmitPacketDescriptor* packet = absPktIdx < packetCount ? &packets[absPktIdx] : nullptr;
+            if (!packet || !packet->payload) {
                 logger_->error("startTransmit: Failed to get buffer pointers for initial prep G={}, P={}", g, p);
                 // Don't start if buffers aren't right
                 error_code = IOKitError::InternalError;
                 // Go to end of locked scope
                 break;
             }
-            CIPHeader* cipHdrTarget = reinterpret_cast<CIPHeader*>(cipHdrPtrExp.value());
+            CIPHeader* cipHdrTarget = packet->cipHeader;
             size_t audioPayloadTargetSize = bufferManager_->getAudioPayloadSizePerPacket();
-            IsochHeaderData* isochHdrTarget = reinterpret_cast<IsochHeaderData*>(isochHdrPtrExp.value());
+            IsochHeaderData* isochHdrTarget = packet->isochHeader;
 
-            // --- 2b. Fill Audio Payload (Initial Silence) ---
-            // Ask provider to fill - it should generate silence if its buffer is empty.
-            TransmitPacketInfo dummyInfo = { .segmentIndex = g, .packetIndexInGroup = p, .absolutePacketIndex = absPktIdx };
-            PreparedPacketData packetDataStatus = packetProvider_->fillPacketData(
-                audioDataTargetPtr,
-                audioPayloadTargetSize,
-                dummyInfo
-            );
-
-            // --- 2c. Prepare CIP Header (Initial State) ---
-            prepareCIPHeader(cipHdrTarget);
+            // --- 2b. Prepare CIP Header (Initial State) ---
+            // Timing is unknown until the first DCL callback, so every primed packet is NO_DATA
+            // and the audio payload keeps the zeroes from allocation; no samples are consumed.
+            writeNoDataHeader(cipHdrTarget);
 
-            // --- 2d. Prepare Isoch Header Template ---
+            // --- 2c. Prepare Isoch Header Template ---
             // Set the channel, tag, tcode in the template memory
             uint8_t fwChannel = portChannelManager_->getActiveChannel().value_or(config_.initialChannel & 0x3F);
             // Calculate expected data_length (CIP + Payload, even if payload is silence for now)
@@ -146,7 +182,6 @@ std::expected<void, IOKitError> AmdtpTransmitter::startTransmit() {
         // --- 5. Update State (only if no error so far) ---
         if (error_code == IOKitError::Success) {
             running_ = true;
-            firstDCLCallbackOccurred_ = false; // Reset for timing measurements
             logger_->info("AmdtpTransmitter transmit started successfully.");
 
             // -- Read callback info while lock is held --
@@ -160,9 +195,13 @@ std::expected<void, IOKitError> AmdtpTransmitter::startTransmit() {
     // --- Handle return/notification outside the lock ---
     if (error_code != IOKitError::Success) {
         // An error occurred during setup
+        if (pipeline_) pipeline_->stop();
         return std::unexpected(error_code);
     }
 
+    // Faults counted by the DCL callback are reported from here on, summarized per interval
+    eventDispatcher_.start(EventSummary_Helper, this);
+
     // Call the callback directly after releasing the lock
     if (callback_to_notify) {
         callback_to_notify(static_cast<uint32_t>(TransmitterMessage::StreamStarted), 0, 0, refcon_to_notify);
@@ -173,35 +212,54 @@ std::expected<void, IOKitError> AmdtpTransmitter::startTransmit() {
 
 // --- IMPLEMENT stopTransmit ---
 std::expected<void, IOKitError> AmdtpTransmitter::stopTransmit() {
-    std::lock_guard<std::mutex> lock(stateMutex_); // Ensure exclusive access
-    if (!initialized_) {
-        return {}; // Nothing to do
-    }
-    if (!running_) {
-        return {}; // Already stopped
-    }
+    // Final event summary first, outside the lock: its delivery takes stateMutex_
+    eventDispatcher_.stop();
+
+    IOFireWireLibIsochChannelRef channel = nullptr;
+    { // --- Check, then stop the callbacks: nothing changes if we can't proceed ---
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        if (!initialized_) {
+            return {}; // Nothing to do
+        }
+        if (!running_) {
+            return {}; // Already stopped
+        }
 
-    logger_->info("AmdtpTransmitter stopping transmit...");
-    running_ = false; // Signal handlers/callbacks to stop processing ASAP
+        // Check required components for cleanup
+        if (!portChannelManager_ || !transportManager_) {
+            logger_->error("stopTransmit: PortChannelManager or TransportManager missing. Cannot stop cleanly.");
+            return std::unexpected(IOKitError::NotReady);
+        }
 
-    // Check required components for cleanup
-    if (!portChannelManager_ || !transportManager_) {
-        logger_->error("stopTransmit: PortChannelManager or TransportManager missing. Cannot stop cleanly.");
-        // Setting running_ to false might prevent some crashes.
-        return std::unexpected(IOKitError::NotReady);
+        // Get the channel to stop transport
+        channel = portChannelManager_->getIsochChannel();
+        if (!channel) {
+            logger_->error("stopTransmit: Cannot get IsochChannel to stop transport.");
+            return std::unexpected(IOKitError::NotReady);
+        }
+
+        logger_->info("AmdtpTransmitter stopping transmit...");
+        stopping_ = true;
+        running_ = false; // Callbacks entering from now on return at once
     }
 
-    // Get the channel to stop transport
-    auto channel = portChannelManager_->getIsochChannel();
-    if (!channel) {
-        logger_->error("stopTransmit: Cannot get IsochChannel to stop transport.");
-        running_ = true; // Revert state if we can't proceed
-        return std::unexpected(IOKitError::NotReady);
+    // Callbacks already past their running_ check still use recovery_, the pipeline and the DMA
+    // slots. Drained outside the lock, which they take to notify; a stop from inside a callback
+    // (Fail paths) does not wait for itself.
+    const uint32_t self = (tInCallback == this) ? 1 : 0;
+    while (callbacksInFlight_.load() > self) {
+        std::this_thread::yield();
+    }
+
+    std::expected<void, IOKitError> stopResult;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        recovery_.stop();
+        stopResult = transportManager_->stop(channel);
+        if (pipeline_) pipeline_->stop(); // Waits for the group being rendered, drops the rest
+        stopping_ = false;
     }
 
-    // Stop the transport manager
-    auto stopResult = transportManager_->stop(channel);
-    
     logger_->info("AmdtpTransmitter transmit stopped.");
     notifyMessage(TransmitterMessage::StreamStopped); // Notify client
 
@@ -217,6 +275,7 @@ std::expected<void, IOKitError> AmdtpTransmitter::stopTransmit() {
 
 // --- handleDCLOverrun implementation ---
 void AmdtpTransmitter::handleDCLOverrun() {
+    CallbackScope scope(this, callbacksInFlight_);
     // Running check should happen *before* this is called ideally,
     // but double check here.
     if (!running_.load()) return;
@@ -224,13 +283,38 @@ void AmdtpTransmitter::handleDCLOverrun() {
     logger_->error("AmdtpTransmitter DCL Overrun detected!");
     notifyMessage(TransmitterMessage::OverrunError);
 
-    // Attempt to stop the transport cleanly
-    logger_->warn("Attempting to stop stream due to overrun...");
-    auto stopExp = stopTransmit();
-    if (!stopExp) {
-        logger_->error("Failed to stop stream cleanly during overrun handling: {}",
-                     iokit_error_category().message(static_cast<int>(stopExp.error())));
-        // At this point, state might be inconsistent.
+    // Recover in place: NO_DATA ring, Stop/Start on the same channel, resync at the next
+    // in-time completion. Channel, port, DCL program and buffers are all kept.
+    auto localPort = portChannelManager_ ? portChannelManager_->getLocalPort() : nullptr;
+    GroupAction action = recovery_.onOverrun(readCycleTime(0));
+    if (action == GroupAction::Reprime && (!localPort || !dclManager_ || !bufferManager_ || !transportManager_)) {
+        action = GroupAction::Fail;
+    }
+
+    if (action == GroupAction::Reprime) {
+        notifyMessage(TransmitterMessage::OverrunRecoveryAttempt, recovery_.recoveries());
+        // Pipeline mode: the NO_DATA ring is published by the first completion after the restart
+        reprimeRing(localPort);
+        auto restartExp = transportManager_->restart(portChannelManager_->getIsochChannel());
+        if (restartExp) {
+            events_.record(TransmitterEvent::OverrunRecovery);
+            logger_->warn("Overrun recovery {}: transport restarted in place", recovery_.recoveries());
+            return;
+        }
+        logger_->error("Overrun recovery: transport restart failed: {}",
+                       iokit_error_category().message(static_cast<int>(restartExp.error())));
+        action = GroupAction::Fail;
+    }
+
+    if (action == GroupAction::Fail) {
+        logger_->error("Overrun recovery failed after {} attempts; stopping stream", recovery_.recoveries());
+        auto stopExp = stopTransmit();
+        if (!stopExp) {
+            logger_->error("Failed to stop stream cleanly during overrun handling: {}",
+                         iokit_error_category().message(static_cast<int>(stopExp.error())));
+            // At this point, state might be inconsistent.
+        }
+        notifyMessage(TransmitterMessage::OverrunRecoveryFailed);
     }
 }
 
@@ -238,8 +322,10 @@ void AmdtpTransmitter::handleDCLOverrun() {
 // This is the core real-time loop function called from the RunLoop via the static helper
 void AmdtpTransmitter::handleDCLComplete(uint32_t completedGroupIndex) {
     // --- 1. State Check ---
-    // Check running state *without* lock first for performance optimisation
-    if (!running_.load(std::memory_order_relaxed)) {
+    // Check running state *without* lock first for performance optimisation; seq_cst after
+    // the scope's increment, so stopTransmit either sees this callback or it sees the stop
+    CallbackScope scope(this, callbacksInFlight_);
+    if (!running_.load()) {
         // logger_->trace("handleDCLComplete: Not running, ignoring callback for group {}", completedGroupIndex);
         return;
     }
@@ -256,181 +342,245 @@ void AmdtpTransmitter::handleDCLComplete(uint32_t completedGroupIndex) {
 
     // --- 2. Timing & Debug ---
     uint64_t callbackEntryTime = mach_absolute_time(); // Measure entry time
-    if (!firstDCLCallbackOccurred_) {
-        firstDCLCallbackOccurred_ = true;
-        // Potentially record first callback time for latency estimation
-        logger_->info("First DCL completion callback received for group {}", completedGroupIndex);
-    }
 
     // Read hardware completion timestamp for the completed group
     uint32_t completionTimestamp = 0;
     auto tsExp = bufferManager_->getGroupTimestampPtr(completedGroupIndex);
     if (tsExp) {
         completionTimestamp = *tsExp.value();
-        // logger_->trace("Completed Group {}: HW Timestamp = {:#010x}", completedGroupIndex, completionTimestamp);
-        // TODO: Use this timestamp for PLL/rate estimation later
     } else {
          logger_->warn("Could not get completion timestamp for group {}", completedGroupIndex);
     }
 
+    // Bus clock now, with the host time right after it: the lag check below and the anchor for
+    // this group's packet timestamps. Without a live reading the completion stamp stands in.
+    const uint32_t nowCycleTime = readCycleTime(completionTimestamp);
+    const uint64_t nowHostNano = machToNanos(mach_absolute_time());
+
+    // --- 3. Overrun Check & Segment to Fill ---
+    // The hardware is already sending the group after the completed one, so the completed
+    // group is refilled for its next pass: the one segment with a full ring of slack.
+    // TransmitRecovery decides whether we are still ahead of the hardware.
+    const GroupDecision decision = recovery_.onGroupComplete(completedGroupIndex, completionTimestamp,
+                                                             nowCycleTime);
+    TransmitRenderJob job{ completedGroupIndex, TransmitRenderJob::kNoResync, nowCycleTime, nowHostNano };
+    switch (decision.action) {
+    case GroupAction::Idle:
+        // Draining completions that are still too late; the ring keeps sending NO_DATA
+        if (pipeline_) publishRendered(localPort);
+        return;
+    case GroupAction::Fail: {
+        logger_->error("handleDCLComplete: fell behind too often ({} recoveries); stopping stream",
+                       recovery_.recoveries());
+        auto stopExp = stopTransmit();
+        notifyMessage(TransmitterMessage::OverrunRecoveryFailed);
+        return;
+    }
+    case GroupAction::Reprime:
+        // Every packet still in the ring is stale: overwrite it all with NO_DATA and resync later
+        reprimeRing(localPort);
+        events_.record(TransmitterEvent::OverrunRecovery);
+        return;
+    case GroupAction::Resync:
+        // First callback, or first in-time one after a re-prime: the completed group's first
+        // packet goes out in decision.resyncCycle, and every packet after it one cycle later.
+        // DBC carries on from the last packet prepared.
+        job.resyncCycle = decision.resyncCycle;
+        break;
+    case GroupAction::Fill:
+        break;
+    }
 
-    // --- 3. Determine Next Segment to Fill ---
-    // We need to fill the segment that the hardware will encounter *after*
-    // the currently executing segments. With a callback interval of 1,
-    // when group N completes, the hardware might be starting group N+1.
-    // We should prepare group N+2. If the interval is larger, adjust accordingly.
-    // For simplicity and robustness (double buffering), let's prepare the group
-    // immediately following the completed one in the ring.
-    uint32_t fillGroupIndex = (completedGroupIndex + 1) % config_.numGroups;
-    // logger_->trace("handleDCLComplete: Completed Group = {}, Preparing Group = {}", completedGroupIndex, fillGroupIndex);
+    // --- 4. Render & Publish ---
+    if (pipeline_) {
+        // The worker renders this group off the callback; publish whatever it has finished
+        if (!pipeline_->submit(job)) {
+            // Worker a ring behind: this group would go out again with last lap's headers, and a
+            // lost Resync would leave timing unanchored. Recover as for a late callback: NO_DATA
+            // ring now, fresh resync at the next in-time completion.
+            switch (recovery_.onRenderBacklog(nowCycleTime)) {
+            case GroupAction::Reprime:
+                reprimeRing(localPort);
+                events_.record(TransmitterEvent::OverrunRecovery);
+                return;
+            case GroupAction::Fail: {
+                logger_->error("handleDCLComplete: pre-render fell behind too often ({} recoveries); stopping stream",
+                               recovery_.recoveries());
+                auto stopExp = stopTransmit();
+                notifyMessage(TransmitterMessage::OverrunRecoveryFailed);
+                return;
+            }
+            default:
+                return;
+            }
+        }
+        publishRendered(localPort);
+    } else {
+        renderGroup(job);
+        publishGroup(localPort, job.group);
+    }
 
+    // --- 5. No DCL Jump Target Updates Needed ---
+    // We use a static circular DCL program configured during setup
+    // Hardware follows the pre-defined circular path
 
-    // --- 4. Prepare Next Segment Loop ---
-    // Iterate through all packets within the 'fillGroupIndex' segment
+    // --- 6. Performance Monitoring (Optional) ---
+    uint64_t callbackExitTime = mach_absolute_time();
+    uint64_t callbackDuration = callbackExitTime - callbackEntryTime;
+    
+    // Convert to milliseconds (this is a simple approximation)
+    uint64_t durationNanos = machToNanos(callbackDuration);
+    double durationMs = static_cast<double>(durationNanos) / 1000000.0;
+    
+    // Count callbacks over budget (e.g., 1ms for real-time audio)
+    static const double kWarningThresholdMs = 1.0; // 1ms is quite strict for real-time audio
+    if (durationMs > kWarningThresholdMs) {
+        events_.record(TransmitterEvent::LateCallback);
+    }
+}
+
+// --- renderGroup: provider pull, CIP headers and isoch headers for one group ---
+// Runs in the completion callback, or on the pipeline worker in pre-render mode. Writes only
+// the group's own DMA slots, which the hardware does not read again for almost a ring.
+void AmdtpTransmitter::renderGroup(const TransmitRenderJob& job) {
+    if (job.resyncCycle != TransmitRenderJob::kNoResync) {
+        timing_.reset(job.resyncCycle, timing_.dbc());
+    }
+    packetTimes_.anchor(job.anchorCycleTime, job.anchorHostNano);
+
+    // Everything per packet comes from the descriptor table built at setup: no locks, no lookups
+    const TransmitPacketDescriptor* packets = bufferManager_->getPacketDescriptors();
+    const uint32_t packetCount = bufferManager_->getPacketCount();
+    const size_t bytesPerDataBlock = streamFormat_.bytesPerDataBlock();
+    const uint8_t fwChannel = portChannelManager_->getActiveChannel().value_or(config_.initialChannel & 0x3F);
+    const uint32_t groupStartCycle = timing_.cycle(); // Cycle the group's first packet goes out in
+
+    // Faults are tallied locally and recorded once per group; the dispatcher thread reports them
+    uint32_t underruns = 0, skippedPackets = 0;
+
+    // Iterate through all packets within the job's segment
     for (uint32_t p = 0; p < config_.packetsPerGroup; ++p) {
-        uint32_t absolutePacketIndex = fillGroupIndex * config_.packetsPerGroup + p;
-
-        // --- 4a. Get Buffer Pointers ---
-        // Pointers to where we write the headers in DMA memory
-        auto isochHdrPtrExp = bufferManager_->getPacketIsochHeaderPtr(fillGroupIndex, p);
-        auto cipHdrPtrExp = bufferManager_->getPacketCIPHeaderPtr(fillGroupIndex, p);
-        // Pointer to where the *provider* writes audio data in DMA memory
-        uint8_t* audioDataTargetPtr = nullptr;
-         if(bufferManager_->getClientAudioBufferPtr() && bufferManager_->getClientAudioBufferSize() > 0) {
-            audioDataTargetPtr = bufferManager_->getClientAudioBufferPtr()
-                           + (absolutePacketIndex * bufferManager_->getAudioPayloadSizePerPacket()) % bufferManager_->getClientAudioBufferSize();
-         }
-
-        if (!isochHdrPtrExp || !cipHdrPtrExp || !audioDataTargetPtr) {
-            logger_->error("handleDCLComplete: Failed to get buffer pointers for G={}, P={}. Skipping packet.", fillGroupIndex, p);
+        uint32_t absolutePacketIndex = job.group * config_.packetsPerGroup + p;
+
+        // --- a. Get Buffer Pointers ---
+        if (absolutePacketIndex >= packetCount || !packets[absolutePacketIndex].dcl) {
+            ++skippedPackets;
             continue; // Skip this packet
         }
-        
-        IsochHeaderData* isochHdrTarget = reinterpret_cast<IsochHeaderData*>(isochHdrPtrExp.value());
-        CIPHeader* cipHdrTarget = reinterpret_cast<CIPHeader*>(cipHdrPtrExp.value());
-        size_t audioPayloadTargetSize = bufferManager_->getAudioPayloadSizePerPacket();
+        const TransmitPacketDescriptor& packet = packets[absolutePacketIndex];
+        // Headers in DMA memory, and where the *provider* writes audio data
+        IsochHeaderData* isochHdrTarget = packet.isochHeader;
+        CIPHeader* cipHdrTarget = packet.cipHeader;
+        uint8_t* audioDataTargetPtr = packet.payload;
 
 
-        // --- 4b. Prepare TransmitPacketInfo ---
-        // Estimate timing for this future packet (basic estimation for now)
-        // TODO: Integrate with PLL/Timing module for accurate prediction
-        uint64_t estimatedHostTimeNano = 0; // Placeholder
-        uint32_t estimatedFirewireTimestamp = 0; // Placeholder
+        // --- b. Prepare TransmitPacketInfo ---
+        // One packet per cycle from groupStartCycle; bus and host time from this group's anchor
+        const PacketTime packetTime = packetTimes_.at(groupStartCycle + p);
 
         TransmitPacketInfo packetInfo = {
-            .segmentIndex = fillGroupIndex,
+            .segmentIndex = job.group,
             .packetIndexInGroup = p,
             .absolutePacketIndex = absolutePacketIndex,
-            .hostTimestampNano = estimatedHostTimeNano,
-            .firewireTimestamp = estimatedFirewireTimestamp
+            .hostTimestampNano = packetTime.hostNano,
+            .firewireTimestamp = packetTime.cycleTime,
+            .dataBlockCounter = 0
         };
 
 
-        // --- 4c. Fill Audio Data ---
-        // Ask provider to fill the audio data directly into the DMA buffer slot
-        PreparedPacketData packetDataStatus = packetProvider_->fillPacketData(
-            audioDataTargetPtr,
-            audioPayloadTargetSize,
-            packetInfo
-        );
-
-        // Handle Underrun Notification
-        if (packetDataStatus.generatedSilence) {
-            // Notify client about underrun for this specific packet
-             // Throttle notification?
-             // logger_->warn("handleDCLComplete: Underrun preparing G={}, P={}", fillGroupIndex, p);
-            notifyMessage(TransmitterMessage::BufferUnderrun, fillGroupIndex, p);
-        }
+        // --- c. Prepare CIP Header ---
+        // The timing generator decides whether this cycle carries data (DBC/SYT/FDF)
+        // and the header is written directly into the DMA buffer slot.
+        const CycleTiming timing = prepareCIPHeader(cipHdrTarget);
+        packetInfo.dataBlockCounter = timing.dbc;
 
 
-        // --- 4d. Prepare CIP Header ---
-        // Generate the CIP header content (with updated DBC, SYT=0xFFFF for now)
-        // and write it directly into the DMA buffer slot.
-        prepareCIPHeader(cipHdrTarget); // NEW - Function now calculates isNoData internally
+        // --- d. Fill Audio Data ---
+        // Only data packets consume samples; the provider writes straight into the DMA buffer slot.
+        // The payload is the cycle's data blocks: always SYT_INTERVAL blocking, 5/6/... non-blocking.
+        PreparedPacketData packetDataStatus;
+        if (timing.hasData()) {
+            packetDataStatus = packetProvider_->fillPacketData(
+                audioDataTargetPtr,
+                timing.dataBlocks * bytesPerDataBlock,
+                packetInfo
+            );
 
+            // Underrun: the packet still goes out, carrying silence; counted, reported later
+            if (packetDataStatus.generatedSilence) {
+                ++underruns;
+            }
+        }
 
-        // --- 4e. Update Isoch Header ---
-        // Update Isoch header template with appropriate data_length, channel, etc.
-        uint8_t fwChannel = portChannelManager_->getActiveChannel().value_or(config_.initialChannel & 0x3F);
+
+        // --- e. Update Isoch Header ---
+        // data_length also tells publishGroup() whether the packet has a payload range
         isochHdrTarget->data_length = OSSwapHostToBigInt16(kTransmitCIPHeaderSize + packetDataStatus.dataLength);
         isochHdrTarget->tag_channel = (1 << 6) | (fwChannel & 0x3F);
         isochHdrTarget->tcode_sy = (0xA << 4) | 0; // TCode=0xA (Isoch Data Block)
 
+    } // --- End packet loop (p) ---
+
+    if (underruns) events_.record(TransmitterEvent::BufferUnderrun, underruns);
+    if (skippedPackets) events_.record(TransmitterEvent::SkippedPacket, skippedPackets);
+}
 
-        // --- 4f. Update DCL Ranges (if needed) ---
-        // Determine the correct number of ranges based on data availability
-        IOVirtualRange ranges[2];
-        uint32_t numRanges = 0;
+// --- publishGroup: DCL ranges and hardware notification for a rendered group ---
+// Always on the callback thread. Constant work per packet, whatever the channel count.
+void AmdtpTransmitter::publishGroup(IOFireWireLibLocalIsochPortRef localPort, uint32_t group) {
+    const TransmitPacketDescriptor* packets = bufferManager_->getPacketDescriptors();
+    const uint32_t packetCount = bufferManager_->getPacketCount();
+    uint32_t dclUpdateErrors = 0;
+
+    for (uint32_t p = 0; p < config_.packetsPerGroup; ++p) {
+        const uint32_t absolutePacketIndex = group * config_.packetsPerGroup + p;
+        if (absolutePacketIndex >= packetCount || !packets[absolutePacketIndex].dcl) continue;
+        const TransmitPacketDescriptor& packet = packets[absolutePacketIndex];
 
         // Range 0: CIP Header (Always present)
-        ranges[0].address = reinterpret_cast<IOVirtualAddress>(cipHdrTarget);
+        IOVirtualRange ranges[2];
+        uint32_t numRanges = 0;
+        ranges[0].address = reinterpret_cast<IOVirtualAddress>(packet.cipHeader);
         ranges[0].length = kTransmitCIPHeaderSize;
         numRanges++;
 
-        // Range 1: Audio Data (Only if data is available/not NO_DATA packet)
-        if (!packetDataStatus.generatedSilence && packetDataStatus.dataLength > 0) {
-             // Ensure the length matches what the provider gave, even if it generated silence (length would be targetSize)
-             // But we only add the range if !generatedSilence (meaning it's real data or intended silence padding)
-             // And dataLength should match audioPayloadTargetSize unless something went wrong.
-            ranges[1].address = reinterpret_cast<IOVirtualAddress>(audioDataTargetPtr);
-            ranges[1].length = packetDataStatus.dataLength; // Use length from provider status
+        // Range 1: Audio Data (data packets only; NO_DATA packets are just the CIP header)
+        const uint32_t dataLength = OSSwapBigToHostInt16(packet.isochHeader->data_length);
+        if (dataLength > kTransmitCIPHeaderSize) {
+            ranges[1].address = reinterpret_cast<IOVirtualAddress>(packet.payload);
+            ranges[1].length = dataLength - kTransmitCIPHeaderSize;
             numRanges++;
-        } else if (packetDataStatus.generatedSilence) {
-             // It's a NO_DATA packet conceptually, but we might still need to send
-             // the zeroed buffer if hardware requires fixed packet sizes.
-             // OR we tell the DCL to only send the CIP header.
-             // Let's assume for now we send only CIP for NO_DATA (FDF=0xFF).
-             numRanges = 1; // Only send CIP header range for NO_DATA packets
-             logger_->trace("handleDCLComplete: Setting numRanges=1 for NO_DATA G={}, P={}", fillGroupIndex, p);
         }
 
-        // Update the DCL command's ranges *if* the number of ranges changed
-        // (e.g., switching between NO_DATA and data)
-        // TODO: Need a way to get the *current* range count from the DCL to compare.
-        // For now, let's call update unconditionally, assuming SetDCLRanges handles it.
-        auto updateExp = dclManager_->updateDCLPacket(fillGroupIndex, p, ranges, numRanges, nullptr);
+        // The DCL manager remembers each DCL's ranges and skips SetDCLRanges when they
+        // match the previous lap (same slot, same DATA / NO_DATA state)
+        auto updateExp = dclManager_->setDCLRanges(absolutePacketIndex, packet.dcl, ranges, numRanges);
         if (!updateExp) {
-             logger_->error("handleDCLComplete: Failed to update DCL packet ranges for G={}, P={}: {}",
-                           fillGroupIndex, p, iokit_error_category().message(static_cast<int>(updateExp.error())));
-             // Decide how to handle this error - skip packet? stop stream?
+             ++dclUpdateErrors; // The DCL keeps its previous ranges
         }
+    }
+    if (dclUpdateErrors) events_.record(TransmitterEvent::DCLUpdateError, dclUpdateErrors);
 
-    } // --- End packet loop (p) ---
-
-
-    // --- 5. Notify Hardware of Memory Updates ---
     // Tell the hardware that the *memory content* (CIP headers, audio data)
-    // for the 'fillGroupIndex' has been updated and needs to be re-read before execution.
-    auto notifyContentExp = dclManager_->notifySegmentUpdate(localPort, fillGroupIndex);
-     if (!notifyContentExp) {
-         logger_->error("handleDCLComplete: Failed to notify segment content update for G={}: {}",
-                       fillGroupIndex, iokit_error_category().message(static_cast<int>(notifyContentExp.error())));
-        // Handle error - might lead to hardware sending stale data.
+    // for the group has been updated and needs to be re-read before execution.
+    auto notifyContentExp = dclManager_->notifySegmentUpdate(localPort, group);
+    if (!notifyContentExp) {
+        // Might lead to hardware sending stale data
+        events_.record(TransmitterEvent::NotifyError);
     }
+}
 
-    // --- 6. No DCL Jump Target Updates Needed ---
-    // We use a static circular DCL program configured during setup
-    // Hardware follows the pre-defined circular path
-
-    // --- 7. Performance Monitoring (Optional) ---
-    uint64_t callbackExitTime = mach_absolute_time();
-    uint64_t callbackDuration = callbackExitTime - callbackEntryTime;
-    
-    // Convert to milliseconds (this is a simple approximation)
-    static mach_timebase_info_data_t timebase;
-    if (timebase.denom == 0) {
-        mach_timebase_info(&timebase);
+// --- publishRendered: publish the worker's finished groups, in submission order ---
+// kAllGroups is a finished re-prime: taken ahead of every group rendered after it.
+void AmdtpTransmitter::publishRendered(IOFireWireLibLocalIsochPortRef localPort) {
+    uint32_t renderedGroup;
+    while (pipeline_->takeRendered(renderedGroup)) {
+        if (renderedGroup == TransmitRenderJob::kAllGroups) {
+            publishRing(localPort);
+        } else {
+            publishGroup(localPort, renderedGroup);
+        }
     }
-    
-    uint64_t durationNanos = callbackDuration * timebase.numer / timebase.denom;
-    double durationMs = static_cast<double>(durationNanos) / 1000000.0;
-    
-    // Log if duration exceeds threshold (e.g., 1ms for real-time audio)
-    static const double kWarningThresholdMs = 1.0; // 1ms is quite strict for real-time audio
-//    if (durationMs > kWarningThresholdMs) {
-//        logger_->warn("handleDCLComplete: Long processing time for G={}: {:.3f}ms", 
-//                     completedGroupIndex, durationMs);
-//    }
 }
 
 // --- Static Callbacks ---
@@ -444,24 +594,61 @@ void AmdtpTransmitter::DCLOverrunCallback_Helper(void* refCon) {
     if (self) self->handleDCLOverrun();
 }
 
+// Runs on the pre-render worker thread
+void AmdtpTransmitter::RenderGroup_Helper(const TransmitRenderJob& job, void* refCon) {
+    AmdtpTransmitter* self = static_cast<AmdtpTransmitter*>(refCon);
+    if (!self) return;
+    if (job.group == TransmitRenderJob::kAllGroups) {
+        self->writeNoDataRing(); // flush(): the re-prime, on the thread that owns the DMA slots
+    } else {
+        self->renderGroup(job);
+    }
+}
+
 void AmdtpTransmitter::TransportFinalize_Helper(void* refCon) {
     // AmdtpTransmitter* self = static_cast<AmdtpTransmitter*>(refCon);
     // if (self) self->handleFinalize(); // If finalize handling is needed
 }
 
+// Runs on the event dispatcher thread, at most once per interval
+void AmdtpTransmitter::EventSummary_Helper(const TransmitterEventSnapshot& delta,
+                                           const TransmitterEventSnapshot& totals, void* refCon) {
+    AmdtpTransmitter* self = static_cast<AmdtpTransmitter*>(refCon);
+    if (!self) return;
+
+    const uint64_t underruns = delta[TransmitterEvent::BufferUnderrun];
+    const uint64_t otherFaults = delta.total() - underruns;
+    self->logger_->warn("AmdtpTransmitter: {} underrun packets, {} skipped, {} DCL update errors, "
+                        "{} notify errors, {} late callbacks, {} overrun recoveries (total underruns {})",
+                        underruns, delta[TransmitterEvent::SkippedPacket], delta[TransmitterEvent::DCLUpdateError],
+                        delta[TransmitterEvent::NotifyError], delta[TransmitterEvent::LateCallback],
+                        delta[TransmitterEvent::OverrunRecovery],
+                        totals[TransmitterEvent::BufferUnderrun]);
+    self->notifyMessage(TransmitterMessage::EventSummary,
+                        static_cast<uint32_t>(std::min<uint64_t>(underruns, UINT32_MAX)),
+                        static_cast<uint32_t>(std::min<uint64_t>(otherFaults, UINT32_MAX)));
+}
+
 
 
 
 // Constructor
 AmdtpTransmitter::AmdtpTransmitter(const TransmitterConfig& config)
- : config_(config), logger_(config.logger ? config.logger : spdlog::default_logger()) {
+ : config_(config), streamFormat_(config.streamFormat()), timing_(streamFormat_.sampleRate, AmdtpTimingGenerator::kDefaultTransferDelayTicks, streamFormat_.mode),
+   logger_(config.logger ? config.logger : spdlog::default_logger()),
+   recovery_(TransmitRecoveryConfig{ config.numGroups, config.packetsPerGroup, config.callbackGroupInterval }) {
     logger_->info("AmdtpTransmitter constructing...");
+    if (config_.preRenderPipeline) {
+        pipeline_ = std::make_unique<TransmitRenderPipeline>(config_.numGroups);
+        logger_->info("AmdtpTransmitter: groups are pre-rendered on a worker thread");
+    }
     // Initialize other members if necessary
 }
 
 // Destructor
 AmdtpTransmitter::~AmdtpTransmitter() {
     logger_->info("AmdtpTransmitter destructing...");
+    eventDispatcher_.stop();
      if (running_.load()) {
         // Attempt to stop, log errors but don't throw from destructor
         auto result = stopTransmit();
@@ -473,6 +660,7 @@ AmdtpTransmitter::~AmdtpTransmitter() {
 // cleanup
 void AmdtpTransmitter::cleanup() noexcept {
     logger_->debug("AmdtpTransmitter cleanup starting...");
+    if (pipeline_) pipeline_->stop(); // The worker renders through the managers released below
     packetProvider_.reset();
     transportManager_.reset();
     dclManager_.reset();
@@ -491,16 +679,26 @@ std::expected<void, IOKitError> AmdtpTransmitter::setupComponents(IOFireWireLibN
      portChannelManager_ = std::make_unique<IsochPortChannelManager>(logger_, interface, runLoopRef_, true /*isTalker*/);
      dclManager_ = std::make_unique<IsochTransmitDCLManager>(logger_);
      transportManager_ = std::make_unique<IsochTransportManager>(logger_);
-     packetProvider_ = std::make_unique<IsochPacketProvider>(logger_, config_.clientBufferSize);
+     if (config_.sharedMemoryRing) {
+         // Zero-copy: encode straight out of the driver's shared-memory ring
+         packetProvider_ = std::make_unique<ShmPacketProvider>(logger_, config_.sharedMemoryRing, streamFormat_);
+     } else {
+         packetProvider_ = std::make_unique<IsochPacketProvider>(logger_, config_.clientBufferSize, streamFormat_);
+     }
 
      // Initialize... (Error checking omitted for brevity in stub)
      bufferManager_->setupBuffers(config_);
+     portChannelManager_->setIRMPacketSize(config_.irmPayloadBytes());
      portChannelManager_->initialize();
      auto dclPool = portChannelManager_->getNuDCLPool();
      if (!dclPool) return std::unexpected(IOKitError::NotReady);
      auto dclProgResult = dclManager_->createDCLProgram(config_, dclPool, *bufferManager_);
      if (!dclProgResult) return std::unexpected(dclProgResult.error());
       DCLCommand* dclProgramHandle = dclProgResult.value();
+     // Resolve each packet's DCL once so the completion callback never looks it up
+     for (uint32_t i = 0; i < bufferManager_->getPacketCount(); ++i) {
+         bufferManager_->bindPacketDCL(i, dclManager_->getDCLRef(i / config_.packetsPerGroup, i % config_.packetsPerGroup));
+     }
      portChannelManager_->setupLocalPortAndChannel(dclProgramHandle, bufferManager_->getBufferRange());
      dclManager_->setDCLCompleteCallback(DCLCompleteCallback_Helper, this); // Set internal callback forwarder
      dclManager_->setDCLOverrunCallback(DCLOverrunCallback_Helper, this);
@@ -515,6 +713,7 @@ std::expected<void, IOKitError> AmdtpTransmitter::initialize(IOFireWireLibNubRef
      if (initialized_) return std::unexpected(IOKitError::Busy);
      if (!interface) return std::unexpected(IOKitError::BadArgument);
      runLoopRef_ = CFRunLoopGetCurrent(); // Assign runloop
+     interface_ = interface;
 
      auto setupResult = setupComponents(interface); // Call setup
      if (!setupResult) {
@@ -544,6 +743,16 @@ bool AmdtpTransmitter::pushAudioData(const void* buffer, size_t bufferSizeInByte
     return packetProvider_->pushAudioData(buffer, bufferSizeInBytes);
 }
 
+bool AmdtpTransmitter::pushAudioData(const void* buffer, size_t bufferSizeInBytes, AM824InputFormat format) {
+    if (!initialized_ || !packetProvider_) return false;
+    return packetProvider_->pushAudioData(buffer, bufferSizeInBytes, format);
+}
+
+bool AmdtpTransmitter::pushMidiData(uint32_t port, const uint8_t* bytes, size_t count) {
+    if (!initialized_ || !packetProvider_) return false;
+    return packetProvider_->pushMidiData(port, bytes, count);
+}
+
 // setMessageCallback
 void AmdtpTransmitter::setMessageCallback(MessageCallback callback, void* refCon) {
     logger_->debug("AmdtpTransmitter::setMessageCallback");
@@ -567,110 +776,79 @@ void AmdtpTransmitter::notifyMessage(TransmitterMessage msg, uint32_t p1, uint32
      }
 }
 
-// initializeCIPState
-void AmdtpTransmitter::initializeCIPState() {
-     logger_->debug("AmdtpTransmitter::initializeCIPState");
-     dbc_count_ = 0;
-     wasNoData_ = true; // Start assuming previous was NoData
-
-     // --- Initialize SYT state ---
-     // Start offset >= TICKS_PER_CYCLE to ensure first packets are NO_DATA
-     // until the first callback establishes real timing.
-     sytOffset_ = TICKS_PER_CYCLE; // Initialize to 3072
-     sytPhase_ = 0;
-     // --- End Initialize SYT state ---
+// reprimeRing: every packet becomes NO_DATA carrying the next DBC, then the whole ring is
+// re-read by the hardware. Only used off the fast path (recovery). In pipeline mode the
+// worker may be inside renderGroup(): flush() drops its queue and has it write the ring
+// next, and publishRendered() publishes it; the callback never waits.
+void AmdtpTransmitter::reprimeRing(IOFireWireLibLocalIsochPortRef localPort) {
+    if (pipeline_) {
+        pipeline_->flush();
+        return;
+    }
+    writeNoDataRing();
+    publishRing(localPort);
+}
 
-     firstDCLCallbackOccurred_ = false;
-     expectedTimeStampCycle_ = 0;
+// writeNoDataRing: the DMA half of a re-prime. data_length marks every packet header-only
+// for publishGroup().
+void AmdtpTransmitter::writeNoDataRing() {
+    const TransmitPacketDescriptor* packets = bufferManager_->getPacketDescriptors();
+    const uint32_t packetCount = bufferManager_->getPacketCount();
+
+    for (uint32_t i = 0; i < packetCount; ++i) {
+        const TransmitPacketDescriptor& packet = packets[i];
+        if (!packet.dcl) continue;
+        writeNoDataHeader(packet.cipHeader);
+        packet.isochHeader->data_length = OSSwapHostToBigInt16(kTransmitCIPHeaderSize);
+    }
 }
 
-// prepareCIPHeader
-void AmdtpTransmitter::prepareCIPHeader(CIPHeader* outHeader) {
-    // logger_->trace("AmdtpTransmitter::prepareCIPHeader()");
-    if (!outHeader || !portChannelManager_ || !bufferManager_) { /* error */ return; }
-
-    // --- Get Node ID, SFC, Set static fields ---
-    uint16_t nodeID = portChannelManager_->getLocalNodeID().value_or(0x3F); // Default to local node ID
-
-    // --- Determine SFC from config ---
-    uint8_t sfc = 0x00; // Default 32kHz
-    if (config_.sampleRate == 44100.0) sfc = 0x01;      // SFC for 44.1kHz
-    else if (config_.sampleRate == 48000.0) sfc = 0x02; // SFC for 48kHz
-    else if (config_.sampleRate == 88200.0) sfc = 0x03; // SFC for 88.2kHz
-    else if (config_.sampleRate == 96000.0) sfc = 0x04; // SFC for 96kHz
-    else if (config_.sampleRate == 176400.0) sfc = 0x05; // SFC for 176.4kHz
-    else if (config_.sampleRate == 192000.0) sfc = 0x06; // SFC for 192kHz
-    else {
-        logger_->warn("prepareCIPHeader: Unsupported sample rate {:.1f}Hz, using SFC for 48kHz.", config_.sampleRate);
-        sfc = 0x02; // Fallback
+// publishRing: the hardware half of a re-prime, on the callback thread
+void AmdtpTransmitter::publishRing(IOFireWireLibLocalIsochPortRef localPort) {
+    for (uint32_t g = 0; g < config_.numGroups; ++g) {
+        publishGroup(localPort, g);
     }
+    logger_->warn("AmdtpTransmitter: ring re-primed with NO_DATA (recovery {})", recovery_.recoveries());
+}
 
-    // --- Set static fields ---
-    outHeader->sid_byte = 0; // Assuming HW/Port sets SID correctly
-    outHeader->dbs = 2;      // AM824 Stereo (8 bytes/4 = 2)
-    outHeader->fn_qpc_sph_rsv = 0; // Usually 0 for AMDTP
-    outHeader->fmt_eoh1 = (0x10 << 2) | 0x01; // FMT=0x10 (AM824), EOH=1
+// writeNoDataHeader: empty packet carrying the DBC of the next data packet
+void AmdtpTransmitter::writeNoDataHeader(CIPHeader* outHeader) const {
+    streamFormat_.writeCIPHeader(reinterpret_cast<uint8_t*>(outHeader), 0, timing_.dbc(),
+                                 AmdtpStreamFormat::kFdfNoData, 0xFFFF);
+}
 
-    // --- Calculate SYT and isNoData for 44.1kHz ---
-    bool calculated_isNoData = false;
-    uint16_t calculated_sytVal = 0xFFFF;
+// readCycleTime: the bus cycle timer, for measuring how late a completion is handled
+uint32_t AmdtpTransmitter::readCycleTime(uint32_t fallback) const {
+    UInt32 cycleTime = 0;
+    if (interface_ && (*interface_)->GetCycleTime(interface_, &cycleTime) == kIOReturnSuccess) {
+        return cycleTime;
+    }
+    return fallback;
+}
 
-    if (!firstDCLCallbackOccurred_) {
-        // Before first callback, timing is unknown, force NO_DATA
-        calculated_isNoData = true;
-        // sytOffset_ remains >= TICKS_PER_CYCLE from initialization
-    } else {
-        // Apply 44.1kHz SYT offset logic based on decompiled code
-        if (sytOffset_ >= TICKS_PER_CYCLE) {
-            // Was NO_DATA previously, or just wrapped. Reset offset within the cycle.
-            sytOffset_ -= TICKS_PER_CYCLE;
-        } else {
-            // Normal increment logic for 44.1kHz
-            uint32_t phase = sytPhase_ % SYT_PHASE_MOD;
-            bool addExtra = (phase && !(phase & 3)) || (sytPhase_ == (SYT_PHASE_RESET - 1)); // Adjusted phase check
-            sytOffset_ += BASE_TICKS; // Add ~1386
-            if (addExtra) {
-                sytOffset_ += 1; // Add occasional extra tick
-            }
+// initializeCIPState
+void AmdtpTransmitter::initializeCIPState() {
+     logger_->debug("AmdtpTransmitter::initializeCIPState");
+     // DBC restarts at 0; the SYT sequence is anchored to the bus cycle at the first callback
+     // (TransmitRecovery: Starting -> Running). Until then the ring holds NO_DATA packets.
+     timing_.reset(0);
+     recovery_.start();
+     packetTimes_.reset();
+     expectedTimeStampCycle_ = 0;
+}
 
-            // Increment and wrap phase accumulator
-            if (++sytPhase_ >= SYT_PHASE_RESET) {
-                sytPhase_ = 0;
-            }
-        }
+// prepareCIPHeader
+CycleTiming AmdtpTransmitter::prepareCIPHeader(CIPHeader* outHeader) {
+    // logger_->trace("AmdtpTransmitter::prepareCIPHeader()");
+    if (!outHeader) { /* error */ return {}; }
 
-        // Check if the *new* offset exceeds the cycle boundary
-        if (sytOffset_ >= TICKS_PER_CYCLE) {
-            calculated_isNoData = true; // Will send NO_DATA this time
-        } else {
-            calculated_isNoData = false; // Will send valid data
-            calculated_sytVal = static_cast<uint16_t>(sytOffset_);
-        }
-    }
-    // --- End SYT Calculation ---
-
-    // --- Set Dynamic Fields (FDF, SYT, DBC) ---
-    if (calculated_isNoData) {
-        outHeader->fdf = 0xFF; // FDF for NO_DATA
-        outHeader->syt = OSSwapHostToBigInt16(0xFFFF); // SYT for NO_DATA
-        // DBC: Repeat the previous DBC value if sending NO_DATA
-        outHeader->dbc = dbc_count_;
-    } else {
-        outHeader->fdf = sfc; // FDF for the specific sample rate
-        outHeader->syt = OSSwapHostToBigInt16(calculated_sytVal); // Calculated SYT value
-        // DBC: Increment only if the *previous* packet was *not* NO_DATA
-        uint8_t blocksPerPacket = bufferManager_->getAudioPayloadSizePerPacket() / 8; // 64/8 = 8 blocks typically
-        uint8_t increment = blocksPerPacket;
-        // Use wasNoData_ (state *before* this packet)
-        uint8_t next_dbc = wasNoData_ ? dbc_count_ : (dbc_count_ + increment);
-        outHeader->dbc = next_dbc & 0xFF;
-    }
-    // --- End Set Dynamic Fields ---
+    const CycleTiming timing = timing_.next();
 
-    // --- Update State for *Next* Call ---
-    dbc_count_ = outHeader->dbc;    // Store the DBC we *just* put in the header
-    wasNoData_ = calculated_isNoData; // Store the type of packet we *just* prepared
-    // Note: sytOffset_ and sytPhase_ were already updated during calculation
+    // SID left 0 (HW/Port sets it); DBS from the stream format, DBC/SYT from the generator
+    streamFormat_.writeCIPHeader(reinterpret_cast<uint8_t*>(outHeader), 0, timing.dbc,
+                                 timing.hasData() ? timing_.sfc() : AmdtpStreamFormat::kFdfNoData,
+                                 timing.syt);
+    return timing;
 }
 
 
@@ -76,6 +76,9 @@ void AudioClockPLL::resetState() {
     currentRatio_ = 1.0;
     phaseErrorAccumulator_ = 0.0;
     frequencyAdjustment_ = 0.0;
+    if (clockTarget_) {
+        RTShmRing::PublishClock(*clockTarget_, RTShmRing::ClockSnapshot{}); // retract until re-locked
+    }
     if (logger_) logger_->info("PLL state reset.");
 }
 
@@ -88,9 +91,31 @@ void AudioClockPLL::initialize(uint64_t initialHostTimeAbs, uint32_t initialFwTi
     lastFwTimestamp_ = initialFwTimestamp;
     lastPacketEndAbsSampleIndex_ = 0;
     lastSYT_HostTimeAbs_ = initialHostTimeAbs; // Initialize SYT anchor host time
+    ++clockSeed_;
     initialized_ = true;
 }
 
+void AudioClockPLL::setClockPublishTarget(RTShmRing::RingView ring) {
+    clockTarget_ = ring ? ring.control : nullptr;
+    if (logger_) logger_->info("PLL clock publishing {}", clockTarget_ ? "enabled" : "disabled");
+    if (clockTarget_ && initialized_ && lastSYT_ != 0xFFFF) {
+        publishClock();
+    }
+}
+
+void AudioClockPLL::publishClock() {
+    if (!clockTarget_ || targetSampleRate_ <= 0 || currentRatio_ <= 0) return;
+    const double hostTicksPerSec = static_cast<double>(NANOS_PER_SECOND * timebaseInfo_.denom) / timebaseInfo_.numer;
+    RTShmRing::ClockSnapshot snapshot;
+    snapshot.seed = clockSeed_;
+    snapshot.anchorSampleTime = static_cast<double>(lastSYT_AbsSampleIndex_);
+    snapshot.anchorHostTime = lastSYT_HostTimeAbs_;
+    snapshot.hostTicksPerSample = hostTicksPerSec / targetSampleRate_ / currentRatio_; // same slope as getPresentationTimeNs
+    snapshot.rateScalar = currentRatio_;
+    snapshot.sampleRate = targetSampleRate_;
+    RTShmRing::PublishClock(*clockTarget_, snapshot);
+}
+
 // Called separately after initialize() when the first valid SYT arrives
 void AudioClockPLL::updateInitialSYT(uint16_t firstSyt, uint32_t firstSytFwTimestamp, uint64_t firstSytAbsSampleIndex) {
     if (!initialized_) {
@@ -104,6 +129,7 @@ void AudioClockPLL::updateInitialSYT(uint16_t firstSyt, uint32_t firstSytFwTimes
         lastSYT_HostTimeAbs_ = mach_absolute_time(); // Host time when this SYT is processed
         if (logger_) logger_->info("PLL Initial SYT Captured: SYT={}, FW_TS={:#0x}, AbsSampleIdx={}, HostAbs={}",
                                   lastSYT_, lastSYT_FWTimestamp_, lastSYT_AbsSampleIndex_, lastSYT_HostTimeAbs_);
+        publishClock();
     }
 }
 
@@ -191,6 +217,7 @@ void AudioClockPLL::update(const PacketTimingInfo& timing, uint64_t currentHostT
             lastSYT_FWTimestamp_ = timing.fwTimestamp;
             lastSYT_AbsSampleIndex_ = timing.firstAbsSampleIndex;
             lastSYT_HostTimeAbs_ = currentHostTimeAbs; // Anchor to current host time
+            publishClock();
 
         } // else log trace (no samples or rate 0)
     } // else log trace (no valid consecutive SYT)
@@ -253,6 +280,10 @@ uint64_t AudioClockPLL::getPresentationTimeNs(uint64_t absoluteSampleIndex) {
     return estimatedHostTimeNano;
 }
 
+uint64_t AudioClockPLL::getPresentationHostTime(uint64_t absoluteSampleIndex) {
+    return nanoseconds_to_absolute(getPresentationTimeNs(absoluteSampleIndex));
+}
+
 // Helper: Convert absolute time to nanoseconds
 uint64_t AudioClockPLL::absolute_to_nanoseconds(uint64_t mach_time) const {
     if (timebaseInfo_.denom == 0) return 0;
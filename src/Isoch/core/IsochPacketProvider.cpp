@@ -5,16 +5,22 @@
 #include <spdlog/spdlog.h>
 // Include header with AM824 constants if needed
 #include "Isoch/core/TransmitterTypes.hpp" // Assuming constants are here
+#include "Isoch/utils/AM824Encoder.hpp"
 
 namespace FWA {
 namespace Isoch {
 
 // --- UPDATED Constructor ---
-IsochPacketProvider::IsochPacketProvider(std::shared_ptr<spdlog::logger> logger, size_t ringBufferSize)
+IsochPacketProvider::IsochPacketProvider(std::shared_ptr<spdlog::logger> logger, size_t ringBufferSize,
+                                         const AmdtpStreamFormat& format)
     : logger_(std::move(logger)),
-      audioBuffer_(ringBufferSize, logger_) // Initialize OWN buffer
+      audioBuffer_(ringBufferSize, logger_), // Initialize OWN buffer
+      latency_(AdaptiveLatencyConfig{audioBuffer_.capacity()}),
+      format_(format),
+      midi_(format.midiSlots, format.sampleRate)
 {
-    if(logger_) logger_->debug("IsochPacketProvider created with RingBuffer size {}", ringBufferSize);
+    if(logger_) logger_->debug("IsochPacketProvider created with RingBuffer size {}, {} channels, DBS {}",
+                               ringBufferSize, format_.audioChannels, format_.dataBlockSize());
     reset();
 }
 
@@ -24,6 +30,8 @@ IsochPacketProvider::~IsochPacketProvider() {
 
 void IsochPacketProvider::reset() {
     audioBuffer_.reset(); // Reset OWN buffer
+    midi_.reset();
+    latency_.reset();
     isInitialized_ = false;
     underrunCount_ = 0;
     totalPushedBytes_ = 0;
@@ -32,46 +40,64 @@ void IsochPacketProvider::reset() {
      if(logger_) logger_->info("IsochPacketProvider reset");
 }
 
-// --- ADDED Implementation for pushAudioData ---
+// --- pushAudioData: legacy entry point, interleaved int32 ---
 bool IsochPacketProvider::pushAudioData(const void* buffer, size_t bufferSizeInBytes) {
+    return pushAudioData(buffer, bufferSizeInBytes, AM824InputFormat::Int32);
+}
+
+// --- pushAudioData: any input format, encoded to AM824 on the way into the ring ---
+bool IsochPacketProvider::pushAudioData(const void* buffer, size_t bufferSizeInBytes, AM824InputFormat format) {
     if (!buffer || bufferSizeInBytes == 0) return false;
 
-    constexpr size_t sampleSize = sizeof(int32_t); // Assuming 32-bit host PCM
+    const size_t sampleSize = AM824::bytesPerSample(format);
     if (bufferSizeInBytes % sampleSize != 0) {
         if(logger_) logger_->warn("pushAudioData: Received data size {} not multiple of sample size {}. Ignoring.", bufferSizeInBytes, sampleSize);
         return false;
     }
 
-    // Write to OWN ring buffer
-    size_t written = audioBuffer_.write(bufferSizeInBytes, buffer);
-    totalPushedBytes_ += written;
+    // One quadlet per sample in the ring, whatever the input width
+    const size_t samples = bufferSizeInBytes / sampleSize;
+    const size_t ringBytes = samples * sizeof(uint32_t);
+    const auto regions = ringBytes <= UINT32_MAX ? audioBuffer_.reserve_write(static_cast<uint32_t>(ringBytes))
+                                                 : decltype(audioBuffer_.reserve_write(0)){};
 
-    if (written < bufferSizeInBytes) {
+    if (!regions) {
          overflowWriteAttempts_++;
          // Log periodically
          static auto lastWarnTime = std::chrono::steady_clock::now();
          auto now = std::chrono::steady_clock::now();
          if (now - lastWarnTime > std::chrono::seconds(1)) {
               if(logger_) logger_->warn("[pushAudioData] Ring buffer full, couldn't write {} bytes. Available space: {}. Attempts: {}",
-                          bufferSizeInBytes, audioBuffer_.write_space(), overflowWriteAttempts_.load());
+                          ringBytes, audioBuffer_.write_space(), overflowWriteAttempts_.load());
              lastWarnTime = now;
          }
-         return false; // Indicate not all data was accepted
+         return false; // Nothing was accepted
     }
 
-    // Check if initial fill target is met
-    if (!isInitialized_) {
-        size_t fillTargetBytes = (audioBuffer_.capacity() * INITIAL_FILL_TARGET_PERCENT) / 100;
-        if (audioBuffer_.read_space() >= fillTargetBytes) {
-            isInitialized_ = true;
-             if(logger_) logger_->info("IsochPacketProvider: Ring buffer initial fill target reached ({} bytes). Ready for streaming.", audioBuffer_.read_space());
-        }
-    }
+    // Encode straight into ring memory; ring offsets and sizes are always whole quadlets
+    const auto* src = static_cast<const uint8_t*>(buffer);
+    const size_t firstSamples = regions.first.size / sizeof(uint32_t);
+    AM824::encode(format, src, firstSamples, reinterpret_cast<uint32_t*>(regions.first.data));
+    AM824::encode(format, src + firstSamples * sampleSize, samples - firstSamples,
+                  reinterpret_cast<uint32_t*>(regions.second.data));
+    audioBuffer_.commit_write(regions.size());
+    totalPushedBytes_ += ringBytes;
     return true;
 }
-// --- END pushAudioData ---
 
 
+
+// --- pushMidiData: bytes for one MIDI port, sent in its MPX-MIDI slot at the MIDI wire rate ---
+bool IsochPacketProvider::pushMidiData(uint32_t port, const uint8_t* bytes, size_t count) {
+    return midi_.push(port, bytes, count);
+}
+
+// MIDI slots of every data block in the packet; silence and priming packets carry MIDI too
+void IsochPacketProvider::fillMidiSlots(uint8_t* targetBuffer, size_t frames, const TransmitPacketInfo& info) {
+    midi_.fill(reinterpret_cast<uint32_t*>(targetBuffer), frames, format_.dataBlockSize(),
+               format_.audioChannels, info.dataBlockCounter);
+}
+
 // --- fillPacketData implementation (mostly unchanged, reads from own buffer) ---
 PreparedPacketData IsochPacketProvider::fillPacketData(
     uint8_t* targetBuffer,
@@ -86,43 +112,61 @@ PreparedPacketData IsochPacketProvider::fillPacketData(
     result.dataLength = 0;
     result.generatedSilence = true;
 
-    if (!targetBuffer || targetBufferSize == 0 || (targetBufferSize % sizeof(int32_t) != 0)) {
-         if(logger_) logger_->error("fillPacketData: Invalid target buffer, size ({}), or size not multiple of 4.", targetBufferSize);
+    const size_t blockBytes = format_.bytesPerDataBlock();
+    if (!targetBuffer || targetBufferSize == 0 || blockBytes == 0 || (targetBufferSize % blockBytes != 0)) {
+         if(logger_) logger_->error("fillPacketData: Invalid target buffer, size ({}), or size not a multiple of {}.", targetBufferSize, blockBytes);
          return result;
     }
+    // Ring bytes behind one packet: whole frames of audio only (MIDI slots come from midi_)
+    const size_t frames = targetBufferSize / blockBytes;
+    const size_t audioBytes = frames * format_.audioChannels * sizeof(uint32_t);
 
     // --- Check available space in OWN buffer ---
-    size_t availableBeforeRead = audioBuffer_.read_space();
+    uint32_t availableBeforeRead = audioBuffer_.read_space();
     if(logger_) logger_->trace("  Available read space before pull: {} bytes", availableBeforeRead);
 
-    // --- Read data from OWN buffer ---
-    size_t bytesRead = audioBuffer_.read(targetBufferSize, targetBuffer);
-
-    if (bytesRead == targetBufferSize) {
-        // --- SUCCESSFUL READ - FORMAT IN PLACE ---
-//        if(logger_) logger_->debug("  Successfully pulled {} bytes. Formatting to AM824...", bytesRead);
+    // --- Latency control: (re)prime to the adaptive target, trim after it was lowered ---
+    if (!isInitialized_) {
+        if (availableBeforeRead < latency_.target()) {
+            bzero(targetBuffer, targetBufferSize);
+            fillMidiSlots(targetBuffer, frames, info);
+            result.dataLength = targetBufferSize;
+            return result;
+        }
+        isInitialized_ = true;
+        if(logger_) logger_->info("IsochPacketProvider: Ring buffer fill target reached ({} of {} bytes). Streaming.", availableBeforeRead, latency_.target());
+    }
+    latency_.observe(availableBeforeRead);
+    if (uint32_t trim = latency_.trimAmount(availableBeforeRead)) {
+        trim -= trim % audioBytes; // whole packets keep the frame alignment
+        if (trim > 0) {
+            audioBuffer_.skip(trim);
+            if(logger_) logger_->info("IsochPacketProvider: latency target lowered to {} bytes, dropped {} bytes", latency_.target(), trim);
+        }
+    }
 
-        int32_t* samplesPtr = reinterpret_cast<int32_t*>(targetBuffer);
-        size_t numSamples = targetBufferSize / sizeof(int32_t);
+    // --- Copy the already encoded quadlets from ring memory into the DCL payload ---
+    const auto regions = audioBuffer_.reserve_read(static_cast<uint32_t>(audioBytes));
 
-        // Perform the AM824 conversion and Big Endian swap IN PLACE
-        for (size_t i = 0; i < numSamples; ++i) {
-            int32_t sample = samplesPtr[i];
-            sample &= 0x00FFFFFF;
-            uint32_t am824Sample = (AM824_LABEL << LABEL_SHIFT) | sample; // Assumes constants defined
-            samplesPtr[i] = OSSwapHostToBigInt32(am824Sample);
-        }
-         if(logger_) logger_->trace("  AM824 formatting complete.");
+    if (regions) {
+        uint32_t* dst = reinterpret_cast<uint32_t*>(targetBuffer);
+        std::memcpy(dst, regions.first.data, regions.first.size);
+        if (regions.second.size) std::memcpy(targetBuffer + regions.first.size, regions.second.data, regions.second.size);
+        AM824::spreadDataBlocks(dst, frames, format_.audioChannels, format_.dataBlockSize());
+        fillMidiSlots(targetBuffer, frames, info);
+        audioBuffer_.commit_read(regions.size());
+        if(logger_) logger_->trace("  AM824 formatting complete.");
 
         result.generatedSilence = false;
-        result.dataLength = bytesRead;
-        totalPulledBytes_ += bytesRead; // Track pulled bytes
+        result.dataLength = targetBufferSize;
+        totalPulledBytes_ += audioBytes; // Track pulled bytes
 
     } else {
         // --- UNDERRUN ---
 //        if(logger_) logger_->warn("  UNDERRUN: Requested {}, pulled only {}. Available was {}.", targetBufferSize, bytesRead, availableBeforeRead);
         handleUnderrun(info);
         bzero(targetBuffer, targetBufferSize);
+        fillMidiSlots(targetBuffer, frames, info);
         result.generatedSilence = true;
         result.dataLength = targetBufferSize;
     }
@@ -132,14 +176,15 @@ PreparedPacketData IsochPacketProvider::fillPacketData(
 
 // --- isReadyForStreaming and handleUnderrun remain the same ---
 bool IsochPacketProvider::isReadyForStreaming() const {
-    // Check OWN buffer
-    size_t fillTargetBytes = (audioBuffer_.capacity() * INITIAL_FILL_TARGET_PERCENT) / 100;
-    return audioBuffer_.read_space() >= fillTargetBytes;
-    // return isInitialized_.load(); // Or use the flag if preferred
+    // Check OWN buffer against the current adaptive target
+    return isInitialized_.load() || audioBuffer_.read_space() >= latency_.target();
 }
 
 void IsochPacketProvider::handleUnderrun(const TransmitPacketInfo& info) {
     underrunCount_++;
+    // Grow the target and re-prime to it instead of limping along at the edge of the buffer
+    latency_.noteUnderrun();
+    isInitialized_ = false;
     if (underrunCount_ % 100 == 1) {
          if(logger_) logger_->warn("IsochPacketProvider: Buffer underrun detected at Seg={}, Pkt={}, AbsPkt={}. Total Count={}",
                                   info.segmentIndex, info.packetIndexInGroup, info.absolutePacketIndex, underrunCount_.load());
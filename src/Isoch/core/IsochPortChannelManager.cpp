@@ -391,8 +391,8 @@ std::expected<void, IOKitError> IsochPortChannelManager::createIsochChannel() {
         return std::unexpected(IOKitError::NotReady);
     }
     
-    // Calculate packet size for IRM allocations - this should be determined based on audio needs
-    const uint32_t irmPacketSize = 72; // 64 bytes for samples + 8 bytes for CIP header
+    // Packet size for IRM allocations, set from the stream format by the owner
+    const uint32_t irmPacketSize = irmPacketSize_;
     
     // Create the isoch channel
     isochChannel_ = (*interface_)->CreateIsochChannel(
@@ -2,6 +2,7 @@
 #include "Isoch/core/TransmitterTypes.hpp" // Include for kTransmitCIPHeaderSize and kTransmitIsochHeaderSize constants
 #include <mach/mach.h>
 #include <cstring> // For bzero
+#include <new> // For std::bad_alloc
 
 namespace FWA {
 namespace Isoch {
@@ -32,6 +33,7 @@ void IsochTransmitBufferManager::cleanup() noexcept {
         timestampArea_ = nullptr;
         totalBufferSize_ = 0;
         bufferRange_ = {};
+        packets_.clear();
         if (logger_) logger_->debug("IsochTransmitBufferManager::cleanup: Released buffer");
     }
 }
@@ -39,20 +41,18 @@ void IsochTransmitBufferManager::cleanup() noexcept {
 void IsochTransmitBufferManager::calculateBufferLayout() {
     totalPackets_ = config_.numGroups * config_.packetsPerGroup;
 
-    // --- MODIFICATION START ---
-    // Explicitly set audio payload size. For AM824 Stereo, DBS=2 (8 bytes/frame).
-    // Assuming 8 frames per packet for a 64-byte payload, consistent with receiver/legacy.
-    // This calculation might become dynamic based on config_.sampleRate and format later.
-    const size_t framesPerPacket = 8; // Based on common practice / legacy UniversalTransmitter
-    const size_t bytesPerFrameStereoAM824 = 8; // 2 channels * 4 bytes/sample (incl. label)
-    audioPayloadSizePerPacket_ = framesPerPacket * bytesPerFrameStereoAM824; // Should be 64 bytes
+    // Payload per packet follows the stream format: SYT_INTERVAL data blocks of DBS quadlets
+    const AmdtpStreamFormat format = config_.streamFormat();
+    audioPayloadSizePerPacket_ = format.payloadBytes(); // 64 bytes for stereo at 44.1/48kHz
 
     if (logger_) {
          logger_->debug("Buffer layout calculated for SampleRate={:.1f}Hz", config_.sampleRate);
-         logger_->debug("  Assumed FramesPerPacket={}, BytesPerFrame={}, Resulting PayloadSize={}",
-                        framesPerPacket, bytesPerFrameStereoAM824, audioPayloadSizePerPacket_);
+         logger_->debug("  DBS={} ({} audio + {} MIDI), FramesPerPacket={}, PayloadSize={}",
+                        format.dataBlockSize(), format.audioChannels, format.midiSlots,
+                        format.framesPerPacket(), audioPayloadSizePerPacket_);
     }
-     // --- MODIFICATION END ---
+    // Packets index the client area modulo its size, so only whole packets of it are usable
+    clientBufferUsableSize_ = config_.clientBufferSize - config_.clientBufferSize % audioPayloadSizePerPacket_;
 
     // --- Sizes calculation (NO CHANGE needed here, uses config/constants) ---
     size_t clientDataSize = config_.clientBufferSize;
@@ -90,8 +90,18 @@ std::expected<void, IOKitError> IsochTransmitBufferManager::setupBuffers(const T
         if (logger_) logger_->error("IsochTransmitBufferManager: Invalid config (zeros)");
         return std::unexpected(IOKitError::BadArgument);
     }
+    if (!config_.streamFormat().isValid()) {
+        if (logger_) logger_->error("IsochTransmitBufferManager: Invalid stream format ({} audio + {} MIDI slots at {:.1f}Hz)",
+                                    config_.numChannels, config_.midiSlots, config_.sampleRate);
+        return std::unexpected(IOKitError::BadArgument);
+    }
 
     calculateBufferLayout();
+    if (clientBufferUsableSize_ == 0) {
+        if (logger_) logger_->error("IsochTransmitBufferManager: client buffer ({} bytes) smaller than one packet ({} bytes)",
+                                    config_.clientBufferSize, audioPayloadSizePerPacket_);
+        return std::unexpected(IOKitError::BadArgument);
+    }
 
     vm_address_t buffer = 0;
     kern_return_t result = vm_allocate(mach_task_self(), &buffer, totalBufferSize_, VM_FLAGS_ANYWHERE);
@@ -112,6 +122,14 @@ std::expected<void, IOKitError> IsochTransmitBufferManager::setupBuffers(const T
     bufferRange_.address = reinterpret_cast<IOVirtualAddress>(mainBuffer_);
     bufferRange_.length = totalBufferSize_;
 
+    try {
+        buildPacketDescriptors();
+    } catch (const std::bad_alloc&) {
+        if (logger_) logger_->error("IsochTransmitBufferManager: Failed to allocate {} packet descriptors", totalPackets_);
+        cleanup();
+        return std::unexpected(IOKitError::NoMemory);
+    }
+
     if (logger_) {
         logger_->info("IsochTransmitBufferManager::setupBuffers: Allocated buffer at {:p} size {}", (void*)mainBuffer_, totalBufferSize_);
         logger_->debug("  Client audio area: {:p}", (void*)clientAudioArea_);
@@ -123,6 +141,23 @@ std::expected<void, IOKitError> IsochTransmitBufferManager::setupBuffers(const T
     return {};
 }
 
+void IsochTransmitBufferManager::buildPacketDescriptors() {
+    packets_.assign(totalPackets_, TransmitPacketDescriptor{});
+    for (uint32_t i = 0; i < totalPackets_; ++i) {
+        TransmitPacketDescriptor& d = packets_[i];
+        d.payload = clientAudioArea_ + (size_t(i) * audioPayloadSizePerPacket_) % clientBufferUsableSize_;
+        d.cipHeader = reinterpret_cast<CIPHeader*>(cipHeaderArea_ + size_t(i) * kTransmitCIPHeaderSize);
+        d.isochHeader = reinterpret_cast<IsochHeaderData*>(isochHeaderArea_ + size_t(i) * kTransmitIsochHeaderSize);
+    }
+}
+
+void IsochTransmitBufferManager::bindPacketDCL(uint32_t packetIndex, NuDCLSendPacketRef dcl) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (packetIndex < packets_.size()) {
+        packets_[packetIndex].dcl = dcl;
+    }
+}
+
 // Implement Getters (with basic checks)
 std::expected<uint8_t*, IOKitError> IsochTransmitBufferManager::getPacketIsochHeaderPtr(uint32_t g, uint32_t p) const {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -155,7 +190,7 @@ uint8_t* IsochTransmitBufferManager::getClientAudioBufferPtr() const {
 }
 
 size_t IsochTransmitBufferManager::getClientAudioBufferSize() const { 
-    return config_.clientBufferSize;  // Return requested size
+    return clientBufferUsableSize_;  // Requested size rounded down to whole packets
 }
 
 size_t IsochTransmitBufferManager::getAudioPayloadSizePerPacket() const { 
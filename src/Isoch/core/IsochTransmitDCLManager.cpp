@@ -25,6 +25,7 @@ void IsochTransmitDCLManager::reset() {
      // DCLs are owned by the pool, just clear refs
      dclProgramRefs_.clear();
      callbackInfos_.clear();
+     segments_.clear();
       for (CFMutableSetRef bag : updateBags_) {
          if (bag) CFRelease(bag);
      }
@@ -71,6 +72,7 @@ std::expected<DCLCommand*, IOKitError> IsochTransmitDCLManager::createDCLProgram
      try {
         dclProgramRefs_.resize(totalPackets);
         callbackInfos_.resize(config_.numGroups);
+        segments_.build(config_.numGroups, config_.packetsPerGroup);
         // updateBags_.resize(config_.numGroups); // Not using update bags for now
      } catch (const std::bad_alloc& e) {
          logger_->error("Failed to allocate internal DCL storage: {}", e.what());
@@ -79,6 +81,7 @@ std::expected<DCLCommand*, IOKitError> IsochTransmitDCLManager::createDCLProgram
      }
 
      NuDCLSendPacketRef previousDCL = nullptr;
+     const AmdtpStreamFormat streamFormat = config_.streamFormat();
 
      // --- DCL Allocation Loop ---
      for (uint32_t g = 0; g < config_.numGroups; ++g) {
@@ -116,11 +119,7 @@ std::expected<DCLCommand*, IOKitError> IsochTransmitDCLManager::createDCLProgram
              isochHdr->tcode_sy = (0xA << 4) | 0; // TCode=A, Sy=0
 
              // CIP Header (Initial safe state: NO_DATA)
-             CIPHeader* cipHdr = reinterpret_cast<CIPHeader*>(cipHdrPtr);
-             bzero(cipHdr, kTransmitCIPHeaderSize);
-             cipHdr->fmt_eoh1 = (0x10 << 2) | 0x01; // FMT=0x10 (AM824), EOH=1
-             cipHdr->fdf = 0xFF; // NO_DATA
-             cipHdr->syt = OSSwapHostToBigInt16(0xFFFF); // NO_INFO
+             streamFormat.writeCIPHeader(cipHdrPtr, 0, 0, AmdtpStreamFormat::kFdfNoData, 0xFFFF); // NO_DATA, NO_INFO
 
              // Audio Payload (Zero it out initially)
              // bzero(audioDataPtr, audioPayloadSize); // Provider should handle initial silence
@@ -151,6 +150,7 @@ std::expected<DCLCommand*, IOKitError> IsochTransmitDCLManager::createDCLProgram
                  return std::unexpected(IOKitError::NoMemory);
              }
              dclProgramRefs_[globalPacketIdx] = currentDCL; // Store the reference
+             segments_.setDCL(globalPacketIdx, currentDCL, ranges, numRanges);
 
              // --- 5. Configure the Allocated DCL ---
              UInt32 dclFlags = kNuDCLDynamic |         // DCL might change (ranges, branch)
@@ -201,6 +201,11 @@ std::expected<DCLCommand*, IOKitError> IsochTransmitDCLManager::createDCLProgram
      // --- 9. Get Program Handle ---
      // The handle is needed for CreateLocalIsochPort
      DCLCommand* programHandle = (*nuDCLPool_)->GetProgram(nuDCLPool_);
+     if (!segments_.isComplete()) {
+        logger_->error("createDCLProgram: segment table is missing DCLs");
+        reset();
+        return std::unexpected(IOKitError::Error);
+     }
      if (!programHandle) {
         logger_->error("GetProgram returned null after creating DCLs");
         reset();
@@ -289,10 +294,10 @@ std::expected<void, IOKitError> IsochTransmitDCLManager::updateDCLPacket(
 
      // Update the ranges (data source pointers and lengths)
      // This is the most common update needed.
-     IOReturn result = (*nuDCLPool_)->SetDCLRanges(dclRef, numRanges, (::IOVirtualRange*)ranges);
-     if (result != kIOReturnSuccess) {
-         logger_->error("SetDCLRanges failed for G={}, P={}: 0x{:08X}", groupIndex, packetIndexInGroup, result);
-         return std::unexpected(IOKitError(result));
+     const uint32_t packetIndex = groupIndex * config_.packetsPerGroup + packetIndexInGroup;
+     if (auto result = setDCLRanges(packetIndex, dclRef, ranges, numRanges); !result) {
+         logger_->error("updateDCLPacket: SetDCLRanges failed for G={}, P={}", groupIndex, packetIndexInGroup);
+         return result;
      }
      
      // Update Isoch Header Template Content (if template itself changes, rarely needed)
@@ -309,6 +314,28 @@ std::expected<void, IOKitError> IsochTransmitDCLManager::updateDCLPacket(
      return {};
 }
 
+std::expected<void, IOKitError> IsochTransmitDCLManager::setDCLRanges(
+    uint32_t packetIndex,
+    NuDCLSendPacketRef dcl,
+    const IOVirtualRange ranges[],
+    uint32_t numRanges)
+{
+     if (!nuDCLPool_ || !dcl) return std::unexpected(IOKitError::NotReady);
+     if (packetIndex >= segments_.packetCount()) return std::unexpected(IOKitError::BadArgument);
+
+     // Same ranges as on the previous lap of the ring: the DCL already points there
+     if (segments_.isUnchanged(packetIndex, ranges, numRanges)) return {};
+
+     IOReturn result = (*nuDCLPool_)->SetDCLRanges(dcl, numRanges, (::IOVirtualRange*)ranges);
+     if (result != kIOReturnSuccess) {
+         segments_.invalidate(packetIndex);
+         logger_->error("SetDCLRanges failed: 0x{:08X}", result);
+         return std::unexpected(IOKitError(result));
+     }
+     segments_.remember(packetIndex, ranges, numRanges);
+     return {};
+}
+
 std::expected<void, IOKitError> IsochTransmitDCLManager::notifySegmentUpdate(
      IOFireWireLibLocalIsochPortRef localPort, uint32_t groupIndexToNotify)
 {
@@ -317,27 +344,12 @@ std::expected<void, IOKitError> IsochTransmitDCLManager::notifySegmentUpdate(
      if (!localPort) return std::unexpected(IOKitError::BadArgument);
      if (groupIndexToNotify >= config_.numGroups) return std::unexpected(IOKitError::BadArgument);
 
-     // Prepare the list of DCLs in the segment to notify
-     uint32_t startIndex = groupIndexToNotify * config_.packetsPerGroup;
-     uint32_t count = config_.packetsPerGroup;
-     std::vector<NuDCLRef> dclsInSegment;
-     dclsInSegment.reserve(count);
-     for (uint32_t i = 0; i < count; ++i) {
-          if (startIndex + i < dclProgramRefs_.size()) {
-              dclsInSegment.push_back(dclProgramRefs_[startIndex + i]);
-          } else {
-               logger_->error("notifySegmentUpdate: Calculated index out of bounds!");
-               return std::unexpected(IOKitError::BadArgument); // Should not happen
-          }
-     }
-
-     if (dclsInSegment.empty()) {
-          logger_->warn("notifySegmentUpdate: No DCLs found for group {}", groupIndexToNotify);
-          return {}; // Not an error, but nothing to do
-     }
+     // The segment's DCLs were laid out contiguously when the program was created, so the
+     // list Notify wants already exists; nothing is built (or allocated) per callback
+     void** dclsInSegment = segments_.segment(groupIndexToNotify);
 
      // Call the helper to notify
-     IOReturn result = notifyDCLUpdates(localPort, dclsInSegment.data(), dclsInSegment.size());
+     IOReturn result = notifyDCLUpdates(localPort, dclsInSegment, segments_.segmentSize());
      if (result != kIOReturnSuccess) {
           logger_->error("notifyDCLUpdates failed for group {}: 0x{:08X}", groupIndexToNotify, result);
           return std::unexpected(IOKitError(result));
@@ -383,8 +395,6 @@ void IsochTransmitDCLManager::handleDCLOverrun(NuDCLRef dcl) {
     }
 }
 
-// --- Private Helpers ---
-// Remove const qualifier to match header declaration
 NuDCLSendPacketRef IsochTransmitDCLManager::getDCLRef(uint32_t g, uint32_t p) {
      // Remove the lock - read access is safe once program is created
      if (!dclProgramCreated_ || dclProgramRefs_.empty()) return nullptr;
@@ -393,27 +403,16 @@ NuDCLSendPacketRef IsochTransmitDCLManager::getDCLRef(uint32_t g, uint32_t p) {
      return dclProgramRefs_[index];
 }
 
-IOReturn IsochTransmitDCLManager::notifyDCLUpdates(IOFireWireLibLocalIsochPortRef localPort, NuDCLRef dcls[], uint32_t count) {
+// --- Private Helpers ---
+IOReturn IsochTransmitDCLManager::notifyDCLUpdates(IOFireWireLibLocalIsochPortRef localPort, void* dcls[], uint32_t count) {
+     // dcls holds the DCLRefs themselves (not their addresses); createDCLProgram has
+     // already checked that none of them is NULL
      if (!localPort || !dcls || count == 0) return kIOReturnBadArgument;
-     
-     // Need to pass array of DCLRefs cast to void*
-     std::vector<void*> dclPtrList(count);
-     for(uint32_t i = 0; i < count; ++i) {
-         // --- FIX: Cast the DCLRef *itself* to void*, not its address ---
-         dclPtrList[i] = static_cast<void*>(dcls[i]);    // Correct
-         
-         // Add a check for NULL DCLs just in case
-         if (dclPtrList[i] == nullptr) {
-             logger_->error("notifyDCLUpdates: Encountered NULL DCLRef at index {}", i);
-             return kIOReturnBadArgument; // Safer to return error
-         }
-     }
 
-     // Call Notify with the array of DCLRefs cast to void*
      return (*localPort)->Notify(
          localPort,
          kFWNuDCLModifyNotification,  // For content/range updates
-         dclPtrList.data(),           // Array of pointers to DCLRefs
+         dcls,
          count);
 }
 IOReturn IsochTransmitDCLManager::notifyJumpUpdate(IOFireWireLibLocalIsochPortRef localPort, NuDCLRef* dclRefPtr) {
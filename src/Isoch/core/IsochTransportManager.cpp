@@ -137,6 +137,37 @@ std::expected<void, IOKitError> IsochTransportManager::stop(IOFireWireLibIsochCh
     return {};
 }
 
+std::expected<void, IOKitError> IsochTransportManager::restart(IOFireWireLibIsochChannelRef channel) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+
+    if (state_ != State::Running) {
+        if (logger_) {
+            logger_->error("IsochTransportManager::restart: Invalid state: {}",
+                         static_cast<int>(state_.load()));
+        }
+        return std::unexpected(IOKitError::NotReady);
+    }
+
+    // Stop/Start only: no ReleaseChannel/AllocateChannel, so nothing is given up
+    IOReturn ret = (*channel)->Stop(channel);
+    if (ret != kIOReturnSuccess && logger_) {
+        logger_->warn("IsochTransportManager::restart: Failed to stop channel: 0x{:08X}", ret);
+    }
+
+    ret = (*channel)->Start(channel);
+    if (ret != kIOReturnSuccess) {
+        if (logger_) {
+            logger_->error("IsochTransportManager::restart: Failed to start channel: 0x{:08X}", ret);
+        }
+        return std::unexpected(IOKitError(ret));
+    }
+
+    if (logger_) {
+        logger_->info("IsochTransportManager::restart: Transport restarted");
+    }
+    return {};
+}
+
 void IsochTransportManager::handleFinalize() {
     if (logger_) {
         logger_->debug("IsochTransportManager::handleFinalize called");
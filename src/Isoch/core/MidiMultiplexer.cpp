@@ -0,0 +1,66 @@
+#include "Isoch/core/MidiMultiplexer.hpp"
+#include "Isoch/utils/AM824Encoder.hpp"
+
+namespace FWA {
+namespace Isoch {
+
+namespace {
+constexpr uint32_t kOneByteLabel = AM824::kMidiLabel + 1;
+
+// Slot quadlet as it goes on the wire: label, then the byte in the first of three data bytes
+uint32_t midiQuadlet(uint32_t label, uint8_t byte = 0) {
+    return __builtin_bswap32((label << 24) | (uint32_t(byte) << 16));
+}
+} // namespace
+
+MidiMultiplexer::MidiMultiplexer(uint32_t midiSlots, uint32_t sampleRate, uint32_t queueBytes)
+    : midiSlots_(midiSlots),
+      ticksPerByte_(sampleRate)
+{
+    ports_.reserve(size_t(midiSlots) * kPortsPerSlot);
+    for (uint32_t p = 0; p < midiSlots * kPortsPerSlot; ++p) ports_.push_back(std::make_unique<Port>(queueBytes));
+}
+
+bool MidiMultiplexer::push(uint32_t port, const uint8_t* bytes, size_t count) {
+    if (port >= ports_.size() || !bytes || count == 0 || count > UINT32_MAX) return false;
+    return ports_[port]->queue.write(static_cast<uint32_t>(count), bytes) == count;
+}
+
+size_t MidiMultiplexer::queued(uint32_t port) const {
+    return port < ports_.size() ? ports_[port]->queue.read_space() : 0;
+}
+
+void MidiMultiplexer::fill(uint32_t* blocks, size_t frames, uint32_t dbs, uint32_t firstSlot, uint8_t dbc) {
+    if (midiSlots_ == 0 || firstSlot + midiSlots_ > dbs) return;
+
+    const uint32_t empty = midiQuadlet(AM824::kMidiLabel);
+    for (size_t f = 0; f < frames; ++f, clock_ += kBytesPerSecond) {
+        uint32_t* slot = blocks + f * dbs + firstSlot;
+        const uint32_t lane = uint8_t(dbc + f) % kPortsPerSlot;
+        for (uint32_t s = 0; s < midiSlots_; ++s) {
+            Port& port = *ports_[s * kPortsPerSlot + lane];
+            uint8_t byte;
+            if (clock_ < port.nextByteAt) {
+                slot[s] = empty;
+            } else if (port.queue.read(1, &byte)) {
+                // Due time advances by exactly one byte, so a saturated port averages the wire rate
+                port.nextByteAt += ticksPerByte_;
+                slot[s] = midiQuadlet(kOneByteLabel, byte);
+            } else {
+                port.nextByteAt = clock_;
+                slot[s] = empty;
+            }
+        }
+    }
+}
+
+void MidiMultiplexer::reset() {
+    for (auto& port : ports_) {
+        port->queue.reset();
+        port->nextByteAt = 0;
+    }
+    clock_ = 0;
+}
+
+} // namespace Isoch
+} // namespace FWA
@@ -0,0 +1,32 @@
+#include "Isoch/core/PacketTimeInterpolator.hpp"
+#include "Isoch/core/AmdtpTimingGenerator.hpp"
+
+namespace FWA {
+namespace Isoch {
+
+void PacketTimeInterpolator::anchor(uint32_t cycleTime, uint64_t hostNano) {
+    anchorCycle_ = AmdtpTimingGenerator::cycleIndex(cycleTime);
+    anchorOffset_ = (cycleTime & 0xFFF) % AmdtpTimingGenerator::kTicksPerCycle;
+    anchorHost_ = hostNano;
+    anchored_ = true;
+}
+
+PacketTime PacketTimeInterpolator::at(uint32_t cycle) const {
+    if (!anchored_) return {};
+
+    constexpr int64_t kWrap = AmdtpTimingGenerator::kCyclesPerWrap;
+    constexpr int64_t kTicks = AmdtpTimingGenerator::kTicksPerCycle;
+
+    // Cycles from the anchor to the packet, the short way round the wrap
+    int64_t cycles = (int64_t(cycle % kWrap) - int64_t(anchorCycle_) + kWrap) % kWrap;
+    if (cycles >= kWrap / 2) cycles -= kWrap;
+
+    // The packet's cycle starts at offset 0; the anchor was read anchorOffset_ ticks into its cycle
+    const int64_t ticks = cycles * kTicks - int64_t(anchorOffset_);
+    const int64_t nanos = ticks * int64_t(kNanosPerCycle) / kTicks;
+
+    return { uint64_t(int64_t(anchorHost_) + nanos), cycleTimeOf(uint32_t(cycle % kWrap)) };
+}
+
+} // namespace Isoch
+} // namespace FWA
@@ -0,0 +1,147 @@
+#include "Isoch/core/ShmPacketProvider.hpp"
+#include <CoreServices/CoreServices.h> // For endian swap
+#include <cstring> // For bzero
+#include "Isoch/utils/AM824Encoder.hpp"
+
+namespace FWA {
+namespace Isoch {
+
+ShmPacketProvider::ShmPacketProvider(std::shared_ptr<spdlog::logger> logger,
+                                     RTShmRing::RingView ring,
+                                     const AmdtpStreamFormat& format)
+    : logger_(std::move(logger)),
+      ring_(ring),
+      numChannels_(format.audioChannels),
+      blockQuadlets_(format.dataBlockSize()),
+      ringChannels_(ring ? ring.control->channels : 0),
+      latency_(AdaptiveLatencyConfig{ring ? ring.control->capacityFrames : 0})
+{
+    // The driver publishes 24-bit PCM in 32-bit containers, same as IsochPacketProvider expects.
+    formatSupported_ = ring_ && ring_.control->bytesPerSample == sizeof(int32_t) && numChannels_ > 0;
+    if (!formatSupported_) {
+        if (logger_) logger_->error("ShmPacketProvider: unsupported ring (valid={}, bytesPerSample={}, channels={}); will send silence",
+                                    static_cast<bool>(ring_), ring_ ? ring_.control->bytesPerSample : 0, numChannels_);
+    } else if (ringChannels_ != numChannels_) {
+        if (logger_) logger_->warn("ShmPacketProvider: ring has {} channels, stream has {}; extra channels are dropped/zeroed",
+                                   ringChannels_, numChannels_);
+    }
+    if (logger_) logger_->debug("ShmPacketProvider created ({} ring frames, {} channels, DBS {})",
+                                ring_ ? ring_.control->capacityFrames : 0, numChannels_, blockQuadlets_);
+}
+
+ShmPacketProvider::~ShmPacketProvider() {
+    if (logger_) logger_->debug("ShmPacketProvider destroyed");
+}
+
+bool ShmPacketProvider::pushAudioData(const void*, size_t) {
+    // Data path is the shared-memory ring; nothing to push.
+    return false;
+}
+
+void ShmPacketProvider::reset() {
+    primed_ = false;
+    latency_.reset();
+    underrunCount_ = 0;
+    totalPulledFrames_ = 0;
+    if (logger_) logger_->info("ShmPacketProvider reset");
+}
+
+bool ShmPacketProvider::isReadyForStreaming() const {
+    if (!formatSupported_) return false;
+    return primed_.load() || RTShmRing::AvailableFrames(ring_) >= latency_.target();
+}
+
+void ShmPacketProvider::encodeFrames(const std::byte* src, uint32_t frames, uint32_t* dst) const {
+    const auto* in = reinterpret_cast<const int32_t*>(src);
+    if (ringChannels_ == numChannels_) {
+        // Same layout on both sides: one vectorised pass over the whole span
+        AM824::encode(AM824InputFormat::Int32, in, size_t(frames) * numChannels_, dst);
+        return;
+    }
+    const uint32_t copyChannels = ringChannels_ < numChannels_ ? ringChannels_ : numChannels_;
+    for (uint32_t f = 0; f < frames; ++f) {
+        AM824::encode(AM824InputFormat::Int32, in, copyChannels, dst);
+        for (uint32_t ch = copyChannels; ch < numChannels_; ++ch) {
+            dst[ch] = OSSwapHostToBigInt32(AM824_LABEL << LABEL_SHIFT);
+        }
+        in += ringChannels_;
+        dst += numChannels_;
+    }
+}
+
+PreparedPacketData ShmPacketProvider::fillPacketData(
+    uint8_t* targetBuffer,
+    size_t targetBufferSize,
+    const TransmitPacketInfo& info)
+{
+    PreparedPacketData result;
+    result.dataPtr = targetBuffer;
+    result.dataLength = 0;
+    result.generatedSilence = true;
+
+    const size_t blockBytes = size_t(blockQuadlets_) * sizeof(uint32_t);
+    if (!targetBuffer || targetBufferSize == 0 || blockBytes == 0 || (targetBufferSize % blockBytes) != 0) {
+        if (logger_) logger_->error("fillPacketData: Invalid target buffer, size ({}), or size not a multiple of {}.", targetBufferSize, blockBytes);
+        return result;
+    }
+
+    const uint32_t framesNeeded = static_cast<uint32_t>(targetBufferSize / blockBytes);
+
+    // Latency control: (re)prime to the adaptive target, trim after it was lowered
+    if (formatSupported_) {
+        const uint64_t available = RTShmRing::AvailableFrames(ring_);
+        if (!primed_) {
+            if (available < latency_.target()) {
+                bzero(targetBuffer, targetBufferSize);
+                result.dataLength = targetBufferSize;
+                return result;
+            }
+            primed_ = true;
+            if (logger_) logger_->info("ShmPacketProvider: ring fill target reached ({} of {} frames). Streaming.", available, latency_.target());
+        }
+        latency_.observe(static_cast<uint32_t>(available));
+        if (const uint32_t trim = latency_.trimAmount(static_cast<uint32_t>(available))) {
+            RTShmRing::ConsumeFrames(ring_, trim);
+            if (logger_) logger_->info("ShmPacketProvider: latency target lowered to {} frames, dropped {} frames", latency_.target(), trim);
+        }
+    }
+
+    const RTShmRing::FrameSpans spans = formatSupported_ ? RTShmRing::PeekFrames(ring_, framesNeeded) : RTShmRing::FrameSpans{};
+
+    if (spans.frames() == framesNeeded) {
+        auto* out = reinterpret_cast<uint32_t*>(targetBuffer);
+        encodeFrames(spans.first, spans.firstFrames, out);
+        if (spans.secondFrames) {
+            encodeFrames(spans.second, spans.secondFrames, out + size_t(spans.firstFrames) * numChannels_);
+        }
+        AM824::spreadDataBlocks(out, framesNeeded, numChannels_, blockQuadlets_);
+        RTShmRing::ConsumeFrames(ring_, framesNeeded);
+        totalPulledFrames_ += framesNeeded;
+        result.generatedSilence = false;
+        result.dataAvailable = true;
+        result.dataLength = targetBufferSize;
+    } else {
+        handleUnderrun(info);
+        bzero(targetBuffer, targetBufferSize);
+        result.generatedSilence = true;
+        result.dataLength = targetBufferSize;
+    }
+    return result;
+}
+
+void ShmPacketProvider::handleUnderrun(const TransmitPacketInfo& info) {
+    underrunCount_++;
+    if (formatSupported_) {
+        RTShmRing::UnderrunCountProxy(*ring_.control).fetch_add(1, std::memory_order_relaxed);
+        // Grow the target and re-prime to it
+        latency_.noteUnderrun();
+        primed_ = false;
+    }
+    if (underrunCount_ % 100 == 1) {
+        if (logger_) logger_->warn("ShmPacketProvider: Buffer underrun detected at Seg={}, Pkt={}, AbsPkt={}. Total Count={}",
+                                   info.segmentIndex, info.packetIndexInGroup, info.absolutePacketIndex, underrunCount_.load());
+    }
+}
+
+} // namespace Isoch
+} // namespace FWA
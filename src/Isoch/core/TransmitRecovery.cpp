@@ -0,0 +1,106 @@
+#include "Isoch/core/TransmitRecovery.hpp"
+#include "Isoch/core/AmdtpTimingGenerator.hpp"
+
+#include <algorithm>
+
+namespace FWA {
+namespace Isoch {
+
+namespace {
+constexpr uint32_t kWrap = AmdtpTimingGenerator::kCyclesPerWrap;
+
+// How far cycle index a is ahead of b, across the 128 s wrap
+uint32_t cyclesAfter(uint32_t a, uint32_t b) {
+    return (a + kWrap - b) % kWrap;
+}
+} // namespace
+
+TransmitRecovery::TransmitRecovery(const TransmitRecoveryConfig& config)
+    : config_(config),
+      ringCycles_(std::max(1u, config.numGroups * config.packetsPerGroup))
+{
+    if (config_.numGroups == 0) config_.numGroups = 1;
+    if (config_.callbackGroupInterval == 0) config_.callbackGroupInterval = 1;
+    // Default: the refilled group comes round again ring - group cycles after its completion;
+    // keep one more group of margin for the refill itself
+    const uint32_t defaultLag = ringCycles_ > 2 * config_.packetsPerGroup ? ringCycles_ - 2 * config_.packetsPerGroup
+                                                                          : ringCycles_ / 4;
+    maxLag_ = config_.maxLagCycles ? std::min(config_.maxLagCycles, ringCycles_ - 1) : defaultLag;
+}
+
+void TransmitRecovery::start() {
+    state_ = TransmitStreamState::Starting;
+    expectedGroup_ = 0;
+    recoveries_ = 0;
+    windowStart_ = 0;
+    windowRecoveries_ = 0;
+}
+
+void TransmitRecovery::stop() {
+    state_ = TransmitStreamState::Stopped;
+}
+
+GroupDecision TransmitRecovery::onGroupComplete(uint32_t completedGroup, uint32_t completionCycleTime,
+                                                uint32_t nowCycleTime) {
+    if (state_ == TransmitStreamState::Stopped || state_ == TransmitStreamState::Failed) return {};
+
+    const uint32_t completion = AmdtpTimingGenerator::cycleIndex(completionCycleTime);
+    const uint32_t now = AmdtpTimingGenerator::cycleIndex(nowCycleTime);
+    uint32_t lag = cyclesAfter(now, completion);
+    if (lag > kWrap / 2) lag = 0;   // "now" read before the stamp: no lag
+
+    switch (state_) {
+    case TransmitStreamState::Starting:
+    case TransmitStreamState::Recovering:
+        // The ring holds NO_DATA; completions that are still too late are only drained
+        if (lag > maxLag_) return {};
+        return resync(completedGroup, completion, lag);
+
+    case TransmitStreamState::Running:
+        if (completedGroup != expectedGroup_ || lag > maxLag_) return { beginRecovery(now) };
+        expectedGroup_ = (completedGroup + config_.callbackGroupInterval) % config_.numGroups;
+        return { GroupAction::Fill };
+
+    default:
+        return {};
+    }
+}
+
+GroupAction TransmitRecovery::onOverrun(uint32_t nowCycleTime) {
+    if (state_ == TransmitStreamState::Stopped || state_ == TransmitStreamState::Failed) return GroupAction::Idle;
+    return beginRecovery(AmdtpTimingGenerator::cycleIndex(nowCycleTime));
+}
+
+GroupAction TransmitRecovery::onRenderBacklog(uint32_t nowCycleTime) {
+    // Same as a late callback: the queued groups are stale and timing must be re-anchored
+    return onOverrun(nowCycleTime);
+}
+
+GroupAction TransmitRecovery::beginRecovery(uint32_t nowCycle) {
+    if (windowRecoveries_ == 0 || cyclesAfter(nowCycle, windowStart_) >= config_.recoveryWindowCycles) {
+        windowStart_ = nowCycle;
+        windowRecoveries_ = 0;
+    }
+    if (++windowRecoveries_ > config_.maxRecoveries) {
+        state_ = TransmitStreamState::Failed;
+        return GroupAction::Fail;
+    }
+    ++recoveries_;
+    state_ = TransmitStreamState::Recovering;
+    return GroupAction::Reprime;
+}
+
+GroupDecision TransmitRecovery::resync(uint32_t completedGroup, uint32_t completion, uint32_t lag) {
+    state_ = TransmitStreamState::Running;
+    expectedGroup_ = (completedGroup + config_.callbackGroupInterval) % config_.numGroups;
+
+    // The completed group's last packet went out in the completion cycle, so its first went
+    // out packetsPerGroup - 1 cycles earlier; it goes out again whole rings later, on the
+    // first pass the hardware has not begun by now
+    const uint32_t group = config_.packetsPerGroup;
+    const uint32_t laps = std::max(1u, (lag + group + ringCycles_ - 1) / ringCycles_);
+    return { GroupAction::Resync, (completion + kWrap + 1 - group + laps * ringCycles_) % kWrap };
+}
+
+} // namespace Isoch
+} // namespace FWA
@@ -0,0 +1,163 @@
+#include "Isoch/core/TransmitRenderPipeline.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <pthread.h>
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <mach/mach_time.h>
+#include <mach/thread_policy.h>
+#endif
+
+namespace FWA {
+namespace Isoch {
+
+namespace {
+
+// Best effort: without the privilege (Linux) the worker simply stays a normal thread
+void makeWorkerRealTime(uint64_t periodNanos) {
+#if defined(__APPLE__)
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    const uint64_t period = periodNanos * timebase.denom / timebase.numer;
+
+    // A group's worth of rendering may take up to half a group period
+    thread_time_constraint_policy_data_t policy;
+    policy.period = static_cast<uint32_t>(period);
+    policy.computation = static_cast<uint32_t>(period / 2);
+    policy.constraint = static_cast<uint32_t>(period);
+    policy.preemptible = 1;
+    thread_policy_set(pthread_mach_thread_np(pthread_self()), THREAD_TIME_CONSTRAINT_POLICY,
+                      reinterpret_cast<thread_policy_t>(&policy), THREAD_TIME_CONSTRAINT_POLICY_COUNT);
+#elif defined(__linux__)
+    (void)periodNanos;
+    sched_param param{};
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+    pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+#else
+    (void)periodNanos;
+#endif
+}
+
+} // namespace
+
+TransmitRenderPipeline::TransmitRenderPipeline(uint32_t capacity)
+    : capacity_(capacity ? capacity : 1), jobs_(capacity_)
+{
+}
+
+TransmitRenderPipeline::~TransmitRenderPipeline() {
+    stop();
+}
+
+bool TransmitRenderPipeline::start(RenderFn render, void* refCon, uint64_t periodNanos) {
+    if (worker_.joinable() || !render) return false;
+    render_ = render;
+    refCon_ = refCon;
+
+    const uint32_t s = submitted_.load(std::memory_order_relaxed);
+    rendered_.store(s, std::memory_order_relaxed);
+    skipUntil_.store(s, std::memory_order_relaxed);
+    taken_ = s;
+    flushesDone_.store(flushes_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    flushesTaken_ = flushes_.load(std::memory_order_relaxed);
+    stopping_.store(false, std::memory_order_relaxed);
+
+    worker_ = std::thread(&TransmitRenderPipeline::run, this, periodNanos);
+    return true;
+}
+
+void TransmitRenderPipeline::stop() {
+    if (!worker_.joinable()) return;
+    stopping_.store(true, std::memory_order_release);
+    worker_.join();
+
+    const uint32_t s = submitted_.load(std::memory_order_relaxed);
+    rendered_.store(s, std::memory_order_relaxed);
+    skipUntil_.store(s, std::memory_order_relaxed);
+    taken_ = s;
+}
+
+bool TransmitRenderPipeline::submit(const TransmitRenderJob& job) {
+    const uint32_t s = submitted_.load(std::memory_order_relaxed);
+    if (s - taken_ >= capacity_) return false;
+    jobs_[s % capacity_] = job;
+    submitted_.store(s + 1, std::memory_order_release);
+    return true;
+}
+
+bool TransmitRenderPipeline::takeRendered(uint32_t& group) {
+    const uint32_t rendered = rendered_.load(std::memory_order_acquire);
+    // Loaded after rendered_: a group rendered after a re-prime makes that re-prime visible
+    const uint32_t flushesDone = flushesDone_.load(std::memory_order_acquire);
+    if (flushesDone != flushesTaken_) {
+        flushesTaken_ = flushesDone;
+        if (flushesDone == flushes_.load(std::memory_order_relaxed)) {   // else superseded by a later flush
+            group = TransmitRenderJob::kAllGroups;
+            return true;
+        }
+    }
+
+    const uint32_t skipUntil = skipUntil_.load(std::memory_order_relaxed);   // producer's own store
+    while (taken_ != rendered) {
+        const uint32_t t = taken_++;
+        if (static_cast<int32_t>(t - skipUntil) < 0) continue;   // dropped by flush()
+        group = jobs_[t % capacity_].group;
+        return true;
+    }
+    return false;
+}
+
+uint32_t TransmitRenderPipeline::pending() const {
+    return submitted_.load(std::memory_order_relaxed) - taken_;
+}
+
+void TransmitRenderPipeline::flush() {
+    const uint32_t s = submitted_.load(std::memory_order_relaxed);
+    skipUntil_.store(s, std::memory_order_release);
+    if (worker_.joinable()) {
+        // Published before any later submit(), so the worker re-primes before rendering it
+        flushes_.fetch_add(1, std::memory_order_release);
+    } else {
+        rendered_.store(s, std::memory_order_relaxed);
+        taken_ = s;
+    }
+}
+
+void TransmitRenderPipeline::run(uint64_t periodNanos) {
+    makeWorkerRealTime(periodNanos);
+
+    // The worker polls instead of being woken: a wakeup is a syscall, and on a busy core a
+    // context switch, inside the completion callback. A quarter group is plenty of slack
+    // against the almost full ring a submitted group has before it goes out again.
+    const auto idle = std::chrono::nanoseconds(std::max<uint64_t>(periodNanos / 4, 50'000));
+
+    TransmitRenderJob reprime;
+    reprime.group = TransmitRenderJob::kAllGroups;
+
+    while (!stopping_.load(std::memory_order_acquire)) {
+        const uint32_t r = rendered_.load(std::memory_order_relaxed);
+        const uint32_t s = submitted_.load(std::memory_order_acquire);
+
+        // A flush is seen no later than the first job submitted after it: re-prime before that job
+        const uint32_t f = flushes_.load(std::memory_order_acquire);
+        if (f != flushesDone_.load(std::memory_order_relaxed)) {
+            render_(reprime, refCon_);
+            flushesDone_.store(f, std::memory_order_release);
+            continue;
+        }
+        if (r == s) {
+            std::this_thread::sleep_for(idle);
+            continue;
+        }
+
+        // Jobs dropped by flush() are passed over unrendered
+        if (static_cast<int32_t>(r - skipUntil_.load(std::memory_order_acquire)) >= 0) {
+            render_(jobs_[r % capacity_], refCon_);
+        }
+        rendered_.store(r + 1, std::memory_order_release);
+    }
+}
+
+} // namespace Isoch
+} // namespace FWA
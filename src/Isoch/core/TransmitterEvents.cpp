@@ -0,0 +1,87 @@
+#include "Isoch/core/TransmitterEvents.hpp"
+
+#include <pthread.h>
+#if defined(__APPLE__)
+#include <pthread/qos.h>
+#endif
+
+namespace FWA {
+namespace Isoch {
+
+namespace {
+// Dispatcher whose thread this is, so stop() from a sink never touches thread_ or joins itself
+thread_local const TransmitterEventDispatcher* tDispatching = nullptr;
+} // namespace
+
+TransmitterEventDispatcher::TransmitterEventDispatcher(const TransmitterEventCounters& counters,
+                                                       std::chrono::milliseconds interval)
+    : counters_(counters), interval_(interval)
+{
+}
+
+TransmitterEventDispatcher::~TransmitterEventDispatcher() {
+    stop();
+}
+
+void TransmitterEventDispatcher::start(Sink sink, void* refCon) {
+    if (!sink || tDispatching == this) return;
+    if (thread_.joinable()) {
+        // Still running, or stopped from its own sink and not joined yet (which it cannot do itself)
+        if (!stopping_) return;
+        thread_.join();
+    }
+    sink_ = sink;
+    refCon_ = refCon;
+    reported_ = counters_.snapshot();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+    }
+    thread_ = std::thread(&TransmitterEventDispatcher::run, this);
+}
+
+void TransmitterEventDispatcher::stop() {
+    // Called from the sink (a client stopping the stream on a fault report): the thread exits once
+    // the sink returns, and the next start() or stop() from another thread joins it
+    const bool fromSink = tDispatching == this;
+    if (!fromSink && !thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    if (fromSink) return;
+    wake_.notify_all();
+    thread_.join();
+}
+
+void TransmitterEventDispatcher::run() {
+    tDispatching = this;
+    // Reports are bookkeeping: never compete with the audio or isoch threads
+#if defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_UTILITY, 0);
+#elif defined(__linux__)
+    sched_param param{};
+    pthread_setschedparam(pthread_self(), SCHED_BATCH, &param);
+#endif
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        if (wake_.wait_for(lock, interval_, [this] { return stopping_.load(); })) break;
+        lock.unlock();
+        dispatch();
+        lock.lock();
+    }
+    lock.unlock();
+    dispatch();   // final report: nothing counted before stop() is lost
+}
+
+void TransmitterEventDispatcher::dispatch() {
+    const TransmitterEventSnapshot totals = counters_.snapshot();
+    const TransmitterEventSnapshot delta = totals.since(reported_);
+    if (delta.total() == 0) return;
+    reported_ = totals;
+    sink_(delta, totals, refCon_);
+}
+
+} // namespace Isoch
+} // namespace FWA
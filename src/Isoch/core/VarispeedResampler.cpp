@@ -0,0 +1,141 @@
+#include "Isoch/core/VarispeedResampler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace FWA {
+namespace Isoch {
+
+namespace {
+constexpr float kSampleMax = 8388607.0f;    // 24-bit range
+constexpr float kSampleMin = -8388608.0f;
+constexpr double kMaxStepDeviation = 0.01;
+} // namespace
+
+VarispeedResampler::VarispeedResampler(uint32_t channels, uint32_t maxInputFrames)
+    : channels_(std::max<uint32_t>(1, channels)),
+      maxInputFrames_(maxInputFrames),
+      work_(new float[size_t(kHistory + maxInputFrames) * std::max<uint32_t>(1, channels)])
+{
+    reset();
+}
+
+VarispeedResampler::~VarispeedResampler() = default;
+
+void VarispeedResampler::reset() {
+    std::fill_n(work_.get(), size_t(kHistory + maxInputFrames_) * channels_, 0.0f);
+    pos_ = 1.0;
+}
+
+void VarispeedResampler::setStep(double inputFramesPerOutputFrame) {
+    step_ = std::clamp(inputFramesPerOutputFrame, 1.0 - kMaxStepDeviation, 1.0 + kMaxStepDeviation);
+}
+
+uint32_t VarispeedResampler::maxOutputFrames(uint32_t inFrames) const {
+    return static_cast<uint32_t>(std::ceil(double(inFrames) / step_)) + 2;
+}
+
+// Catmull-Rom through x[-1], x[0], x[1], x[2] (frame pointers, channels apart) at t in [0, 1).
+void VarispeedResampler::interpolateFrame(const float* x, float t, int32_t* out) const {
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    const float c0 = 0.5f * (-t3 + 2.0f * t2 - t);
+    const float c1 = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+    const float c2 = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+    const float c3 = 0.5f * (t3 - t2);
+    const uint32_t ch = channels_;
+    const float* xm1 = x - ch;
+    const float* x0 = x;
+    const float* x1 = x + ch;
+    const float* x2 = x + 2 * ch;
+
+    uint32_t c = 0;
+#if defined(__SSE2__)
+    const __m128 v0 = _mm_set1_ps(c0), v1 = _mm_set1_ps(c1), v2 = _mm_set1_ps(c2), v3 = _mm_set1_ps(c3);
+    const __m128 lo = _mm_set1_ps(kSampleMin), hi = _mm_set1_ps(kSampleMax);
+    for (; c + 4 <= ch; c += 4) {
+        __m128 y = _mm_mul_ps(v0, _mm_loadu_ps(xm1 + c));
+        y = _mm_add_ps(y, _mm_mul_ps(v1, _mm_loadu_ps(x0 + c)));
+        y = _mm_add_ps(y, _mm_mul_ps(v2, _mm_loadu_ps(x1 + c)));
+        y = _mm_add_ps(y, _mm_mul_ps(v3, _mm_loadu_ps(x2 + c)));
+        y = _mm_min_ps(_mm_max_ps(y, lo), hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + c), _mm_cvtps_epi32(y));
+    }
+#elif defined(__ARM_NEON)
+    const float32x4_t lo = vdupq_n_f32(kSampleMin), hi = vdupq_n_f32(kSampleMax);
+    for (; c + 4 <= ch; c += 4) {
+        float32x4_t y = vmulq_n_f32(vld1q_f32(xm1 + c), c0);
+        y = vmlaq_n_f32(y, vld1q_f32(x0 + c), c1);
+        y = vmlaq_n_f32(y, vld1q_f32(x1 + c), c2);
+        y = vmlaq_n_f32(y, vld1q_f32(x2 + c), c3);
+        y = vminq_f32(vmaxq_f32(y, lo), hi);
+        vst1q_s32(out + c, vcvtnq_s32_f32(y));
+    }
+#endif
+    for (; c < ch; ++c) {
+        float y = c0 * xm1[c] + c1 * x0[c] + c2 * x1[c] + c3 * x2[c];
+        y = std::min(std::max(y, kSampleMin), kSampleMax);
+        out[c] = static_cast<int32_t>(std::lrintf(y));
+    }
+}
+
+uint32_t VarispeedResampler::process(const int32_t* in, uint32_t inFrames, int32_t* out, uint32_t maxOutFrames) {
+    inFrames = std::min(inFrames, maxInputFrames_);
+    const uint32_t ch = channels_;
+    float* work = work_.get();
+
+    // Append the new input after the carried-over history.
+    float* dst = work + size_t(kHistory) * ch;
+    const size_t samples = size_t(inFrames) * ch;
+    for (size_t i = 0; i < samples; ++i) {
+        dst[i] = static_cast<float>(in[i]);
+    }
+
+    // Frame i needs i-1 .. i+2, so the last usable integer position is total - 3.
+    const uint32_t total = kHistory + inFrames;
+    const uint32_t limit = std::min(maxOutFrames, maxOutputFrames(inFrames));
+    uint32_t produced = 0;
+    double pos = pos_;
+    while (produced < limit) {
+        const uint32_t i = static_cast<uint32_t>(pos);
+        if (i > total - 3) break;
+        interpolateFrame(work + size_t(i) * ch, static_cast<float>(pos - i), out + size_t(produced) * ch);
+        ++produced;
+        pos += step_;
+    }
+
+    // Keep the last kHistory frames and rebase the position onto them. If the caller's buffer
+    // cut the loop short the skipped input is dropped rather than read out of range next time.
+    std::memmove(work, work + size_t(total - kHistory) * ch, size_t(kHistory) * ch * sizeof(float));
+    pos_ = std::max(1.0, pos - double(total - kHistory));
+    return produced;
+}
+
+void RateServo::reset() {
+    smoothedFill_ = -1.0;
+    integral_ = 0.0;
+    correction_ = 0.0;
+}
+
+double RateServo::update(double fill, double target, double busPerHost) {
+    if (busPerHost <= 0.0) busPerHost = 1.0;
+    if (target > 0.0) {
+        smoothedFill_ = smoothedFill_ < 0.0 ? fill : smoothedFill_ + config_.smoothing * (fill - smoothedFill_);
+        const double error = (smoothedFill_ - target) / target;
+        integral_ = std::clamp(integral_ + config_.ki * error, -config_.maxCorrection, config_.maxCorrection);
+        correction_ = std::clamp(config_.kp * error + integral_, -config_.maxCorrection, config_.maxCorrection);
+    } else {
+        correction_ = 0.0;
+    }
+    // Host-clock frames in per bus-clock frame out; a fuller ring consumes input faster.
+    return (1.0 / busPerHost) * (1.0 + correction_);
+}
+
+} // namespace Isoch
+} // namespace FWA
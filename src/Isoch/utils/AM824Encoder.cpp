@@ -0,0 +1,342 @@
+#include "Isoch/utils/AM824Encoder.hpp"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define AM824_X86 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define AM824_NEON 1
+#endif
+
+namespace FWA {
+namespace Isoch {
+namespace AM824 {
+
+namespace {
+
+constexpr uint32_t kLabelBits = kAudioLabel << 24;
+constexpr float kFloatScale = 8388608.0f;   // 2^23
+constexpr float kFloatMin = -8388608.0f;
+constexpr float kFloatMax = 8388607.0f;
+
+// Hosts are little-endian (x86, arm64), so "to big endian" is a byte swap
+inline uint32_t quadlet(uint32_t sample24) {
+    return __builtin_bswap32(kLabelBits | (sample24 & 0x00FFFFFF));
+}
+
+// Same operand order as SSE maxps/minps, so NaN clamps to kFloatMin everywhere
+inline int32_t floatTo24(float x) {
+    float v = x * kFloatScale;
+    v = v > kFloatMin ? v : kFloatMin;
+    v = v < kFloatMax ? v : kFloatMax;
+    return static_cast<int32_t>(__builtin_lrintf(v));
+}
+
+// --- scalar reference ---
+
+void int32Scalar(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const int32_t*>(src);
+    for (size_t i = 0; i < n; ++i) dst[i] = quadlet(static_cast<uint32_t>(in[i]));
+}
+
+void float32Scalar(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const float*>(src);
+    for (size_t i = 0; i < n; ++i) dst[i] = quadlet(static_cast<uint32_t>(floatTo24(in[i])));
+}
+
+void int24Scalar(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const uint8_t*>(src);
+    for (size_t i = 0; i < n; ++i, in += 3) {
+        dst[i] = quadlet(uint32_t(in[0]) | uint32_t(in[1]) << 8 | uint32_t(in[2]) << 16);
+    }
+}
+
+void int16Scalar(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const int16_t*>(src);
+    for (size_t i = 0; i < n; ++i) dst[i] = quadlet(static_cast<uint32_t>(in[i]) << 8);
+}
+
+#if defined(AM824_X86)
+
+// Byte shuffles: masked int32 -> big-endian quadlet, and 4 packed 24-bit samples -> 4 quadlets.
+// 0x80 zeroes the byte; the label is OR-ed in afterwards.
+#define AM824_SWAP32   0x80, 2, 1, 0, 0x80, 6, 5, 4, 0x80, 10, 9, 8, 0x80, 14, 13, 12
+#define AM824_UNPACK24 0x80, 2, 1, 0, 0x80, 5, 4, 3, 0x80, 8, 7, 6, 0x80, 11, 10, 9
+#define AM824_UNPACK16_LO 0x80, 1, 0, 0x80, 0x80, 3, 2, 0x80, 0x80, 5, 4, 0x80, 0x80, 7, 6, 0x80
+#define AM824_UNPACK16_HI 0x80, 9, 8, 0x80, 0x80, 11, 10, 0x80, 0x80, 13, 12, 0x80, 0x80, 15, 14, 0x80
+
+__attribute__((target("sse4.1")))
+void int32SSE41(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const int32_t*>(src);
+    const __m128i swap = _mm_setr_epi8(AM824_SWAP32);
+    const __m128i label = _mm_set1_epi32(kAudioLabel);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        v = _mm_or_si128(_mm_shuffle_epi8(v, swap), label);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    int32Scalar(in + i, n - i, dst + i);
+}
+
+__attribute__((target("sse4.1")))
+void float32SSE41(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const float*>(src);
+    const __m128 scale = _mm_set1_ps(kFloatScale);
+    const __m128 lo = _mm_set1_ps(kFloatMin), hi = _mm_set1_ps(kFloatMax);
+    const __m128i swap = _mm_setr_epi8(AM824_SWAP32);
+    const __m128i label = _mm_set1_epi32(kAudioLabel);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 f = _mm_mul_ps(_mm_loadu_ps(in + i), scale);
+        f = _mm_min_ps(_mm_max_ps(f, lo), hi);
+        __m128i v = _mm_cvtps_epi32(f);
+        v = _mm_or_si128(_mm_shuffle_epi8(v, swap), label);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    float32Scalar(in + i, n - i, dst + i);
+}
+
+__attribute__((target("sse4.1")))
+void int24SSE41(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const uint8_t*>(src);
+    const __m128i unpack = _mm_setr_epi8(AM824_UNPACK24);
+    const __m128i label = _mm_set1_epi32(kAudioLabel);
+    size_t i = 0;
+    // A 16-byte load covers 4 samples (12 bytes); stop while it still ends inside the input
+    for (; i + 6 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 3));
+        v = _mm_or_si128(_mm_shuffle_epi8(v, unpack), label);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    int24Scalar(in + i * 3, n - i, dst + i);
+}
+
+__attribute__((target("sse4.1")))
+void int16SSE41(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const int16_t*>(src);
+    const __m128i lo = _mm_setr_epi8(AM824_UNPACK16_LO), hi = _mm_setr_epi8(AM824_UNPACK16_HI);
+    const __m128i label = _mm_set1_epi32(kAudioLabel);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_or_si128(_mm_shuffle_epi8(v, lo), label));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_or_si128(_mm_shuffle_epi8(v, hi), label));
+    }
+    int16Scalar(in + i, n - i, dst + i);
+}
+
+__attribute__((target("avx2")))
+void int32AVX2(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const int32_t*>(src);
+    const __m256i swap = _mm256_setr_epi8(AM824_SWAP32, AM824_SWAP32);
+    const __m256i label = _mm256_set1_epi32(kAudioLabel);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        v = _mm256_or_si256(_mm256_shuffle_epi8(v, swap), label);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+    }
+    int32Scalar(in + i, n - i, dst + i);
+}
+
+__attribute__((target("avx2")))
+void float32AVX2(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const float*>(src);
+    const __m256 scale = _mm256_set1_ps(kFloatScale);
+    const __m256 lo = _mm256_set1_ps(kFloatMin), hi = _mm256_set1_ps(kFloatMax);
+    const __m256i swap = _mm256_setr_epi8(AM824_SWAP32, AM824_SWAP32);
+    const __m256i label = _mm256_set1_epi32(kAudioLabel);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 f = _mm256_mul_ps(_mm256_loadu_ps(in + i), scale);
+        f = _mm256_min_ps(_mm256_max_ps(f, lo), hi);
+        __m256i v = _mm256_cvtps_epi32(f);
+        v = _mm256_or_si256(_mm256_shuffle_epi8(v, swap), label);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+    }
+    float32Scalar(in + i, n - i, dst + i);
+}
+
+__attribute__((target("avx2")))
+void int24AVX2(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const uint8_t*>(src);
+    const __m256i unpack = _mm256_setr_epi8(AM824_UNPACK24, AM824_UNPACK24);
+    const __m256i label = _mm256_set1_epi32(kAudioLabel);
+    size_t i = 0;
+    // Two 16-byte loads, 12 bytes apart, one per lane (the shuffle does not cross lanes)
+    for (; i + 10 <= n; i += 8) {
+        const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 3));
+        const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * 3 + 12));
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(a), b, 1);
+        v = _mm256_or_si256(_mm256_shuffle_epi8(v, unpack), label);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+    }
+    int24Scalar(in + i * 3, n - i, dst + i);
+}
+
+__attribute__((target("avx2")))
+void int16AVX2(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const int16_t*>(src);
+    // Both lanes see the same 8 samples; the low lane expands the first 4, the high lane the rest
+    const __m256i unpack = _mm256_setr_epi8(AM824_UNPACK16_LO, AM824_UNPACK16_HI);
+    const __m256i label = _mm256_set1_epi32(kAudioLabel);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m256i q = _mm256_shuffle_epi8(_mm256_broadcastsi128_si256(v), unpack);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(q, label));
+    }
+    int16Scalar(in + i, n - i, dst + i);
+}
+
+#undef AM824_SWAP32
+#undef AM824_UNPACK24
+#undef AM824_UNPACK16_LO
+#undef AM824_UNPACK16_HI
+
+#elif defined(AM824_NEON)
+
+void int32NEON(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const uint32_t*>(src);
+    const uint32x4_t mask = vdupq_n_u32(0x00FFFFFF), label = vdupq_n_u32(kLabelBits);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        const uint32x4_t v = vorrq_u32(vandq_u32(vld1q_u32(in + i), mask), label);
+        vst1q_u32(dst + i, vreinterpretq_u32_u8(vrev32q_u8(vreinterpretq_u8_u32(v))));
+    }
+    int32Scalar(in + i, n - i, dst + i);
+}
+
+void float32NEON(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const float*>(src);
+    const float32x4_t lo = vdupq_n_f32(kFloatMin), hi = vdupq_n_f32(kFloatMax);
+    const uint32x4_t mask = vdupq_n_u32(0x00FFFFFF), label = vdupq_n_u32(kLabelBits);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t f = vmulq_n_f32(vld1q_f32(in + i), kFloatScale);
+        // Compare-and-select rather than vmax/vmin, which would propagate NaN
+        f = vbslq_f32(vcgtq_f32(f, lo), f, lo);
+        f = vbslq_f32(vcltq_f32(f, hi), f, hi);
+        uint32x4_t v = vreinterpretq_u32_s32(vcvtnq_s32_f32(f));
+        v = vorrq_u32(vandq_u32(v, mask), label);
+        vst1q_u32(dst + i, vreinterpretq_u32_u8(vrev32q_u8(vreinterpretq_u8_u32(v))));
+    }
+    float32Scalar(in + i, n - i, dst + i);
+}
+
+void int24NEON(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const uint8_t*>(src);
+    size_t i = 0;
+    // De-interleave 16 samples into low/mid/high byte planes, re-interleave as [label, hi, mid, lo]
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16x3_t b = vld3q_u8(in + i * 3);
+        uint8x16x4_t q;
+        q.val[0] = vdupq_n_u8(static_cast<uint8_t>(kAudioLabel));
+        q.val[1] = b.val[2];
+        q.val[2] = b.val[1];
+        q.val[3] = b.val[0];
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst + i), q);
+    }
+    int24Scalar(in + i * 3, n - i, dst + i);
+}
+
+void int16NEON(const void* src, size_t n, uint32_t* dst) {
+    const auto* in = static_cast<const uint8_t*>(src);
+    size_t i = 0;
+    // Low/high byte planes of 16 samples, re-interleaved as [label, hi, lo, 0]
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16x2_t b = vld2q_u8(in + i * 2);
+        uint8x16x4_t q;
+        q.val[0] = vdupq_n_u8(static_cast<uint8_t>(kAudioLabel));
+        q.val[1] = b.val[1];
+        q.val[2] = b.val[0];
+        q.val[3] = vdupq_n_u8(0);
+        vst4q_u8(reinterpret_cast<uint8_t*>(dst + i), q);
+    }
+    int16Scalar(in + i * 2, n - i, dst + i);
+}
+
+#endif
+
+struct Table {
+    Isa isa;
+    EncodeFn fn[4];   // indexed by AM824InputFormat
+};
+
+Table detect() {
+#if defined(AM824_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return {Isa::AVX2, {int32AVX2, float32AVX2, int24AVX2, int16AVX2}};
+    if (__builtin_cpu_supports("sse4.1")) return {Isa::SSE41, {int32SSE41, float32SSE41, int24SSE41, int16SSE41}};
+#elif defined(AM824_NEON)
+    return {Isa::NEON, {int32NEON, float32NEON, int24NEON, int16NEON}};
+#endif
+    return {Isa::Scalar, {int32Scalar, float32Scalar, int24Scalar, int16Scalar}};
+}
+
+// Resolved during static initialisation, before any IO callback can run
+const Table gTable = detect();
+
+} // namespace
+
+void encode(AM824InputFormat format, const void* src, size_t samples, uint32_t* dst) {
+    gTable.fn[static_cast<size_t>(format)](src, samples, dst);
+}
+
+void spreadDataBlocks(uint32_t* dst, size_t frames, uint32_t audioChannels, uint32_t dbs) {
+    if (dbs <= audioChannels) return;
+    const uint32_t midiQuadlet = __builtin_bswap32(kMidiLabel << 24);
+    // Back to front, so every block is moved before the packed data under it is overwritten
+    for (size_t f = frames; f-- > 0;) {
+        uint32_t* block = dst + f * dbs;
+        std::memmove(block, dst + f * audioChannels, audioChannels * sizeof(uint32_t));
+        for (uint32_t s = audioChannels; s < dbs; ++s) block[s] = midiQuadlet;
+    }
+}
+
+EncodeFn kernel(AM824InputFormat format, Isa isa) {
+    const size_t f = static_cast<size_t>(format);
+    switch (isa) {
+    case Isa::Scalar: {
+        static constexpr EncodeFn fns[] = {int32Scalar, float32Scalar, int24Scalar, int16Scalar};
+        return fns[f];
+    }
+#if defined(AM824_X86)
+    case Isa::SSE41: {
+        static constexpr EncodeFn fns[] = {int32SSE41, float32SSE41, int24SSE41, int16SSE41};
+        return __builtin_cpu_supports("sse4.1") ? fns[f] : nullptr;
+    }
+    case Isa::AVX2: {
+        static constexpr EncodeFn fns[] = {int32AVX2, float32AVX2, int24AVX2, int16AVX2};
+        return __builtin_cpu_supports("avx2") ? fns[f] : nullptr;
+    }
+#elif defined(AM824_NEON)
+    case Isa::NEON: {
+        static constexpr EncodeFn fns[] = {int32NEON, float32NEON, int24NEON, int16NEON};
+        return fns[f];
+    }
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+Isa activeIsa() {
+    return gTable.isa;
+}
+
+const char* isaName(Isa isa) {
+    switch (isa) {
+    case Isa::Scalar: return "scalar";
+    case Isa::SSE41:  return "sse4.1";
+    case Isa::AVX2:   return "avx2";
+    case Isa::NEON:   return "neon";
+    }
+    return "?";
+}
+
+} // namespace AM824
+} // namespace Isoch
+} // namespace FWA
@@ -60,8 +60,24 @@ std::shared_ptr<aspl::Driver> CreateDriver()
         .mBytesPerPacket = 8,
     };
 
+    // Capture stream fed from the daemon's capture ring (float32 interleaved, see kDefaultCapture*)
+    aspl::StreamParameters inputStreamParams;
+    inputStreamParams.Direction = aspl::Direction::Input;
+    inputStreamParams.StartingChannel = 1;
+    inputStreamParams.Format = {
+        .mSampleRate = 48000,
+        .mFormatID = kAudioFormatLinearPCM,
+        .mFormatFlags = kAudioFormatFlagIsFloat | kAudioFormatFlagIsPacked,
+        .mBitsPerChannel = 32,
+        .mChannelsPerFrame = 2,
+        .mBytesPerFrame = 8,
+        .mFramesPerPacket = 1,
+        .mBytesPerPacket = 8,
+    };
+
     auto device = std::make_shared<FWADriverDevice>(context, deviceParams);
     device->AddStreamWithControlsAsync(streamParams);
+    device->AddStreamWithControlsAsync(inputStreamParams);
     auto handler = std::make_shared<FWADriverHandler>();
     device->SetControlHandler(handler);
     device->SetIOHandler(handler);
@@ -10,6 +10,7 @@
 #include <cassert>
 #include "FWADriverHandler.hpp"
 #include <CoreAudio/AudioServerPlugIn.h>
+#include <mach/mach_time.h>
 constexpr const char* LogPrefix = "FWADriverASPL: ";
 
 // --- Local Helper Function ---
@@ -157,6 +158,26 @@ std::vector<AudioValueRange> FWADriverDevice::GetSimulatedAvailableSampleRates()
     };
 }
 
+OSStatus FWADriverDevice::GetZeroTimeStampImpl(UInt32 clientID,
+                                               Float64* outSampleTime,
+                                               UInt64* outHostTime,
+                                               UInt64* outSeed)
+{
+    FWADriverHandler* ioHandler = static_cast<FWADriverHandler*>(GetIOHandler());
+    RTShmRing::ClockSnapshot clock;
+    double sampleTime = 0.0;
+    uint64_t hostTime = 0;
+    if (ioHandler && ioHandler->ReadBusClock(clock) &&
+        RTShmRing::ZeroTimeStampAt(clock, mach_absolute_time(), GetZeroTimeStampPeriod(), sampleTime, hostTime)) {
+        *outSampleTime = sampleTime;
+        *outHostTime = hostTime;
+        // Offset so a bus-clock seed never collides with the fallback clock's seed
+        *outSeed = clock.seed + 1;
+        return kAudioHardwareNoError;
+    }
+    return aspl::Device::GetZeroTimeStampImpl(clientID, outSampleTime, outHostTime, outSeed);
+}
+
 OSStatus FWADriverDevice::DoIOOperation(AudioObjectID objectID,
                                         AudioObjectID streamID,
                                         UInt32 clientID,
@@ -184,7 +205,8 @@ OSStatus FWADriverDevice::DoIOOperation(AudioObjectID objectID,
             GetContext()->Tracer->Message("%sERROR: DoIOOperation: Shared memory not ready", LogPrefix);
             return kAudioHardwareUnspecifiedError;
         }
-        bool success = ioHandler->PushToSharedMemory(static_cast<const AudioBufferList*>(ioMainBuffer),
+        // ioMainBuffer holds ioBufferFrameSize interleaved frames in the stream's virtual format
+        bool success = ioHandler->PushToSharedMemory(ioMainBuffer,
                                                      ioCycleInfo->mOutputTime,
                                                      ioBufferFrameSize,
                                                      bytesPerFrame);
@@ -192,12 +214,18 @@ OSStatus FWADriverDevice::DoIOOperation(AudioObjectID objectID,
         (void)success;
         return kAudioHardwareNoError;
     } else if (operationID == kAudioServerPlugInIOOperationReadInput) {
-        // Provide silence for input
-        AudioBufferList* inputBufferList = static_cast<AudioBufferList*>(ioMainBuffer);
-        for (UInt32 i = 0; i < inputBufferList->mNumberBuffers; ++i) {
-            if (inputBufferList->mBuffers[i].mData) {
-                memset(inputBufferList->mBuffers[i].mData, 0, inputBufferList->mBuffers[i].mDataByteSize);
-            }
+        auto stream = GetStreamByID(streamID);
+        if (!stream || !ioMainBuffer) {
+            return kAudioHardwareBadStreamError;
+        }
+        uint32_t bytesPerFrame = stream->GetVirtualFormat().mBytesPerFrame;
+        FWADriverHandler* ioHandler = static_cast<FWADriverHandler*>(GetIOHandler());
+        if (ioHandler && ioHandler->IsCaptureReady()) {
+            // Pulls ioBufferFrameSize interleaved frames from the daemon's capture ring; zero-fills on underrun
+            ioHandler->ReadFromSharedMemory(ioMainBuffer, ioBufferFrameSize, bytesPerFrame);
+        } else {
+            // Provide silence for input
+            memset(ioMainBuffer, 0, size_t(ioBufferFrameSize) * bytesPerFrame);
         }
         return kAudioHardwareNoError;
     }
@@ -46,6 +46,14 @@ public:
                            void* ioMainBuffer,
                            void* ioSecondaryBuffer) override;
 
+protected:
+    // Zero timestamps follow the FireWire media clock published by the daemon, falling back to
+    // the nominal-rate clock from aspl::Device until the daemon's PLL has locked.
+    OSStatus GetZeroTimeStampImpl(UInt32 clientID,
+                                  Float64* outSampleTime,
+                                  UInt64* outHostTime,
+                                  UInt64* outSeed) override;
+
 private:
     // Helper to get the simulated supported rates
     std::vector<AudioValueRange> GetSimulatedAvailableSampleRates() const;
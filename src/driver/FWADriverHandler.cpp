@@ -2,6 +2,8 @@
 #include <os/log.h>
 #include <sys/mman.h>   // For mmap, munmap, shm_open, shm_unlink
 #include <fcntl.h>      // For O_RDWR
+#include <sys/stat.h>   // For fstat
+#include <shared/ShmAllocation.hpp>
 #include <unistd.h>     // For close
 #include <stdexcept>
 #include <cerrno>
@@ -17,72 +19,111 @@ FWADriverHandler::~FWADriverHandler() {
     TeardownSharedMemory();
 }
 
-bool FWADriverHandler::SetupSharedMemory(const std::string& shmName) {
-    os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Setting up shared memory '%s'", LogPrefix, shmName.c_str());
-    if (shmPtr_) {
-        os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Shared memory already set up.", LogPrefix);
-        return true;
-    }
-    shmFd_ = shm_open(shmName.c_str(), O_RDWR, 0);
-    if (shmFd_ == -1) {
+bool FWADriverHandler::MapSegment(const std::string& shmName, MappedSegment& seg) {
+    seg.fd = shm_open(shmName.c_str(), O_RDWR, 0);
+    if (seg.fd == -1) {
         os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: shm_open failed for '%s': %{errno}d", LogPrefix, shmName.c_str(), errno);
         return false;
     }
-    shmSize_ = sizeof(RTShmRing::SharedRingBuffer_POD);
-    shmPtr_ = mmap(nullptr, shmSize_, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd_, 0);
-    if (shmPtr_ == MAP_FAILED) {
+    // The daemon sizes the segment for its channel count / latency target; take the size from the object itself.
+    struct stat st {};
+    if (fstat(seg.fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(RTShmRing::ControlBlock_POD))) {
+        os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: fstat failed or segment too small for '%s': %{errno}d", LogPrefix, shmName.c_str(), errno);
+        close(seg.fd);
+        seg.fd = -1;
+        return false;
+    }
+    seg.size = static_cast<size_t>(st.st_size);
+    // Pre-fault, mlock and verify residency here so no first-touch fault lands on the IO thread
+    RTShmRing::ShmMapping mapping = RTShmRing::MapShm(seg.fd, seg.size);
+    if (!mapping) {
         os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: mmap failed: %{errno}d", LogPrefix, errno);
-        close(shmFd_);
-        shmFd_ = -1;
-        shmPtr_ = nullptr;
+        close(seg.fd);
+        seg.fd = -1;
+        seg.size = 0;
         return false;
     }
-    if (mlock(shmPtr_, shmSize_) != 0) {
-        os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: WARNING - mlock failed: %{errno}d. Real-time performance may suffer.", LogPrefix, errno);
-    }
-    os_log_info(OS_LOG_DEFAULT, "%sFWADriverHandler: Hinting kernel to prefetch pages (MADV_WILLNEED).", LogPrefix);
-    if (madvise(shmPtr_, shmSize_, MADV_WILLNEED) != 0) {
-        os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: WARNING - madvise(MADV_WILLNEED) failed: %{errno}d", LogPrefix, errno);
-        // This is just a hint, so failure isn't critical, just log it.
-    }
-    RTShmRing::SharedRingBuffer_POD* sharedRegion = static_cast<RTShmRing::SharedRingBuffer_POD*>(shmPtr_);
-    controlBlock_ = &(sharedRegion->control);
-    ringBuffer_ = sharedRegion->ring;
-    if (controlBlock_->abiVersion != kShmVersion || controlBlock_->capacity != kRingCapacityPow2) {
-        os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: ERROR - Shared memory header mismatch (abiVersion: %u, capacity: %u). Tearing down.",
-            LogPrefix, controlBlock_->abiVersion, controlBlock_->capacity);
-        TeardownSharedMemory();
+    seg.ptr = mapping.base;
+    seg.locked = mapping.lockedBytes != 0;
+    if (!seg.locked) {
+        os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: WARNING - mlock failed: %{errno}d. Real-time performance may suffer.", LogPrefix, mapping.lockErrno);
+    }
+    if (mapping.residentBytes < mapping.bytes) {
+        os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: WARNING - only %zu of %zu bytes resident after pre-fault.", LogPrefix, mapping.residentBytes, mapping.bytes);
+    }
+    os_log_info(OS_LOG_DEFAULT, "%sFWADriverHandler: '%s' page size %zu, locked %zu bytes.", LogPrefix, shmName.c_str(), mapping.pageSize, mapping.lockedBytes);
+    seg.ring = RTShmRing::AttachRing(seg.ptr, seg.size);
+    if (!seg.ring) {
+        const auto* header = static_cast<const RTShmRing::ControlBlock_POD*>(seg.ptr);
+        os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: ERROR - Shared memory header mismatch in '%s' (abiVersion: %u, frames: %u, bytesPerFrame: %u, mapped: %zu). Tearing down.",
+            LogPrefix, shmName.c_str(), header->abiVersion, header->capacityFrames, header->bytesPerFrame, seg.size);
+        UnmapSegment(seg);
         return false;
     }
-    os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Shared memory setup successful (Capacity: %u, ABI: %u).", LogPrefix, controlBlock_->capacity, controlBlock_->abiVersion);
+    os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Mapped '%s' (Frames: %u, Channels: %u, BytesPerFrame: %u, ABI: %u).",
+        LogPrefix, shmName.c_str(), seg.ring.control->capacityFrames, seg.ring.control->channels,
+        seg.ring.control->bytesPerFrame, seg.ring.control->abiVersion);
     return true;
 }
 
-void FWADriverHandler::TeardownSharedMemory() {
-    os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Tearing down shared memory.", LogPrefix);
-    if (shmPtr_ != nullptr) {
-        if (munlock(shmPtr_, shmSize_) != 0) {
+void FWADriverHandler::UnmapSegment(MappedSegment& seg) {
+    if (seg.ptr != nullptr) {
+        if (seg.locked && munlock(seg.ptr, seg.size) != 0) {
             os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: WARNING - munlock failed: %{errno}d", LogPrefix, errno);
         }
-        if (munmap(shmPtr_, shmSize_) != 0) {
+        if (munmap(seg.ptr, seg.size) != 0) {
             os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: munmap failed: %{errno}d", LogPrefix, errno);
         }
-        shmPtr_ = nullptr;
+        seg.ptr = nullptr;
+    }
+    if (seg.fd != -1) {
+        close(seg.fd);
+        seg.fd = -1;
+    }
+    seg.ring = {};
+    seg.size = 0;
+    seg.locked = false;
+}
+
+bool FWADriverHandler::SetupSharedMemory(const std::string& shmName) {
+    os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Setting up shared memory '%s'", LogPrefix, shmName.c_str());
+    if (playback_.ptr) {
+        os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Shared memory already set up.", LogPrefix);
+        return true;
+    }
+    if (!MapSegment(shmName, playback_)) {
+        return false;
     }
-    if (shmFd_ != -1) {
-        close(shmFd_);
-        shmFd_ = -1;
+    // Capture ring is optional: without it the input stream just delivers silence.
+    const std::string captureName = shmName + kCaptureShmSuffix;
+    if (!MapSegment(captureName, capture_)) {
+        os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: No capture ring '%s'; input will be silent.", LogPrefix, captureName.c_str());
     }
-    controlBlock_ = nullptr;
-    ringBuffer_ = nullptr;
-    shmSize_ = 0;
+    os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Shared memory setup successful (capture: %{public}s).",
+        LogPrefix, capture_.ring ? "yes" : "no");
+    return true;
+}
+
+void FWADriverHandler::TeardownSharedMemory() {
+    os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Tearing down shared memory.", LogPrefix);
+    UnmapSegment(capture_);
+    UnmapSegment(playback_);
     os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Shared memory teardown complete.", LogPrefix);
 }
 
-bool FWADriverHandler::PushToSharedMemory(const AudioBufferList* src, const AudioTimeStamp& ts, uint32_t frames, uint32_t bytesPerFrame) {
-    if (!controlBlock_ || !ringBuffer_) return false;
-    bool success = RTShmRing::push(*controlBlock_, ringBuffer_, src, ts, frames, bytesPerFrame);
-    if (!success) {
+bool FWADriverHandler::PushToSharedMemory(const void* src, const AudioTimeStamp& ts, uint32_t frames, uint32_t bytesPerFrame) {
+    const RTShmRing::RingView& ring = playback_.ring;
+    if (!ring) return false;
+    if (bytesPerFrame != ring.control->bytesPerFrame) {
+        // Stream format and ring geometry disagree; never write a partial frame layout.
+        localOverrunCounter_++;
+        return false;
+    }
+    bool success = RTShmRing::push(ring, src, frames, ts);
+    if (success) {
+        // Only enters the kernel when the daemon's reader is parked on an empty ring
+        RTShmRing::SignalReader(ring);
+    } else {
         localOverrunCounter_++;
         if ((localOverrunCounter_ & 0xFF) == 0) {
             os_log_error(OS_LOG_DEFAULT, "%sPushToSharedMemory: Ring buffer OVERRUN! Count: %u", LogPrefix, localOverrunCounter_);
@@ -91,13 +132,63 @@ bool FWADriverHandler::PushToSharedMemory(const AudioBufferList* src, const Audi
     return success;
 }
 
+bool FWADriverHandler::ReadFromSharedMemory(void* dst, uint32_t frames, uint32_t bytesPerFrame) {
+    auto* out = static_cast<std::byte*>(dst);
+    const RTShmRing::RingView& ring = capture_.ring;
+    uint32_t got = 0;
+    if (ring && bytesPerFrame == ring.control->bytesPerFrame) {
+        // Latency bound: drop the oldest frames rather than let a backlog delay input for good
+        if (const uint64_t dropped = RTShmRing::TrimCaptureBacklog(ring, frames)) {
+            if ((localTrimCounter_++ & 0xFF) == 0) {
+                os_log_error(OS_LOG_DEFAULT, "%sReadFromSharedMemory: Capture backlog trimmed by %llu frames. Count: %u",
+                             LogPrefix, static_cast<unsigned long long>(dropped), localTrimCounter_);
+            }
+        }
+        const RTShmRing::FrameSpans spans = RTShmRing::PeekFrames(ring, frames);
+        if (spans.firstFrames) {
+            std::memcpy(out, spans.first, size_t(spans.firstFrames) * bytesPerFrame);
+        }
+        if (spans.secondFrames) {
+            std::memcpy(out + size_t(spans.firstFrames) * bytesPerFrame, spans.second, size_t(spans.secondFrames) * bytesPerFrame);
+        }
+        got = spans.frames();
+        RTShmRing::ConsumeFrames(ring, got);
+    }
+    if (got < frames) {
+        std::memset(out + size_t(got) * bytesPerFrame, 0, size_t(frames - got) * bytesPerFrame);
+        if (ring) {
+            localUnderrunCounter_++;
+            if ((localUnderrunCounter_ & 0xFF) == 1) {
+                os_log_error(OS_LOG_DEFAULT, "%sReadFromSharedMemory: Capture ring UNDERRUN (%u of %u frames). Count: %u", LogPrefix, got, frames, localUnderrunCounter_);
+            }
+        }
+    }
+    return got == frames;
+}
+
+bool FWADriverHandler::ReadBusClock(RTShmRing::ClockSnapshot& out) const {
+    if (!playback_.ring) return false;
+    RTShmRing::ClockSnapshot snapshot;
+    if (!RTShmRing::ReadClock(*playback_.ring.control, snapshot) || !snapshot.valid()) return false;
+    out = snapshot;
+    return true;
+}
+
 OSStatus FWADriverHandler::OnStartIO() {
     os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: OnStartIO called.", LogPrefix);
-    if (!controlBlock_ || !ringBuffer_) {
+    if (!playback_.ring) {
         os_log_error(OS_LOG_DEFAULT, "%sFWADriverHandler: ERROR - Cannot StartIO, shared memory not set up.", LogPrefix);
         return kAudioHardwareUnspecifiedError;
     }
     localOverrunCounter_ = 0;
+    localUnderrunCounter_ = 0;
+    localTrimCounter_ = 0;
+    // The receiver kept filling the capture ring while IO was stopped; start from live input
+    if (capture_.ring) {
+        const uint64_t stale = RTShmRing::DropOldestFrames(capture_.ring, 0);
+        os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: Discarded %llu stale capture frames.", LogPrefix,
+               static_cast<unsigned long long>(stale));
+    }
     os_log(OS_LOG_DEFAULT, "%sFWADriverHandler: STUB - Assuming Daemon started IO successfully.", LogPrefix);
     return kAudioHardwareNoError;
 }
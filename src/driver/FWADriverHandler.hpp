@@ -23,20 +23,38 @@ public:
     void TeardownSharedMemory();
 
     // Helper for device to check SHM state
-    bool IsSharedMemoryReady() const { return controlBlock_ && ringBuffer_; }
-    // Helper for device to push audio data
-    bool PushToSharedMemory(const AudioBufferList* src, const AudioTimeStamp& ts, uint32_t frames, uint32_t bytesPerFrame);
+    bool IsSharedMemoryReady() const { return static_cast<bool>(playback_.ring); }
+    // Helper for device to push interleaved audio frames
+    bool PushToSharedMemory(const void* src, const AudioTimeStamp& ts, uint32_t frames, uint32_t bytesPerFrame);
+
+    // Capture (daemon -> driver) ring; optional, input is silent without it
+    bool IsCaptureReady() const { return static_cast<bool>(capture_.ring); }
+    // Helper for device to pull interleaved input frames; zero-fills whatever the ring cannot supply
+    bool ReadFromSharedMemory(void* dst, uint32_t frames, uint32_t bytesPerFrame);
+
+    // Bus clock published by the daemon's PLL into the playback segment; false until it has locked
+    bool ReadBusClock(RTShmRing::ClockSnapshot& out) const;
 
 private:
+    // One mapped POSIX shared-memory segment holding one RTShmRing
+    struct MappedSegment {
+        void* ptr = nullptr;        // Raw pointer to the mapped memory
+        int fd = -1;                // File descriptor for POSIX shared memory
+        size_t size = 0;            // Total size of the mapped region
+        bool locked = false;        // mlock succeeded
+        RTShmRing::RingView ring;   // Views into ptr
+    };
+    static bool MapSegment(const std::string& shmName, MappedSegment& seg);
+    static void UnmapSegment(MappedSegment& seg);
+
     // Shared Memory state
-    void* shmPtr_ = nullptr; // Raw pointer to the mapped memory
-    int shmFd_ = -1;         // File descriptor for POSIX shared memory
-    size_t shmSize_ = 0;     // Total size of the mapped region
-    RTShmRing::ControlBlock_POD* controlBlock_ = nullptr; // Pointer into shmPtr_
-    RTShmRing::AudioChunk_POD*   ringBuffer_ = nullptr;   // Pointer into shmPtr_
+    MappedSegment playback_;
+    MappedSegment capture_;
 
-    // Local non-atomic counter for RT thread (see recommendation 2.8)
+    // Local non-atomic counters for RT thread (see recommendation 2.8)
     uint32_t localOverrunCounter_ = 0;
+    uint32_t localUnderrunCounter_ = 0;
+    uint32_t localTrimCounter_ = 0;
     // Add timer mechanism later to periodically update shared atomic counter
 };
 
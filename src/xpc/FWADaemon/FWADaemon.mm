@@ -11,6 +11,7 @@
 #import "shared/SharedMemoryStructures.hpp"
 #import "shared/xpc/RingBufferManager.hpp"
 #import "RingBufferManager.hpp" // Include RingBufferManager
+#include <string>
 
 // +++ ADDED: Define the shared memory name +++
 static const char* kSharedMemoryName = "/fwa_daemon_shm_v1";
@@ -80,7 +81,7 @@ static const char* kSharedMemoryName = "/fwa_daemon_shm_v1";
         os_log_error(OS_LOG_DEFAULT, "[FWADaemon] ERROR: shm_open failed for %s: %{errno}d - %s", kSharedMemoryName, errno, strerror(errno));
         return NO;
     }
-    off_t requiredSize = sizeof(RTShmRing::SharedRingBuffer_POD);
+    off_t requiredSize = static_cast<off_t>(RTShmRing::SegmentBytes(kDefaultRingFramesPow2, kDefaultRingChannels, kDefaultRingBytesPerSample));
     if (isCreator) {
         if (ftruncate(fd, requiredSize) == -1) {
             os_log_error(OS_LOG_DEFAULT, "[FWADaemon] ERROR: ftruncate failed for %s (fd %d): %{errno}d - %s", kSharedMemoryName, fd, errno, strerror(errno));
@@ -98,6 +99,28 @@ static const char* kSharedMemoryName = "/fwa_daemon_shm_v1";
          return NO;
     }
     os_log_info(OS_LOG_DEFAULT, "[FWADaemon] Shared memory '%s' successfully created/mapped.", kSharedMemoryName);
+    [self setupCaptureSharedMemory];
+    return YES;
+}
+
+// Capture ring (daemon -> driver). The driver derives the name from the playback segment name.
+- (BOOL)setupCaptureSharedMemory {
+    const std::string captureName = std::string(kSharedMemoryName) + kCaptureShmSuffix;
+    shm_unlink(captureName.c_str());
+    int fd = shm_open(captureName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+    if (fd == -1) {
+        os_log_error(OS_LOG_DEFAULT, "[FWADaemon] ERROR: shm_open failed for capture segment %s: %{errno}d - %s", captureName.c_str(), errno, strerror(errno));
+        return NO;
+    }
+    off_t requiredSize = static_cast<off_t>(RTShmRing::SegmentBytes(kDefaultCaptureFramesPow2, kDefaultCaptureChannels, kDefaultCaptureBytesPerSample));
+    if (ftruncate(fd, requiredSize) == -1 || !RingBufferManager::instance().mapCapture(fd, true)) {
+        os_log_error(OS_LOG_DEFAULT, "[FWADaemon] ERROR: Failed to size/map capture segment %s: %{errno}d", captureName.c_str(), errno);
+        close(fd);
+        shm_unlink(captureName.c_str());
+        return NO;
+    }
+    close(fd);
+    os_log_info(OS_LOG_DEFAULT, "[FWADaemon] Capture shared memory '%s' created/mapped.", captureName.c_str());
     return YES;
 }
 
@@ -1,6 +1,8 @@
 #include "RingBufferManager.hpp" // Assuming this includes SharedMemoryStructures.hpp
 #include "ShmIsochBridge.hpp"
+#include <shared/ShmAllocation.hpp>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <os/log.h>
 #include <cstring> // For std::memset
@@ -8,9 +10,11 @@
 #include <thread>
 #include <atomic>
 #include <exception> // For std::exception
+#include <memory>
 
 // Define kLog if not already defined globally for this file
 static const char *kLog = "[FWADaemon]";
+static constexpr uint32_t kReaderParkTimeoutUs = 100000; // 100 ms
 
 // --- RingBufferManager Implementation ---
 
@@ -29,50 +33,57 @@ bool RingBufferManager::map(int shmFd, bool isCreator)
         return true; // Already mapped
     }
 
-    shmSize_ = sizeof(RTShmRing::SharedRingBuffer_POD);
-    os_log_info(OS_LOG_DEFAULT, "%s map: Calculated size: %zu", kLog, shmSize_); // Log Size
-
-    void *ptr = ::mmap(nullptr, shmSize_,
-                       PROT_READ | PROT_WRITE, MAP_SHARED,
-                       shmFd, 0);
-    os_log_info(OS_LOG_DEFAULT, "%s map: mmap call completed.", kLog); // Log After mmap call
+    // Segment size is chosen by the creator (ftruncate) from the ring geometry; read it back from the object.
+    struct stat st {};
+    if (::fstat(shmFd, &st) != 0 || st.st_size <= 0) {
+        os_log_error(OS_LOG_DEFAULT, "%s map: fstat failed: %{errno}d", kLog, errno);
+        return false;
+    }
+    shmSize_ = static_cast<size_t>(st.st_size);
+    os_log_info(OS_LOG_DEFAULT, "%s map: Segment size: %zu", kLog, shmSize_); // Log Size
 
-    if (ptr == MAP_FAILED)
+    // Pre-faulted, mlocked and residency-checked so no page fault lands on the IO path
+    RTShmRing::ShmMapping mapping = RTShmRing::MapShm(shmFd, shmSize_);
+    if (!mapping)
     {
         os_log_error(OS_LOG_DEFAULT, "%s map: mmap failed: %{errno}d", kLog, errno);
         // shmFd is closed by caller (FWADaemon.mm)
         return false;
     }
-    os_log_info(OS_LOG_DEFAULT, "%s map: mmap successful, received ptr: %p", kLog, ptr); // Log Success ptr
-
-    // mlock is advisory
-    if (::mlock(ptr, shmSize_) != 0) {
-        os_log(OS_LOG_DEFAULT, "%s map: mlock warning: %{errno}d", kLog, errno);
-    } else {
-         os_log_info(OS_LOG_DEFAULT, "%s map: mlock successful.", kLog);
-    }
+    void *ptr = mapping.base;
+    os_log_info(OS_LOG_DEFAULT, "%s map: mapped %p, page size %zu, huge %zu, locked %zu (errno %d), resident %zu of %zu bytes",
+                kLog, ptr, mapping.pageSize, mapping.hugeBytes, mapping.lockedBytes, mapping.lockErrno,
+                mapping.residentBytes, mapping.bytes);
 
     // Assign pointer
-    shm_ = static_cast<RTShmRing::SharedRingBuffer_POD*>(ptr);
+    shm_ = ptr;
     os_log_info(OS_LOG_DEFAULT, "%s map: shm_ assigned pointer value: %p (should match ptr)", kLog, shm_); // Log shm_ VALUE
 
     if (isCreator) {
         os_log_info(OS_LOG_DEFAULT, "%s map: Initializing (zeroing) mapped memory region as creator...", kLog);
-        std::memset(shm_, 0, shmSize_);
-        shm_->control.abiVersion = kShmVersion;
-        shm_->control.capacity   = kRingCapacityPow2;
-        os_log_info(OS_LOG_DEFAULT, "%s map: Set abiVersion=%u, capacity=%u", kLog, shm_->control.abiVersion, shm_->control.capacity);
+        ring_ = RTShmRing::InitRing(shm_, shmSize_, kDefaultRingFramesPow2, kDefaultRingChannels, kDefaultRingBytesPerSample);
+        if (!ring_) {
+            os_log_error(OS_LOG_DEFAULT, "%s map: ERROR - segment of %zu bytes too small for default ring geometry", kLog, shmSize_);
+        } else {
+            os_log_info(OS_LOG_DEFAULT, "%s map: Set abiVersion=%u, frames=%u, bytesPerFrame=%u, descriptors=%u",
+                kLog, ring_.control->abiVersion, ring_.control->capacityFrames, ring_.control->bytesPerFrame, ring_.control->capacity);
+        }
     } else {
         os_log_info(OS_LOG_DEFAULT, "%s map: Attacher mode, verifying header fields...", kLog);
-        if (shm_->control.abiVersion != kShmVersion || shm_->control.capacity != kRingCapacityPow2) {
-            os_log_error(OS_LOG_DEFAULT, "%s map: ERROR - SHM header mismatch: abiVersion=%u (expected %u), capacity=%u (expected %zu)",
-                kLog, shm_->control.abiVersion, kShmVersion, shm_->control.capacity, kRingCapacityPow2);
-            ::munlock(ptr, shmSize_);
-            ::munmap(ptr, shmSize_);
-            shm_ = nullptr;
-            return false;
+        ring_ = RTShmRing::AttachRing(shm_, shmSize_);
+        if (!ring_) {
+            const auto* header = static_cast<const RTShmRing::ControlBlock_POD*>(shm_);
+            os_log_error(OS_LOG_DEFAULT, "%s map: ERROR - SHM header mismatch: abiVersion=%u (expected %u), frames=%u, segment=%llu, mapped=%zu",
+                kLog, header->abiVersion, kShmVersion, header->capacityFrames,
+                static_cast<unsigned long long>(header->segmentBytes), shmSize_);
         }
     }
+    if (!ring_) {
+        ::munlock(ptr, shmSize_);
+        ::munmap(ptr, shmSize_);
+        shm_ = nullptr;
+        return false;
+    }
 
     // Start the reader thread only after successful initialization
     running_ = true;
@@ -86,6 +97,7 @@ bool RingBufferManager::map(int shmFd, bool isCreator)
     } catch (const std::exception& e) {
          os_log_error(OS_LOG_DEFAULT, "%s map: Exception during thread creation: %{public}s. Aborting map.", kLog, e.what());
          running_ = false;
+         ring_ = {};
          if (shm_) {
             ::munlock(shm_, shmSize_);
             ::munmap(shm_, shmSize_);
@@ -98,6 +110,7 @@ bool RingBufferManager::map(int shmFd, bool isCreator)
     } catch (...) {
          os_log_error(OS_LOG_DEFAULT, "%s map: Unknown exception during thread creation. Aborting map.", kLog);
          running_ = false;
+         ring_ = {};
          if (shm_) {
             ::munlock(shm_, shmSize_);
             ::munmap(shm_, shmSize_);
@@ -109,10 +122,95 @@ bool RingBufferManager::map(int shmFd, bool isCreator)
          return false;
     }
 
+    // The PLL publishes the bus clock into this ring; the bridge steers its resampler from it
+    ShmIsochBridge::instance().setClockSource(ring_.control);
+
     os_log_info(OS_LOG_DEFAULT, "%s map: Exiting function successfully.", kLog); // Log successful exit
     return true;
 }
 
+bool RingBufferManager::mapCapture(int shmFd, bool isCreator)
+{
+    if (captureShm_) {
+        os_log_info(OS_LOG_DEFAULT, "%s mapCapture: Already mapped (%p). Skipping.", kLog, captureShm_);
+        return true;
+    }
+
+    struct stat st {};
+    if (::fstat(shmFd, &st) != 0 || st.st_size <= 0) {
+        os_log_error(OS_LOG_DEFAULT, "%s mapCapture: fstat failed: %{errno}d", kLog, errno);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    RTShmRing::ShmMapping mapping = RTShmRing::MapShm(shmFd, size);
+    if (!mapping) {
+        os_log_error(OS_LOG_DEFAULT, "%s mapCapture: mmap failed: %{errno}d", kLog, errno);
+        return false;
+    }
+    void *ptr = mapping.base;
+    os_log_info(OS_LOG_DEFAULT, "%s mapCapture: page size %zu, locked %zu (errno %d), resident %zu of %zu bytes",
+                kLog, mapping.pageSize, mapping.lockedBytes, mapping.lockErrno, mapping.residentBytes, mapping.bytes);
+
+    RTShmRing::RingView ring = isCreator
+        ? RTShmRing::InitRing(ptr, size, kDefaultCaptureFramesPow2, kDefaultCaptureChannels, kDefaultCaptureBytesPerSample)
+        : RTShmRing::AttachRing(ptr, size);
+    if (!ring) {
+        os_log_error(OS_LOG_DEFAULT, "%s mapCapture: ERROR - capture ring header invalid (creator=%d, mapped=%zu)", kLog, isCreator, size);
+        ::munlock(ptr, size);
+        ::munmap(ptr, size);
+        return false;
+    }
+
+    captureShm_ = ptr;
+    captureShmSize_ = size;
+    captureRing_ = ring;
+    os_log_info(OS_LOG_DEFAULT, "%s mapCapture: Capture ring mapped (frames=%u, bytesPerFrame=%u)",
+        kLog, ring.control->capacityFrames, ring.control->bytesPerFrame);
+    return true;
+}
+
+bool RingBufferManager::mapDirectory(int shmFd, bool isCreator, const RTShmRing::RingSpec* specs, uint32_t count)
+{
+    if (directoryShm_) {
+        os_log_info(OS_LOG_DEFAULT, "%s mapDirectory: Already mapped (%p). Skipping.", kLog, directoryShm_);
+        return true;
+    }
+
+    struct stat st {};
+    if (::fstat(shmFd, &st) != 0 || st.st_size <= 0) {
+        os_log_error(OS_LOG_DEFAULT, "%s mapDirectory: fstat failed: %{errno}d", kLog, errno);
+        return false;
+    }
+    const size_t size = static_cast<size_t>(st.st_size);
+    RTShmRing::ShmMapping mapping = RTShmRing::MapShm(shmFd, size);
+    if (!mapping) {
+        os_log_error(OS_LOG_DEFAULT, "%s mapDirectory: mmap failed: %{errno}d", kLog, errno);
+        return false;
+    }
+    os_log_info(OS_LOG_DEFAULT, "%s mapDirectory: page size %zu, locked %zu (errno %d), resident %zu of %zu bytes",
+                kLog, mapping.pageSize, mapping.lockedBytes, mapping.lockErrno, mapping.residentBytes, mapping.bytes);
+
+    RTShmRing::DirectoryView dir = isCreator
+        ? RTShmRing::InitDirectory(mapping.base, size, specs, count)
+        : RTShmRing::AttachDirectory(mapping.base, size);
+    if (!dir) {
+        os_log_error(OS_LOG_DEFAULT, "%s mapDirectory: ERROR - directory invalid (creator=%d, rings=%u, mapped=%zu)", kLog, isCreator, count, size);
+        RTShmRing::UnmapShm(mapping);
+        return false;
+    }
+
+    directoryShm_ = mapping.base;
+    directoryShmSize_ = size;
+    directory_ = dir;
+    for (uint32_t i = 0; i < dir.count; ++i) {
+        const RTShmRing::DirectoryEntry_POD& e = dir.header->entries[i];
+        os_log_info(OS_LOG_DEFAULT, "%s mapDirectory: ring %u guid=0x%016llx dir=%u frames=%u bytesPerFrame=%u",
+                    kLog, i, static_cast<unsigned long long>(e.guid), e.direction,
+                    dir.rings[i].control->capacityFrames, dir.rings[i].control->bytesPerFrame);
+    }
+    return true;
+}
+
 void RingBufferManager::unmap()
 {
     os_log_info(OS_LOG_DEFAULT, "%s unmap: Entered function.", kLog);
@@ -120,6 +218,7 @@ void RingBufferManager::unmap()
     // --- Signal and Join Thread ---
     if (running_.load()) {
         running_ = false;
+        RTShmRing::WakeReader(ring_); // Reader may be parked on the wakeup word
         os_log_info(OS_LOG_DEFAULT, "%s unmap: Signaled reader thread to stop.", kLog);
         if (reader_.joinable()) {
             os_log_info(OS_LOG_DEFAULT, "%s unmap: Joining reader thread...", kLog);
@@ -141,6 +240,7 @@ void RingBufferManager::unmap()
 
     if (shm_)
     {
+        ShmIsochBridge::instance().setClockSource(nullptr);
         os_log_info(OS_LOG_DEFAULT, "%s unmap: Unmapping memory region %p.", kLog, shm_);
         // No explicit destructor call needed for memset/POD initialization (Option B)
         // If using Option A (placement new), call destructor: shm_->~SharedRingBuffer();
@@ -152,9 +252,30 @@ void RingBufferManager::unmap()
             os_log_error(OS_LOG_DEFAULT, "%s unmap: munmap failed: %{errno}d", kLog, errno);
         }
         shm_ = nullptr; // Set pointer to null after unmapping
+        ring_ = {};
         os_log_info(OS_LOG_DEFAULT, "%s unmap: Memory unmapped.", kLog);
     } else {
         os_log_info(OS_LOG_DEFAULT, "%s unmap: Shared memory pointer was already null.", kLog);
+    }
+    if (captureShm_)
+    {
+        captureRing_ = {};
+        ::munlock(captureShm_, captureShmSize_);
+        if (::munmap(captureShm_, captureShmSize_) != 0) {
+            os_log_error(OS_LOG_DEFAULT, "%s unmap: capture munmap failed: %{errno}d", kLog, errno);
+        }
+        captureShm_ = nullptr;
+        captureShmSize_ = 0;
+    }
+    if (directoryShm_)
+    {
+        directory_ = {};
+        ::munlock(directoryShm_, directoryShmSize_);
+        if (::munmap(directoryShm_, directoryShmSize_) != 0) {
+            os_log_error(OS_LOG_DEFAULT, "%s unmap: directory munmap failed: %{errno}d", kLog, errno);
+        }
+        directoryShm_ = nullptr;
+        directoryShmSize_ = 0;
     }
      os_log_info(OS_LOG_DEFAULT, "%s unmap: Exiting function.", kLog);
 }
@@ -169,14 +290,20 @@ void RingBufferManager::readerLoop()
 {
     os_log_info(OS_LOG_DEFAULT, "%s readerLoop: Thread started.", kLog); // Log thread start
 
-    RTShmRing::AudioChunk_POD localChunk; // Allocate local copy buffer ONCE outside the loop
-
     // Ensure shm_ is valid before entering loop (defensive check)
-    if (!shm_) {
+    if (!shm_ || !ring_) {
         os_log_error(OS_LOG_DEFAULT, "%s readerLoop: Exiting early, shm_ is null.", kLog);
         return;
     }
 
+    // Chunks are popped straight into the bridge's slab. The local buffer only catches chunks the
+    // bridge has no room for (stopped, or its queue is full), so the ring keeps draining.
+    const uint32_t bytesPerFrame = ring_.control->bytesPerFrame;
+    std::unique_ptr<std::byte[]> localAudio(new std::byte[kMaxFramesPerChunk * bytesPerFrame]);
+    RTShmRing::ChunkInfo localChunk;
+    ShmIsochBridge& bridge = ShmIsochBridge::instance();
+    uint64_t droppedChunks = 0;
+
     while (running_.load(std::memory_order_relaxed)) // Use atomic load
     {
         // Check shm_ again inside loop? Paranoid check, maybe remove later.
@@ -185,21 +312,30 @@ void RingBufferManager::readerLoop()
              break;
         }
 
-        if (RTShmRing::pop(shm_->control, shm_->ring, localChunk))
+        if (directConsumer_.load(std::memory_order_acquire))
         {
-            // os_log_debug(OS_LOG_DEFAULT, "%s readerLoop: Popped %u frames @ hostTime %llu",
-            //                kLog, localChunk.frameCount,
-            //                static_cast<unsigned long long>(localChunk.timeStamp.mHostTime));
-
-            // TODO: Ensure ShmIsochBridge::instance() is thread-safe if called from multiple places,
-            // but here it's only called from this single reader thread.
-            ShmIsochBridge::instance().enqueue(localChunk);
+            // A ShmPacketProvider reads the ring in place; stay out of its way.
+            std::this_thread::sleep_for(std::chrono::microseconds(kReaderParkTimeoutUs));
+            continue;
+        }
 
+        std::byte* slot = bridge.reserve();
+        const uint32_t slotFrames = slot ? static_cast<uint32_t>(bridge.maxChunkBytes() / bytesPerFrame) : 0;
+        std::byte* dst = slotFrames ? slot : localAudio.get();
+        if (RTShmRing::pop(ring_, localChunk, dst, slotFrames ? slotFrames : kMaxFramesPerChunk))
+        {
+            if (dst == slot) {
+                bridge.commit(localChunk.dataBytes);
+            } else if ((droppedChunks++ & 0xFF) == 0) {
+                os_log_error(OS_LOG_DEFAULT, "%s readerLoop: bridge queue full or stopped, dropped %llu chunks",
+                             kLog, static_cast<unsigned long long>(droppedChunks));
+            }
         }
         else
         {
-            // Nothing ready – sleep briefly to avoid busy-waiting and burning CPU
-            std::this_thread::sleep_for(std::chrono::microseconds(500)); // 500µs sleep
+            // Nothing ready – park on the shared wakeup word until the driver publishes a chunk.
+            // The timeout only bounds how long a shutdown request can go unnoticed.
+            RTShmRing::WaitForData(ring_, kReaderParkTimeoutUs);
         }
     }
 
@@ -9,11 +9,29 @@ ShmIsochBridge& ShmIsochBridge::instance()
     return g;
 }
 
+ShmIsochBridge::ShmIsochBridge()
+{
+    if (!queue_.allocate(kQCap, kMaxChunkBytes))
+        os_log_error(OS_LOG_DEFAULT, "%s failed to allocate %u x %zu byte slab", kLog, kQCap, kMaxChunkBytes);
+}
+
 // New start: store only the provider interface
-void ShmIsochBridge::start(FWA::Isoch::ITransmitPacketProvider* provider)
+void ShmIsochBridge::start(FWA::Isoch::ITransmitPacketProvider* provider, uint32_t channels)
 {
-    if (running_ || !provider) return;
+    if (running_ || !provider || channels == 0) return;
+    if (!queue_.allocated()) {
+        os_log_error(OS_LOG_DEFAULT, "%s no slab, not starting", kLog);
+        return;
+    }
+    const uint32_t maxFrames = static_cast<uint32_t>(queue_.slotBytes() / (channels * sizeof(int32_t)));
+    resampler_ = std::make_unique<FWA::Isoch::VarispeedResampler>(channels, maxFrames);
+    resampledFrames_ = resampler_->maxOutputFrames(maxFrames);
+    resampled_.reset(new int32_t[size_t(resampledFrames_) * channels]);
+    servo_.reset();
     provider_ = provider;
+    // Whatever the reader committed before the last stop() is stale; the worker is not running,
+    // so this thread is the only consumer
+    queue_.discard();
     running_  = true;
     thread_   = std::thread(&ShmIsochBridge::worker, this);
 }
@@ -21,23 +39,20 @@ void ShmIsochBridge::start(FWA::Isoch::ITransmitPacketProvider* provider)
 void ShmIsochBridge::stop()
 {
     running_ = false;
+    queue_.wake();
     if (thread_.joinable()) thread_.join();
+    // The slab stays allocated: the ring reader may still hold a reservation, which commit()
+    // now drops. Anything already queued is discarded by the next start().
 }
 
 ShmIsochBridge::~ShmIsochBridge() { stop(); }
 
-void ShmIsochBridge::enqueue(const RTShmRing::AudioChunk_POD& chunk)
+void ShmIsochBridge::enqueue(const std::byte* audio, size_t bytes)
 {
-    const size_t wr = writeIdx_.load(std::memory_order_relaxed);
-    const size_t rd = readIdx_.load(std::memory_order_acquire);
-    if (wr - rd >= kQCap)
+    if (!queue_.push(audio, bytes))
     {
-        os_log_error(OS_LOG_DEFAULT, "%s queue overflow", kLog);
-        return;
+        os_log_error(OS_LOG_DEFAULT, "%s queue overflow (%zu bytes, %zu queued)", kLog, bytes, queue_.size());
     }
-    size_t slot     = wr & (kQCap - 1);
-    q_[slot].data.assign(chunk.audio, chunk.audio + chunk.dataBytes);
-    writeIdx_.store(wr + 1, std::memory_order_release);
 }
 
 void ShmIsochBridge::worker()
@@ -45,22 +60,34 @@ void ShmIsochBridge::worker()
     auto* prov = provider_;
     if (!prov) { os_log_error(OS_LOG_DEFAULT, "%s no packet provider", kLog); return; }
 
+    auto& rs = *resampler_;
+    const size_t bytesPerFrame = rs.channels() * sizeof(int32_t);
+
     while (running_)
     {
-        const size_t rd = readIdx_.load(std::memory_order_relaxed);
-        const size_t wr = writeIdx_.load(std::memory_order_acquire);
-
-        if (rd == wr) {                          // queue empty
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        const std::byte* data = nullptr;
+        size_t bytes = 0;
+        if (!queue_.front(data, bytes)) {        // queue empty: block until a commit or stop()
+            queue_.waitForData();
             continue;
         }
 
-        size_t slot = rd & (kQCap - 1);
-        const auto& item = q_[slot];
+        // Nominal step from the PLL's bus/host ratio, corrected towards the provider's target fill
+        double busPerHost = 1.0;
+        if (auto* control = clock_.load(std::memory_order_acquire)) {
+            RTShmRing::ClockSnapshot clock;
+            if (RTShmRing::ReadClock(*control, clock) && clock.valid() && clock.rateScalar > 0.0)
+                busPerHost = clock.rateScalar;
+        }
+        rs.setStep(servo_.update(double(prov->getBufferedBytes()) / bytesPerFrame,
+                                 double(prov->getTargetFillBytes()) / bytesPerFrame, busPerHost));
 
-        if (!prov->pushAudioData(item.data.data(), item.data.size()))
+        const uint32_t frames = rs.process(reinterpret_cast<const int32_t*>(data),
+                                           static_cast<uint32_t>(bytes / bytesPerFrame),
+                                           resampled_.get(), resampledFrames_);
+        if (!prov->pushAudioData(resampled_.get(), frames * bytesPerFrame))
             os_log_error(OS_LOG_DEFAULT, "%s Isoch FIFO overflow", kLog);
 
-        readIdx_.store(rd + 1, std::memory_order_release);
+        queue_.pop();
     }
 }
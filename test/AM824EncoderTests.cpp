@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "Isoch/utils/AM824Encoder.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using FWA::Isoch::AM824InputFormat;
+namespace AM824 = FWA::Isoch::AM824;
+
+namespace {
+
+constexpr AM824InputFormat kFormats[] = { AM824InputFormat::Int32, AM824InputFormat::Float32,
+                                          AM824InputFormat::PackedInt24, AM824InputFormat::Int16 };
+constexpr AM824::Isa kIsas[] = { AM824::Isa::SSE41, AM824::Isa::AVX2, AM824::Isa::NEON };
+
+const char* formatName(AM824InputFormat f)
+{
+    switch (f) {
+    case AM824InputFormat::Int32: return "int32";
+    case AM824InputFormat::Float32: return "float32";
+    case AM824InputFormat::PackedInt24: return "int24";
+    case AM824InputFormat::Int16: return "int16";
+    }
+    return "?";
+}
+
+// Random input plus the awkward values: full scale, just past it, NaN, infinities, denormals.
+std::vector<uint8_t> makeInput(AM824InputFormat format, size_t samples, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint8_t> bytes(samples * AM824::bytesPerSample(format));
+    if (format == AM824InputFormat::Float32) {
+        std::uniform_real_distribution<float> dist(-1.2f, 1.2f);
+        const float specials[] = { 1.0f, -1.0f, 0.99999994f, -1.0000001f, 0.0f, -0.0f,
+                                   std::numeric_limits<float>::quiet_NaN(),
+                                   std::numeric_limits<float>::infinity(),
+                                   -std::numeric_limits<float>::infinity(),
+                                   std::numeric_limits<float>::denorm_min(),
+                                   0.5f / 8388608.0f, 1.5f / 8388608.0f, 2.5f / 8388608.0f };
+        auto* f = reinterpret_cast<float*>(bytes.data());
+        for (size_t i = 0; i < samples; ++i) {
+            f[i] = (i % 7 == 3) ? specials[(i / 7) % std::size(specials)] : dist(rng);
+        }
+    } else {
+        for (auto& b : bytes) b = uint8_t(rng());
+    }
+    return bytes;
+}
+
+} // namespace
+
+TEST_CASE("AM824 scalar reference produces labelled big-endian quadlets", "[am824]")
+{
+    const int32_t ints[] = { 0, 1, -1, 0x7FFFFF, -0x800000, 0x12345678 };
+    uint32_t out[6];
+    AM824::kernel(AM824InputFormat::Int32, AM824::Isa::Scalar)(ints, 6, out);
+    const uint8_t* b = reinterpret_cast<const uint8_t*>(out);
+    const uint8_t expect[] = { 0x40, 0x00, 0x00, 0x00,  0x40, 0x00, 0x00, 0x01,  0x40, 0xFF, 0xFF, 0xFF,
+                               0x40, 0x7F, 0xFF, 0xFF,  0x40, 0x80, 0x00, 0x00,  0x40, 0x34, 0x56, 0x78 };
+    CHECK(std::memcmp(b, expect, sizeof(expect)) == 0);
+
+    const float floats[] = { 0.0f, 1.0f, -1.0f, 0.5f, std::numeric_limits<float>::quiet_NaN() };
+    AM824::kernel(AM824InputFormat::Float32, AM824::Isa::Scalar)(floats, 5, out);
+    CHECK(b[1] == 0x00);
+    CHECK((b[5] == 0x7F && b[6] == 0xFF && b[7] == 0xFF));         // +1.0 clamps to full scale
+    CHECK((b[9] == 0x80 && b[10] == 0x00 && b[11] == 0x00));
+    CHECK((b[13] == 0x40 && b[14] == 0x00 && b[15] == 0x00));      // 0.5 -> 0x400000
+    CHECK((b[17] == 0x80 && b[18] == 0x00 && b[19] == 0x00));      // NaN -> negative full scale
+
+    const uint8_t packed[] = { 0x56, 0x34, 0x12, 0xFF, 0xFF, 0xFF };
+    AM824::kernel(AM824InputFormat::PackedInt24, AM824::Isa::Scalar)(packed, 2, out);
+    CHECK((b[0] == 0x40 && b[1] == 0x12 && b[2] == 0x34 && b[3] == 0x56));
+    CHECK((b[4] == 0x40 && b[5] == 0xFF && b[6] == 0xFF && b[7] == 0xFF));
+
+    const int16_t shorts[] = { 0x1234, -1, 0x7FFF, -0x8000 };
+    AM824::kernel(AM824InputFormat::Int16, AM824::Isa::Scalar)(shorts, 4, out);
+    const uint8_t expect16[] = { 0x40, 0x12, 0x34, 0x00,  0x40, 0xFF, 0xFF, 0x00,
+                                 0x40, 0x7F, 0xFF, 0x00,  0x40, 0x80, 0x00, 0x00 };
+    CHECK(std::memcmp(b, expect16, sizeof(expect16)) == 0);
+}
+
+TEST_CASE("AM824 input formats carrying the same audio encode identically", "[am824]")
+{
+    // Every 16-bit value, in each format's own representation of it
+    constexpr size_t kSamples = 65536;
+    std::vector<int16_t> i16(kSamples);
+    std::vector<int32_t> i32(kSamples);
+    std::vector<float> f32(kSamples);
+    std::vector<uint8_t> p24(kSamples * 3);
+    for (size_t i = 0; i < kSamples; ++i) {
+        const int16_t v = int16_t(uint16_t(i));
+        const int32_t s24 = int32_t(v) * 256;
+        i16[i] = v;
+        i32[i] = s24;
+        f32[i] = float(v) / 32768.0f;
+        p24[i * 3] = uint8_t(s24);
+        p24[i * 3 + 1] = uint8_t(s24 >> 8);
+        p24[i * 3 + 2] = uint8_t(s24 >> 16);
+    }
+    std::vector<uint32_t> ref(kSamples), out(kSamples);
+    AM824::encode(AM824InputFormat::Int32, i32.data(), kSamples, ref.data());
+    AM824::encode(AM824InputFormat::Int16, i16.data(), kSamples, out.data());
+    CHECK(out == ref);
+    AM824::encode(AM824InputFormat::Float32, f32.data(), kSamples, out.data());
+    CHECK(out == ref);
+    AM824::encode(AM824InputFormat::PackedInt24, p24.data(), kSamples, out.data());
+    CHECK(out == ref);
+}
+
+TEST_CASE("AM824 SIMD kernels are bit-exact with the scalar reference", "[am824]")
+{
+    INFO("active: " << AM824::isaName(AM824::activeIsa()));
+    int tested = 0;
+    for (AM824::Isa isa : kIsas) {
+        for (AM824InputFormat format : kFormats) {
+            AM824::EncodeFn simd = AM824::kernel(format, isa);
+            if (!simd) continue;
+            ++tested;
+            AM824::EncodeFn ref = AM824::kernel(format, AM824::Isa::Scalar);
+            // Every length up to a few vectors (tails and the int24 over-read guard), odd channel
+            // counts, and a start offset so the input is not vector aligned.
+            for (size_t samples = 0; samples <= 70; ++samples) {
+                for (size_t offset : { size_t(0), size_t(1) }) {
+                    const size_t bps = AM824::bytesPerSample(format);
+                    auto input = makeInput(format, samples + 1, uint32_t(samples * 31 + offset));
+                    // The slice ends exactly at the end of the allocation, so an over-read faults
+                    // under ASan instead of passing silently.
+                    std::vector<uint8_t> slice(input.begin() + offset * bps, input.begin() + (offset + samples) * bps);
+                    std::vector<uint32_t> a(samples + 1, 0xDEADBEEF), b(samples + 1, 0xDEADBEEF);
+                    ref(slice.data(), samples, a.data());
+                    simd(slice.data(), samples, b.data());
+                    INFO(AM824::isaName(isa) << " " << formatName(format) << " samples " << samples);
+                    REQUIRE(a == b);
+                }
+            }
+            // A realistic block: 18 channels x 8 frames
+            auto input = makeInput(format, 18 * 8, 99);
+            std::vector<uint32_t> a(18 * 8), b(18 * 8);
+            ref(input.data(), a.size(), a.data());
+            simd(input.data(), b.size(), b.data());
+            CHECK(a == b);
+        }
+    }
+    // encode() must go through the active kernel
+    auto input = makeInput(AM824InputFormat::Float32, 64, 7);
+    std::vector<uint32_t> a(64), b(64);
+    AM824::kernel(AM824InputFormat::Float32, AM824::Isa::Scalar)(input.data(), 64, a.data());
+    AM824::encode(AM824InputFormat::Float32, input.data(), 64, b.data());
+    CHECK(a == b);
+#if defined(__x86_64__) || defined(__aarch64__)
+    CHECK(tested >= 3);
+#endif
+}
+
+TEST_CASE("AM824 encoder throughput", "[.][benchmark][am824]")
+{
+    // One second of 18 channels at 48 kHz in 8-frame packets is 6000 calls of 144 samples.
+    constexpr size_t kSamples = 18 * 8;
+    for (AM824InputFormat format : kFormats) {
+        auto input = makeInput(format, kSamples, 1);
+        std::vector<uint32_t> out(kSamples);
+        for (AM824::Isa isa : { AM824::Isa::Scalar, AM824::Isa::SSE41, AM824::Isa::AVX2, AM824::Isa::NEON }) {
+            AM824::EncodeFn fn = AM824::kernel(format, isa);
+            if (!fn) continue;
+            BENCHMARK(std::string(formatName(format)) + " " + AM824::isaName(isa) + ", 18ch x 8 frames") {
+                fn(input.data(), kSamples, out.data());
+                return out[0];
+            };
+        }
+    }
+}
@@ -0,0 +1,226 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "Isoch/core/AdaptiveLatencyController.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using FWA::Isoch::AdaptiveLatencyConfig;
+using FWA::Isoch::AdaptiveLatencyController;
+
+namespace {
+
+constexpr uint32_t kCapacity = 8192;   // frames, as the default RTShmRing playback ring
+constexpr uint32_t kWindow = 8000;     // one window per simulated second (8000 packets/s)
+
+AdaptiveLatencyConfig defaultConfig()
+{
+    AdaptiveLatencyConfig cfg;
+    cfg.capacity = kCapacity;
+    cfg.windowObservations = kWindow;
+    return cfg;
+}
+
+// Deterministic xorshift so the traces are identical on every run and platform.
+struct Lcg {
+    uint64_t state;
+    uint32_t next(uint32_t bound)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return bound ? uint32_t(state % (uint64_t(bound) + 1)) : 0;
+    }
+};
+
+// Closed-loop model of the playback path: the driver pushes 512-frame IO cycles whose wakeups are
+// late by up to `jitterTicks` packet periods; the provider pulls 6 frames per packet (48 kHz at
+// 8000 packets/s) and applies the controller exactly like ShmPacketProvider::fillPacketData.
+struct PlaybackSim {
+    static constexpr uint32_t kIoCycle = 512;
+    static constexpr uint32_t kFramesPerPacket = 6;
+
+    AdaptiveLatencyController& ctl;
+    Lcg rng;
+    uint64_t tick = 0;
+    uint64_t nextPush = 0;          // index of the next IO cycle
+    uint64_t nextPushTick = 0;
+    uint32_t fill = 0;
+    bool primed = false;
+    uint32_t underruns = 0;
+    uint32_t overruns = 0;
+    uint64_t fillSum = 0;
+    uint64_t fillSamples = 0;
+    std::vector<uint32_t> targets;  // target at the end of every simulated second
+
+    PlaybackSim(AdaptiveLatencyController& c, uint64_t seed) : ctl(c), rng{seed} {}
+
+    void run(uint64_t seconds, uint32_t jitterTicks)
+    {
+        const uint64_t end = tick + seconds * kWindow;
+        for (; tick < end; ++tick) {
+            // Producer: IO cycle k is due at k * 512 / 6 ticks, delivered late by a random delay.
+            // A late driver thread delivers its backlog at once, in order.
+            while (tick >= nextPushTick) {
+                if (fill + kIoCycle <= kCapacity) fill += kIoCycle; else ++overruns;
+                ++nextPush;
+                const uint64_t due = (nextPush * kIoCycle + kFramesPerPacket - 1) / kFramesPerPacket;
+                const uint64_t late = due + rng.next(jitterTicks);
+                nextPushTick = late > nextPushTick ? late : nextPushTick;
+            }
+
+            // Consumer: one packet per tick.
+            if (!primed) {
+                if (fill < ctl.target()) continue;
+                primed = true;
+            }
+            ctl.observe(fill);
+            if (const uint32_t trim = ctl.trimAmount(fill)) fill -= trim;
+            if (fill >= kFramesPerPacket) {
+                fill -= kFramesPerPacket;
+                fillSum += fill;
+                ++fillSamples;
+            } else {
+                ++underruns;
+                ctl.noteUnderrun();
+                primed = false;
+            }
+            if ((tick + 1) % kWindow == 0) targets.push_back(ctl.target());
+        }
+    }
+
+    double meanFill() const { return fillSamples ? double(fillSum) / double(fillSamples) : 0.0; }
+};
+
+} // namespace
+
+TEST_CASE("Defaults start at the legacy 50% target", "[latency]")
+{
+    AdaptiveLatencyController ctl(defaultConfig());
+    CHECK(ctl.target() == kCapacity / 2);
+    CHECK(ctl.config().minTarget == kCapacity / 16);
+    CHECK(ctl.config().maxTarget == kCapacity * 7 / 8);
+    CHECK(ctl.trimAmount(kCapacity) == 0);
+}
+
+TEST_CASE("A steady trace shrinks the target down to the jitter floor", "[latency]")
+{
+    AdaptiveLatencyController ctl(defaultConfig());
+    // Sawtooth with 600 frames peak-to-peak around 4000.
+    uint32_t previous = ctl.target();
+    for (int window = 0; window < 80; ++window) {
+        for (uint32_t i = 0; i < kWindow; ++i) ctl.observe(3700 + (i * 37) % 601);
+        CHECK(ctl.target() <= previous);   // never grows without cause
+        previous = ctl.target();
+        if (window < 9) CHECK(ctl.target() == kCapacity / 2);   // holds until stableWindowsToShrink
+    }
+    CHECK(ctl.lastJitter() == 600);
+    CHECK(ctl.target() >= 1200);
+    CHECK(ctl.target() <= 1210);
+    CHECK(ctl.growCount() == 0);
+    CHECK(ctl.shrinkCount() > 0);
+}
+
+TEST_CASE("Jitter above the target raises it to the safety floor", "[latency]")
+{
+    AdaptiveLatencyConfig cfg = defaultConfig();
+    cfg.initialTarget = 1000;
+    AdaptiveLatencyController ctl(cfg);
+    for (uint32_t i = 0; i < kWindow; ++i) ctl.observe(i % 2 ? 200 : 1700);
+    CHECK(ctl.lastJitter() == 1500);
+    CHECK(ctl.target() == 3000);
+    CHECK(ctl.growCount() == 1);
+}
+
+TEST_CASE("Underruns grow the target once per window up to the maximum", "[latency]")
+{
+    AdaptiveLatencyConfig cfg = defaultConfig();
+    cfg.initialTarget = 1024;
+    AdaptiveLatencyController ctl(cfg);
+
+    ctl.noteUnderrun();
+    CHECK(ctl.target() == 1536);
+    ctl.noteUnderrun();                      // same window: no runaway
+    CHECK(ctl.target() == 1536);
+
+    for (int window = 0; window < 10; ++window) {
+        for (uint32_t i = 0; i < kWindow; ++i) ctl.observe(100);
+        ctl.noteUnderrun();
+    }
+    CHECK(ctl.target() == ctl.config().maxTarget);
+    CHECK(ctl.shrinkCount() == 0);
+}
+
+TEST_CASE("Trimming only happens after the target was lowered", "[latency]")
+{
+    AdaptiveLatencyConfig cfg = defaultConfig();
+    cfg.stableWindowsToShrink = 1;
+    AdaptiveLatencyController ctl(cfg);
+    for (uint32_t i = 0; i < kWindow; ++i) ctl.observe(4000 + i % 100);
+    REQUIRE(ctl.target() < kCapacity / 2);
+    CHECK(ctl.trimAmount(ctl.target() + 10) == 0);          // within the jitter allowance
+    const uint32_t trim = ctl.trimAmount(4500);
+    CHECK(trim == 4500 - ctl.target());
+    CHECK(ctl.trimAmount(4500) == 0);                       // one trim per shrink
+
+    ctl.reset();
+    CHECK(ctl.target() == kCapacity / 2);
+    CHECK(ctl.lastJitter() == 0);
+}
+
+TEST_CASE("Simulation: a quiet machine ends up with far less latency and no underruns", "[latency][sim]")
+{
+    AdaptiveLatencyController ctl(defaultConfig());
+    PlaybackSim sim(ctl, 0x5eed);
+
+    sim.run(5, 4);
+    const double earlyFill = sim.meanFill();
+    const uint32_t earlyUnderruns = sim.underruns;
+    sim.run(55, 4);
+
+    CHECK(earlyUnderruns == 0);
+    CHECK(sim.underruns == 0);
+    CHECK(sim.overruns == 0);
+    CHECK(ctl.target() < kCapacity / 4);
+    CHECK(ctl.target() >= 2 * ctl.lastJitter() - 1);
+    CHECK(sim.meanFill() < earlyFill);
+}
+
+TEST_CASE("Simulation: scheduling jitter grows the target until underruns stop", "[latency][sim]")
+{
+    AdaptiveLatencyController ctl(defaultConfig());
+    PlaybackSim sim(ctl, 0xfeed);
+
+    sim.run(40, 4);                 // settle low on a quiet machine
+    const uint32_t settled = ctl.target();
+    REQUIRE(sim.underruns == 0);
+
+    sim.run(30, 300);               // driver wakeups now up to ~37 ms late
+    const uint32_t afterAdapting = sim.underruns;
+    CHECK(afterAdapting > 0);
+    CHECK(ctl.target() > settled);
+    CHECK(ctl.growCount() > 0);
+
+    sim.run(20, 300);               // same conditions, now absorbed
+    CHECK(sim.underruns == afterAdapting);
+    CHECK(sim.overruns == 0);
+
+    sim.run(120, 4);                // machine quiets down again: latency comes back down
+    CHECK(ctl.target() < sim.targets[69]);
+    CHECK(sim.underruns == afterAdapting);
+}
+
+TEST_CASE("Simulation is deterministic for a given trace", "[latency][sim]")
+{
+    auto runOnce = [] {
+        AdaptiveLatencyController ctl(defaultConfig());
+        PlaybackSim sim(ctl, 42);
+        sim.run(20, 4);
+        sim.run(20, 250);
+        return sim.targets;
+    };
+    const std::vector<uint32_t> a = runOnce();
+    const std::vector<uint32_t> b = runOnce();
+    REQUIRE(a.size() == 40);
+    CHECK(a == b);
+}
@@ -0,0 +1,124 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "Isoch/core/AmdtpStreamFormat.hpp"
+#include "Isoch/utils/AM824Encoder.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+using FWA::Isoch::AmdtpStreamFormat;
+using FWA::Isoch::AmdtpTransmissionMode;
+namespace AM824 = FWA::Isoch::AM824;
+
+TEST_CASE("AmdtpStreamFormat sizes packets from the data block size", "[streamformat]")
+{
+    struct Expect { uint32_t channels, midi, payload, irm; };
+    // 44.1/48 kHz: 8 data blocks per packet
+    const Expect cases[] = {
+        {  2, 0,  64,  72 },    // the old hardwired stereo layout
+        {  8, 0, 256, 264 },
+        { 10, 0, 320, 328 },
+        { 18, 0, 576, 584 },
+        {  8, 1, 288, 296 },    // 8 analog + one MIDI slot
+        { 16, 2, 576, 584 },
+    };
+    for (const auto& c : cases) {
+        for (uint32_t rate : { 44100u, 48000u }) {
+            AmdtpStreamFormat f{ c.channels, c.midi, rate };
+            INFO(c.channels << "+" << c.midi << " @ " << rate);
+            CHECK(f.isValid());
+            CHECK(f.dataBlockSize() == c.channels + c.midi);
+            CHECK(f.framesPerPacket() == 8);
+            CHECK(f.payloadBytes() == c.payload);
+            CHECK(f.irmPayloadBytes() == c.irm);
+        }
+    }
+
+    AmdtpStreamFormat f{ 18, 0, 96000 };
+    CHECK(f.framesPerPacket() == 16);
+    CHECK(f.payloadBytes() == 16 * 18 * 4);
+    f.sampleRate = 192000;
+    CHECK(f.framesPerPacket() == 32);
+    CHECK(f.irmPayloadBytes() == 8 + 32 * 18 * 4);
+
+    CHECK_FALSE((AmdtpStreamFormat{ 0, 1, 48000 }.isValid()));
+    CHECK_FALSE((AmdtpStreamFormat{ 250, 6, 48000 }.isValid()));   // DBS > 255
+    CHECK_FALSE((AmdtpStreamFormat{ 2, 0, 22050 }.isValid()));
+}
+
+TEST_CASE("Non-blocking AmdtpStreamFormat sizes packets for its fullest cycle", "[streamformat]")
+{
+    struct Expect { uint32_t rate, frames, syt; };
+    const Expect cases[] = {
+        {  32000,  4,  8 }, {  44100,  6,  8 }, {  48000,  6,  8 },
+        {  88200, 12, 16 }, {  96000, 12, 16 }, { 176400, 23, 32 }, { 192000, 24, 32 },
+    };
+    for (const auto& c : cases) {
+        AmdtpStreamFormat f{ 10, 1, c.rate, AmdtpTransmissionMode::NonBlocking };
+        INFO(c.rate << " Hz");
+        CHECK(f.isValid());
+        CHECK(f.framesPerPacket() == c.frames);
+        CHECK(f.sytInterval() == c.syt);
+        CHECK(f.payloadBytes() == c.frames * 11 * 4);
+        CHECK(f.irmPayloadBytes() == 8 + c.frames * 11 * 4);
+        // Smaller packets than blocking mode, so less bandwidth to reserve
+        CHECK(f.irmPayloadBytes() < (AmdtpStreamFormat{ 10, 1, c.rate }.irmPayloadBytes()));
+    }
+}
+
+TEST_CASE("AmdtpStreamFormat writes CIP headers with the stream's DBS", "[streamformat]")
+{
+    for (uint32_t channels : { 2u, 8u, 10u, 18u }) {
+        AmdtpStreamFormat f{ channels, 0, 48000 };
+        uint8_t h[8];
+        f.writeCIPHeader(h, 0x02, 0xA8, f.sfc(), 0x1234);
+        const uint8_t expect[8] = { 0x02, uint8_t(channels), 0x00, 0xA8, 0x90, 0x02, 0x12, 0x34 };
+        INFO(channels << " channels");
+        CHECK(std::memcmp(h, expect, 8) == 0);
+
+        f.writeCIPHeader(h, 0x7F, 0x10, AmdtpStreamFormat::kFdfNoData, 0xFFFF);
+        const uint8_t noData[8] = { 0x3F, uint8_t(channels), 0x00, 0x10, 0x90, 0xFF, 0xFF, 0xFF };
+        CHECK(std::memcmp(h, noData, 8) == 0);
+    }
+
+    AmdtpStreamFormat mixed{ 8, 1, 44100 };
+    uint8_t h[8];
+    mixed.writeCIPHeader(h, 0, 0, mixed.sfc(), 0);
+    CHECK(h[1] == 9);
+    CHECK(h[5] == 0x01);
+}
+
+TEST_CASE("AM824 data blocks carry audio then empty MIDI slots", "[streamformat][am824]")
+{
+    AmdtpStreamFormat f{ 10, 2, 48000 };
+    const uint32_t frames = f.framesPerPacket();
+    std::vector<int32_t> audio(frames * f.audioChannels);
+    for (size_t i = 0; i < audio.size(); ++i) audio[i] = int32_t(i + 1);
+
+    std::vector<uint32_t> packet(f.payloadBytes() / 4, 0xDEADBEEF);
+    AM824::encode(FWA::Isoch::AM824InputFormat::Int32, audio.data(), audio.size(), packet.data());
+    AM824::spreadDataBlocks(packet.data(), frames, f.audioChannels, f.dataBlockSize());
+
+    const auto* b = reinterpret_cast<const uint8_t*>(packet.data());
+    for (uint32_t fr = 0; fr < frames; ++fr) {
+        for (uint32_t s = 0; s < f.dataBlockSize(); ++s) {
+            const uint8_t* q = b + (fr * f.dataBlockSize() + s) * 4;
+            INFO("frame " << fr << " slot " << s);
+            if (s < f.audioChannels) {
+                const uint32_t v = fr * f.audioChannels + s + 1;
+                CHECK(q[0] == 0x40);
+                CHECK(q[1] == uint8_t(v >> 16));
+                CHECK(q[2] == uint8_t(v >> 8));
+                CHECK(q[3] == uint8_t(v));
+            } else {
+                CHECK((q[0] == 0x80 && q[1] == 0 && q[2] == 0 && q[3] == 0));
+            }
+        }
+    }
+
+    // Pure audio formats are left untouched
+    std::vector<uint32_t> stereo = { 1, 2, 3, 4 };
+    AM824::spreadDataBlocks(stereo.data(), 2, 2, 2);
+    CHECK(stereo == std::vector<uint32_t>{ 1, 2, 3, 4 });
+}
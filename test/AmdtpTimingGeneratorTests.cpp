@@ -0,0 +1,289 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "Isoch/core/AmdtpTimingGenerator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using FWA::Isoch::AmdtpTimingGenerator;
+using FWA::Isoch::AmdtpTransmissionMode;
+using FWA::Isoch::CycleTiming;
+using FWA::Isoch::kAmdtpRates;
+
+namespace {
+
+constexpr uint64_t kTicksPerCycle = AmdtpTimingGenerator::kTicksPerCycle;
+
+// Independent model on an unbounded 64-bit tick axis: packet k is presented at
+// floor(k * interval * 24576000 / rate) ticks after the start cycle.
+struct Reference {
+    uint64_t rate, interval, delay, startTick;
+    uint64_t k = 0;
+
+    uint64_t packetTick() const { return startTick + k * interval * 24576000 / rate; }
+
+    CycleTiming at(uint64_t cycle) {
+        CycleTiming t;
+        t.dbc = uint8_t(k * interval);
+        if (packetTick() / kTicksPerCycle == cycle) {
+            const uint64_t syt = packetTick() + delay;
+            t.syt = uint16_t((((syt / kTicksPerCycle) & 0xF) << 12) | (syt % kTicksPerCycle));
+            t.dataBlocks = uint8_t(interval);
+            ++k;
+        }
+        return t;
+    }
+};
+
+// Non-blocking: frame m is presented at floor(m * 24576000 / rate) ticks after the start cycle
+// and goes out in that cycle; SYT is the time of the block whose DBC is a multiple of interval.
+struct NonBlockingReference {
+    uint64_t rate, interval, delay, startTick;
+    uint8_t firstDbc = 0;
+    uint64_t m = 0;
+
+    uint64_t frameTick(uint64_t frame) const { return startTick + frame * 24576000 / rate; }
+
+    CycleTiming at(uint64_t cycle) {
+        CycleTiming t;
+        t.dbc = uint8_t(firstDbc + m);
+        for (; frameTick(m) / kTicksPerCycle == cycle; ++m) {
+            if ((firstDbc + m) % interval == 0) {
+                const uint64_t syt = frameTick(m) + delay;
+                t.syt = uint16_t((((syt / kTicksPerCycle) & 0xF) << 12) | (syt % kTicksPerCycle));
+            }
+            ++t.dataBlocks;
+        }
+        return t;
+    }
+};
+
+} // namespace
+
+TEST_CASE("Rate table covers every IEC 61883-6 rate", "[timing]")
+{
+    const uint32_t rates[] = { 32000, 44100, 48000, 88200, 96000, 176400, 192000 };
+    const uint8_t sfcs[] = { 0, 1, 2, 3, 4, 5, 6 };
+    const uint32_t intervals[] = { 8, 8, 8, 16, 16, 32, 32 };
+    for (size_t i = 0; i < std::size(rates); ++i) {
+        AmdtpTimingGenerator gen(rates[i]);
+        REQUIRE(gen.isValid());
+        CHECK(gen.sfc() == sfcs[i]);
+        CHECK(gen.framesPerPacket() == intervals[i]);
+        const auto& r = kAmdtpRates[i];
+        // whole + remainder/denominator is exactly interval * 24576000 / rate
+        CHECK(uint64_t(r.ticksPerPacket) * r.ticksDenominator + r.ticksRemainder ==
+              uint64_t(intervals[i]) * 24576000 * r.ticksDenominator / rates[i]);
+    }
+    CHECK_FALSE(AmdtpTimingGenerator(22050).isValid());
+    CHECK(AmdtpTimingGenerator(22050).next().dataBlocks == 0);
+}
+
+TEST_CASE("Timing generator matches the exact reference across the 128 s wrap", "[timing]")
+{
+    // 200 s per rate, starting one second before the cycle counter wraps (it wraps twice)
+    constexpr uint32_t kCycles = 200 * AmdtpTimingGenerator::kCyclesPerSecond;
+    const uint32_t start = AmdtpTimingGenerator::kCyclesPerWrap - AmdtpTimingGenerator::kCyclesPerSecond;
+
+    for (const auto& rate : kAmdtpRates) {
+        for (uint32_t delay : { 0u, AmdtpTimingGenerator::kDefaultTransferDelayTicks, 3071u }) {
+            AmdtpTimingGenerator gen(rate.sampleRate, delay);
+            gen.reset(start);
+            Reference ref{ rate.sampleRate, rate.sytInterval, delay, uint64_t(start) * kTicksPerCycle };
+
+            uint64_t frames = 0, mismatches = 0, wrapped = 0;
+            for (uint64_t c = start; c < uint64_t(start) + kCycles; ++c) {
+                if (gen.cycle() != c % AmdtpTimingGenerator::kCyclesPerWrap) ++mismatches;
+                if (gen.cycle() == 0) ++wrapped;
+                const CycleTiming got = gen.next();
+                const CycleTiming want = ref.at(c);
+                if (got.dataBlocks != want.dataBlocks || got.dbc != want.dbc || got.syt != want.syt) {
+                    if (mismatches++ == 0) {
+                        INFO("rate " << rate.sampleRate << " delay " << delay << " cycle " << c);
+                        CHECK(got.dataBlocks == want.dataBlocks);
+                        CHECK(got.dbc == want.dbc);
+                        CHECK(got.syt == want.syt);
+                    }
+                }
+                frames += got.dataBlocks;
+            }
+            INFO("rate " << rate.sampleRate << " delay " << delay);
+            CHECK(mismatches == 0);
+            CHECK(wrapped == 2);
+            // Exactly the nominal rate, give or take the packet in flight
+            CHECK(frames >= uint64_t(rate.sampleRate) * 200 - rate.sytInterval);
+            CHECK(frames <= uint64_t(rate.sampleRate) * 200 + rate.sytInterval);
+        }
+    }
+}
+
+TEST_CASE("Timing generator follows blocking-mode DBC and SYT rules", "[timing]")
+{
+    SECTION("empty packets carry the next data packet's DBC")
+    {
+        AmdtpTimingGenerator gen(48000);
+        uint8_t sent = 0;
+        for (int i = 0; i < 8000; ++i) {
+            const CycleTiming t = gen.next();
+            CHECK(t.dbc == sent);
+            if (t.hasData()) {
+                CHECK(t.dataBlocks == 8);
+                sent = uint8_t(sent + 8);
+            } else {
+                CHECK(t.syt == 0xFFFF);
+            }
+        }
+    }
+    SECTION("48 kHz sends three packets in every four cycles")
+    {
+        AmdtpTimingGenerator gen(48000);
+        for (int i = 0; i < 400; ++i) CHECK(gen.next().hasData() == (i % 4 != 3));
+    }
+    SECTION("32 kHz sends every other cycle")
+    {
+        AmdtpTimingGenerator gen(32000);
+        for (int i = 0; i < 400; ++i) CHECK(gen.next().hasData() == (i % 2 == 0));
+    }
+    SECTION("44.1 kHz SYT offsets step 1386 or 1387 ticks, 34 long steps per 147 packets")
+    {
+        AmdtpTimingGenerator gen(44100, 0);
+        std::vector<uint32_t> offsets;
+        while (offsets.size() < 147 * 20 + 1) {
+            const CycleTiming t = gen.next();
+            if (t.hasData()) offsets.push_back(t.syt & 0xFFF);
+        }
+        uint32_t longSteps = 0, bad = 0;
+        for (size_t i = 1; i < offsets.size(); ++i) {
+            const uint32_t step = (offsets[i] + 3072 - offsets[i - 1]) % 3072;
+            if (step == 1387) ++longSteps;
+            else if (step != 1386) ++bad;
+        }
+        CHECK(bad == 0);
+        CHECK(longSteps == 34 * 20);
+    }
+    SECTION("cycle-timer values map to cycle indices")
+    {
+        CHECK(AmdtpTimingGenerator::cycleIndex(0) == 0);
+        CHECK(AmdtpTimingGenerator::cycleIndex((5u << 25) | (7999u << 12) | 3071u) == 5 * 8000 + 7999);
+        CHECK(AmdtpTimingGenerator::cycleIndex((127u << 25) | (7999u << 12)) ==
+              AmdtpTimingGenerator::kCyclesPerWrap - 1);
+    }
+}
+
+TEST_CASE("Non-blocking timing matches the exact reference across the 128 s wrap", "[timing]")
+{
+    constexpr uint32_t kCycles = 200 * AmdtpTimingGenerator::kCyclesPerSecond;
+    const uint32_t start = AmdtpTimingGenerator::kCyclesPerWrap - AmdtpTimingGenerator::kCyclesPerSecond;
+
+    for (const auto& rate : kAmdtpRates) {
+        for (uint32_t delay : { 0u, AmdtpTimingGenerator::kDefaultTransferDelayTicks }) {
+            for (uint8_t firstDbc : { uint8_t(0), uint8_t(5) }) {   // a resync keeps whatever DBC it had
+                AmdtpTimingGenerator gen(rate.sampleRate, delay, AmdtpTransmissionMode::NonBlocking);
+                gen.reset(start, firstDbc);
+                NonBlockingReference ref{ rate.sampleRate, rate.sytInterval, delay, uint64_t(start) * kTicksPerCycle,
+                                          firstDbc };
+
+                uint64_t frames = 0, sytPackets = 0, mismatches = 0;
+                for (uint64_t c = start; c < uint64_t(start) + kCycles; ++c) {
+                    const CycleTiming got = gen.next();
+                    const CycleTiming want = ref.at(c);
+                    if (got.dataBlocks != want.dataBlocks || got.dbc != want.dbc || got.syt != want.syt) {
+                        if (mismatches++ == 0) {
+                            INFO("rate " << rate.sampleRate << " delay " << delay << " cycle " << c);
+                            CHECK(got.dataBlocks == want.dataBlocks);
+                            CHECK(got.dbc == want.dbc);
+                            CHECK(got.syt == want.syt);
+                        }
+                    }
+                    frames += got.dataBlocks;
+                    sytPackets += got.syt != 0xFFFF;
+                }
+                INFO("rate " << rate.sampleRate << " delay " << delay << " first DBC " << int(firstDbc));
+                CHECK(mismatches == 0);
+                // Whole seconds: exactly the nominal rate, one SYT per SYT_INTERVAL frames
+                CHECK(frames == uint64_t(rate.sampleRate) * 200);
+                CHECK(sytPackets == frames / rate.sytInterval);
+            }
+        }
+    }
+}
+
+TEST_CASE("Non-blocking mode puts data in every cycle", "[timing]")
+{
+    for (const auto& rate : kAmdtpRates) {
+        AmdtpTimingGenerator gen(rate.sampleRate, 0, AmdtpTransmissionMode::NonBlocking);
+        const uint32_t least = rate.sampleRate / 8000;
+        CHECK(gen.framesPerPacket() == (rate.sampleRate + 7999) / 8000);
+
+        uint8_t dbc = 0;
+        uint64_t bad = 0;
+        for (uint32_t s = 0; s < 5; ++s) {
+            uint64_t frames = 0;
+            for (uint32_t c = 0; c < 8000; ++c) {
+                const CycleTiming t = gen.next();
+                bad += t.dbc != dbc;
+                bad += t.dataBlocks < least || t.dataBlocks > gen.framesPerPacket();
+                dbc = uint8_t(dbc + t.dataBlocks);
+                frames += t.dataBlocks;
+            }
+            INFO("rate " << rate.sampleRate << " second " << s);
+            CHECK(frames == rate.sampleRate);
+        }
+        CHECK(bad == 0);
+    }
+
+    SECTION("44.1 kHz alternates 5 and 6 blocks, 4410 sixes per second")
+    {
+        AmdtpTimingGenerator gen(44100, 0, AmdtpTransmissionMode::NonBlocking);
+        uint32_t sixes = 0;
+        for (int c = 0; c < 8000; ++c) sixes += gen.next().dataBlocks == 6;
+        CHECK(sixes == 44100 - 5 * 8000);
+    }
+    SECTION("48 kHz sends 6 blocks in every cycle and SYT in three of every four")
+    {
+        AmdtpTimingGenerator gen(48000, 0, AmdtpTransmissionMode::NonBlocking);
+        for (int c = 0; c < 400; ++c) {
+            const CycleTiming t = gen.next();
+            CHECK(t.dataBlocks == 6);
+            CHECK((t.syt != 0xFFFF) == (c % 4 != 3));
+        }
+    }
+}
+
+TEST_CASE("Non-blocking mode sends each frame in the cycle it is presented in", "[timing]")
+{
+    // How far ahead of its presentation time each frame goes out, over 10 s at 44.1 kHz
+    auto spread = [](AmdtpTransmissionMode mode) {
+        AmdtpTimingGenerator gen(44100, 0, mode);
+        uint64_t frame = 0, lead = 0, leastLead = UINT64_MAX;
+        for (uint64_t c = 0; c < 10 * 8000; ++c) {
+            const CycleTiming t = gen.next();
+            for (uint32_t b = 0; b < t.dataBlocks; ++b, ++frame) {
+                const uint64_t presented = frame * 24576000 / 44100;
+                const uint64_t cycleStart = c * kTicksPerCycle;
+                REQUIRE(presented + kTicksPerCycle > cycleStart);   // never late
+                const uint64_t ahead = presented + kTicksPerCycle - cycleStart;
+                lead = std::max(lead, ahead);
+                leastLead = std::min(leastLead, ahead);
+            }
+        }
+        return lead - leastLead;
+    };
+    const uint64_t blocking = spread(AmdtpTransmissionMode::Blocking);
+    const uint64_t nonBlocking = spread(AmdtpTransmissionMode::NonBlocking);
+    INFO("lead spread: blocking " << blocking << " ticks, non-blocking " << nonBlocking << " ticks");
+    CHECK(nonBlocking < kTicksPerCycle);
+    CHECK(blocking > 2 * kTicksPerCycle);
+}
+
+TEST_CASE("Timing generator cost per cycle", "[.][benchmark][timing]")
+{
+    AmdtpTimingGenerator gen(44100);
+    BENCHMARK("44.1 kHz, 8000 cycles") {
+        uint32_t acc = 0;
+        for (int i = 0; i < 8000; ++i) acc += gen.next().syt;
+        return acc;
+    };
+}
@@ -0,0 +1,247 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "Isoch/core/DCLSegmentTable.hpp"
+#include "Isoch/core/AmdtpStreamFormat.hpp"
+#include "Isoch/core/AmdtpTimingGenerator.hpp"
+#include "Isoch/utils/AM824Encoder.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// Allocation-counting hook: every operator new in this test binary goes through here.
+// Counting is only switched on around the code under test, so Catch2's own allocations
+// (assertion bookkeeping, section tracking) are never included.
+namespace {
+std::atomic<bool> gCountAllocations{false};
+std::atomic<uint64_t> gAllocations{0};
+
+void* countedAlloc(std::size_t n) {
+    if (gCountAllocations.load(std::memory_order_relaxed))
+        gAllocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+
+struct AllocationCounter {
+    AllocationCounter() { gAllocations = 0; gCountAllocations = true; }
+    ~AllocationCounter() { gCountAllocations = false; }
+    uint64_t count() const { return gAllocations.load(); }
+};
+} // namespace
+
+void* operator new(std::size_t n) { return countedAlloc(n); }
+void* operator new[](std::size_t n) { return countedAlloc(n); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept {
+    try { return countedAlloc(n); } catch (...) { return nullptr; }
+}
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept {
+    try { return countedAlloc(n); } catch (...) { return nullptr; }
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+using FWA::Isoch::AmdtpStreamFormat;
+using FWA::Isoch::AmdtpTimingGenerator;
+using FWA::Isoch::AmdtpTransmissionMode;
+using FWA::Isoch::CycleTiming;
+using FWA::Isoch::DCLSegmentTable;
+namespace AM824 = FWA::Isoch::AM824;
+
+namespace {
+
+// Stand-in for IOVirtualRange
+struct Range {
+    uintptr_t address;
+    uintptr_t length;
+};
+
+using Table = DCLSegmentTable<Range>;
+
+// Host model of the transmit DCL program: DMA memory, a table filled the way
+// IsochTransmitDCLManager::createDCLProgram fills it, and counters standing in for
+// SetDCLRanges / Notify.
+struct FakeProgram {
+    static constexpr uint32_t kGroups = 8, kPacketsPerGroup = 16;   // TransmitterConfig defaults
+    static constexpr uint32_t kPackets = kGroups * kPacketsPerGroup;
+
+    AmdtpStreamFormat format;
+    AmdtpTimingGenerator timing;
+    std::vector<uint8_t> cip;
+    std::vector<uint32_t> payload;
+    std::vector<int32_t> audio;
+    std::vector<int> dclStorage;                 // distinct addresses to act as DCL refs
+    Table table;
+    uint64_t setRangesCalls = 0, notifiedDCLs = 0, badNotifies = 0, payloadBytes = 0;
+
+    explicit FakeProgram(AmdtpStreamFormat f)
+        : format(f), timing(f.sampleRate, AmdtpTimingGenerator::kDefaultTransferDelayTicks, f.mode),
+          cip(kPackets * AmdtpStreamFormat::kCIPHeaderBytes),
+          payload(kPackets * f.payloadBytes() / 4),
+          audio(f.framesPerPacket() * f.audioChannels, 0x123456),
+          dclStorage(kPackets)
+    {
+        table.build(kGroups, kPacketsPerGroup);
+        for (uint32_t i = 0; i < kPackets; ++i) {
+            Range r[2] = { { uintptr_t(cipPtr(i)), 8 }, { uintptr_t(payloadPtr(i)), f.payloadBytes() } };
+            table.setDCL(i, &dclStorage[i], r, 2);
+        }
+    }
+
+    uint8_t* cipPtr(uint32_t i) { return &cip[i * AmdtpStreamFormat::kCIPHeaderBytes]; }
+    uint32_t* payloadPtr(uint32_t i) { return &payload[i * format.payloadBytes() / 4]; }
+
+    // What AmdtpTransmitter::handleDCLComplete does for one group, minus IOKit
+    void fillGroup(uint32_t g) {
+        for (uint32_t p = 0; p < kPacketsPerGroup; ++p) {
+            const uint32_t i = g * kPacketsPerGroup + p;
+            const CycleTiming t = timing.next();
+            format.writeCIPHeader(cipPtr(i), 0, t.dbc, t.hasData() ? format.sfc() : AmdtpStreamFormat::kFdfNoData, t.syt);
+            Range r[2] = { { uintptr_t(cipPtr(i)), 8 }, {} };
+            uint32_t n = 1;
+            if (t.hasData()) {
+                AM824::encode(FWA::Isoch::AM824InputFormat::Int32, audio.data(), t.dataBlocks * format.audioChannels,
+                              payloadPtr(i));
+                AM824::spreadDataBlocks(payloadPtr(i), t.dataBlocks, format.audioChannels, format.dataBlockSize());
+                r[1] = { uintptr_t(payloadPtr(i)), t.dataBlocks * format.bytesPerDataBlock() };
+                payloadBytes += r[1].length;
+                n = 2;
+            }
+            if (!table.isUnchanged(i, r, n)) {
+                ++setRangesCalls;
+                table.remember(i, r, n);
+            }
+        }
+        void** dcls = table.segment(g);
+        for (uint32_t k = 0; k < table.segmentSize(); ++k) {
+            if (dcls[k] != &dclStorage[g * kPacketsPerGroup + k]) ++badNotifies;
+        }
+        notifiedDCLs += table.segmentSize();
+    }
+};
+
+} // namespace
+
+TEST_CASE("DCLSegmentTable lays out segments in program order", "[dcl]")
+{
+    Table table;
+    CHECK_FALSE(table.isComplete());
+    table.build(4, 3);
+    CHECK(table.packetCount() == 12);
+    CHECK(table.segmentSize() == 3);
+    CHECK_FALSE(table.isComplete());
+
+    int dcls[12];
+    const Range r[1] = { { 0x1000, 8 } };
+    for (uint32_t i = 0; i < 12; ++i) table.setDCL(i, &dcls[i], r, 1);
+    CHECK(table.isComplete());
+
+    for (uint32_t g = 0; g < 4; ++g) {
+        void** seg = table.segment(g);
+        REQUIRE(seg != nullptr);
+        for (uint32_t p = 0; p < 3; ++p) CHECK(seg[p] == &dcls[g * 3 + p]);
+    }
+    CHECK(table.segment(4) == nullptr);
+
+    table.clear();
+    CHECK(table.packetCount() == 0);
+    CHECK(table.segment(0) == nullptr);
+}
+
+TEST_CASE("DCLSegmentTable reports whether a packet's ranges changed", "[dcl]")
+{
+    Table table;
+    table.build(1, 2);
+    const Range data[2] = { { 0x1000, 8 }, { 0x2000, 64 } };
+    table.setDCL(0, nullptr, data, 2);
+
+    CHECK(table.isUnchanged(0, data, 2));
+    CHECK_FALSE(table.isUnchanged(0, data, 1));           // DATA -> NO_DATA
+    const Range shorter[2] = { { 0x1000, 8 }, { 0x2000, 32 } };
+    CHECK_FALSE(table.isUnchanged(0, shorter, 2));
+    const Range moved[2] = { { 0x1000, 8 }, { 0x3000, 64 } };
+    CHECK_FALSE(table.isUnchanged(0, moved, 2));
+
+    table.remember(0, data, 1);
+    CHECK(table.isUnchanged(0, data, 1));
+    CHECK_FALSE(table.isUnchanged(0, data, 2));
+
+    table.invalidate(0);
+    CHECK_FALSE(table.isUnchanged(0, data, 1));
+
+    // Nothing recorded yet for packet 1, and more ranges than are tracked never match
+    CHECK_FALSE(table.isUnchanged(1, data, 0));
+    const Range three[3] = { { 1, 1 }, { 2, 2 }, { 3, 3 } };
+    table.remember(1, three, 3);
+    CHECK_FALSE(table.isUnchanged(1, three, 3));
+}
+
+TEST_CASE("Steady-state segment refill performs no heap allocations", "[dcl][alloc]")
+{
+    for (uint32_t rate : { 44100u, 48000u, 96000u }) {
+        FakeProgram program(AmdtpStreamFormat{ 10, 1, rate });
+
+        // Warm-up lap: the first pass may change every DCL's ranges
+        for (uint32_t g = 0; g < FakeProgram::kGroups; ++g) program.fillGroup(g);
+        const uint64_t warmupSets = program.setRangesCalls;
+        program.setRangesCalls = 0;
+
+        constexpr uint32_t kCallbacks = 8000;   // 128000 packets: 16 s of stream, 1000 laps of the ring
+        uint64_t allocations;
+        {
+            AllocationCounter counter;
+            for (uint32_t c = 0; c < kCallbacks; ++c) program.fillGroup(c % FakeProgram::kGroups);
+            allocations = counter.count();
+        }
+
+        INFO(rate << " Hz");
+        CHECK(allocations == 0);
+        CHECK(program.badNotifies == 0);
+        CHECK(program.notifiedDCLs == uint64_t(kCallbacks + FakeProgram::kGroups) * FakeProgram::kPacketsPerGroup);
+        CHECK(warmupSets > 0);
+        if (rate != 44100) {
+            // 128 slots is a whole number of DATA / NO_DATA periods (4 or 1 cycles) at 48 kHz
+            // family rates: every slot repeats its previous lap, so SetDCLRanges is never needed
+            CHECK(program.setRangesCalls == 0);
+        } else {
+            // The 44.1 kHz pattern drifts against the ring, so some slots change state each lap
+            CHECK(program.setRangesCalls > 0);
+            CHECK(program.setRangesCalls < uint64_t(kCallbacks) * FakeProgram::kPacketsPerGroup / 2);
+        }
+    }
+}
+
+TEST_CASE("Non-blocking refill sizes each payload range to its cycle's data blocks", "[dcl][alloc]")
+{
+    for (uint32_t rate : { 44100u, 48000u }) {
+        FakeProgram program(AmdtpStreamFormat{ 10, 1, rate, AmdtpTransmissionMode::NonBlocking });
+        for (uint32_t g = 0; g < FakeProgram::kGroups; ++g) program.fillGroup(g);
+        program.setRangesCalls = 0;
+        program.payloadBytes = 0;
+
+        constexpr uint32_t kCallbacks = 8000;   // 16 s
+        uint64_t allocations;
+        {
+            AllocationCounter counter;
+            for (uint32_t c = 0; c < kCallbacks; ++c) program.fillGroup(c % FakeProgram::kGroups);
+            allocations = counter.count();
+        }
+
+        INFO(rate << " Hz");
+        CHECK(allocations == 0);
+        CHECK(program.badNotifies == 0);
+        // Every cycle carried data, and together exactly the nominal rate
+        const uint64_t frames = program.payloadBytes / program.format.bytesPerDataBlock();
+        CHECK(frames + 1 >= uint64_t(rate) * 16);
+        CHECK(frames <= uint64_t(rate) * 16 + 1);
+        if (rate == 48000) {
+            CHECK(program.setRangesCalls == 0);   // 6 blocks in every packet: ranges never change
+        } else {
+            CHECK(program.setRangesCalls > 0);    // 5 or 6 blocks: the length follows the cycle
+        }
+    }
+}
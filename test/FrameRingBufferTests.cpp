@@ -0,0 +1,141 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "Isoch/utils/FrameRingBuffer.hpp"
+#include "Isoch/utils/RingBuffer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using raul::FrameRingBuffer;
+
+namespace {
+
+struct TimedFrame {                              // same shape as ProcessedAudioFrame
+    float    l;
+    float    r;
+    uint64_t ns;
+};
+
+} // namespace
+
+TEST_CASE("FrameRingBuffer rounds up and uses every slot", "[framering]")
+{
+    FrameRingBuffer<int32_t, 2> rb(100);
+    CHECK(rb.capacity() == 128);
+    CHECK(rb.write_space() == 128);
+    CHECK(rb.read_space() == 0);
+
+    std::vector<int32_t> in(2 * 200), out(2 * 200);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = int32_t(i);
+
+    CHECK(rb.write_frames(in.data(), 200) == 128);   // partial: whole frames only
+    CHECK(rb.write_space() == 0);
+    CHECK(rb.write_frames(in.data(), 1) == 0);
+    CHECK(rb.read_frames(out.data(), 200) == 128);
+    CHECK(std::equal(out.begin(), out.begin() + 256, in.begin()));
+    CHECK(rb.read_frames(out.data(), 1) == 0);
+}
+
+TEST_CASE("FrameRingBuffer keeps frames intact across the wrap", "[framering]")
+{
+    FrameRingBuffer<TimedFrame> rb(8);
+    TimedFrame in[5], out[5];
+    uint64_t next = 0, expect = 0;
+    for (int round = 0; round < 50; ++round) {
+        const uint32_t n = 1 + round % 5;
+        for (uint32_t i = 0; i < n; ++i) in[i] = { float(next), -float(next), next }, ++next;
+        REQUIRE(rb.write_frames(in, n) == n);
+        TimedFrame peeked;
+        REQUIRE(rb.peek_frames(&peeked, 1) == 1);
+        CHECK(peeked.ns == expect);
+        REQUIRE(rb.read_frames(out, n) == n);
+        for (uint32_t i = 0; i < n; ++i, ++expect) {
+            CHECK(out[i].ns == expect);
+            CHECK(out[i].l == float(expect));
+            CHECK(out[i].r == -float(expect));
+        }
+    }
+    CHECK(rb.skip_frames(3) == 0);
+    REQUIRE(rb.write_frames(in, 5) == 5);
+    CHECK(rb.skip_frames(3) == 3);
+    CHECK(rb.read_space() == 2);
+    rb.reset();
+    CHECK(rb.read_space() == 0);
+    CHECK(rb.write_space() == 8);
+}
+
+TEST_CASE("FrameRingBuffer producer and consumer threads agree", "[framering]")
+{
+    constexpr uint32_t kFrames = 1'000'000;
+    FrameRingBuffer<uint32_t, 4> rb(1024);
+
+    std::thread producer([&] {
+        uint32_t block[4 * 37];
+        for (uint32_t next = 0; next < kFrames;) {
+            const uint32_t want = std::min<uint32_t>(37, kFrames - next);
+            for (uint32_t i = 0; i < want; ++i)
+                for (uint32_t c = 0; c < 4; ++c) block[i * 4 + c] = (next + i) * 4 + c;
+            const uint32_t n = rb.write_frames(block, want);
+            if (n == 0) std::this_thread::yield();
+            // Frames that did not fit are regenerated on the next pass.
+            next += n;
+        }
+    });
+
+    uint32_t block[4 * 64];
+    uint32_t expect = 0, bad = 0;
+    while (expect < kFrames) {
+        const uint32_t n = rb.read_frames(block, 64);
+        if (n == 0) { std::this_thread::yield(); continue; }
+        for (uint32_t i = 0; i < n * 4; ++i)
+            if (block[i] != expect * 4 + i) ++bad;
+        expect += n;
+    }
+    producer.join();
+    CHECK(bad == 0);
+    CHECK(rb.read_space() == 0);
+}
+
+TEST_CASE("FrameRingBuffer throughput against the byte ring", "[.][benchmark][framering]")
+{
+    // Receiver-shaped traffic: 8-frame packets in, 256-frame chunks out.
+    constexpr uint32_t kPacket = 8, kChunk = 256;
+    std::vector<TimedFrame> in(kChunk), out(kChunk);
+
+    FrameRingBuffer<TimedFrame> frames(32768);
+    BENCHMARK("FrameRingBuffer, 8-frame writes") {
+        for (uint32_t p = 0; p < kChunk; p += kPacket) frames.write_frames(in.data() + p, kPacket);
+        return frames.read_frames(out.data(), kChunk);
+    };
+
+    raul::RingBuffer bytes(32768 * sizeof(TimedFrame));
+    BENCHMARK("raul::RingBuffer, per-frame writes") {
+        for (uint32_t i = 0; i < kChunk; ++i) bytes.write(sizeof(TimedFrame), &in[i]);
+        return bytes.read(kChunk * sizeof(TimedFrame), out.data());
+    };
+
+    BENCHMARK_ADVANCED("FrameRingBuffer, two threads, 1M frames")(Catch::Benchmark::Chronometer meter) {
+        meter.measure([&] {
+            FrameRingBuffer<TimedFrame> rb(4096);
+            constexpr uint32_t kTotal = 1 << 20;
+            std::thread producer([&] {
+                for (uint32_t sent = 0; sent < kTotal;) {
+                    const uint32_t n = rb.write_frames(in.data(), std::min(kPacket, kTotal - sent));
+                    if (n == 0) std::this_thread::yield();
+                    sent += n;
+                }
+            });
+            std::vector<TimedFrame> sink(kChunk);
+            for (uint32_t got = 0; got < kTotal;) {
+                const uint32_t n = rb.read_frames(sink.data(), kChunk);
+                if (n == 0) std::this_thread::yield();
+                got += n;
+            }
+            producer.join();
+            return rb.read_space();
+        });
+    };
+}
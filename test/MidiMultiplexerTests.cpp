@@ -0,0 +1,214 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "Isoch/core/MidiMultiplexer.hpp"
+#include "Isoch/utils/AM824Encoder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using FWA::Isoch::MidiMultiplexer;
+namespace AM824 = FWA::Isoch::AM824;
+
+namespace {
+
+constexpr uint32_t kAudioMarker = 0xA5A5A5A5;
+
+// One port's share of the stream, decoded from the MIDI slots as a receiver would
+struct Received {
+    std::vector<uint8_t> bytes;
+    std::vector<uint64_t> blocks;   // data block index each byte arrived in
+};
+
+// Sends packets of blocksPerPacket data blocks, DBC running on from firstDbc as in the CIP
+// headers, and demultiplexes them again by DBC mod 8
+struct Stream {
+    MidiMultiplexer& mux;
+    uint32_t audio, midi, blocksPerPacket;
+    uint8_t dbc;
+    uint64_t block = 0;
+    std::vector<Received> ports;
+    std::vector<uint32_t> packet;
+    uint64_t badLabels = 0, audioClobbered = 0;
+
+    Stream(MidiMultiplexer& m, uint32_t audioSlots, uint32_t blocks, uint8_t firstDbc = 0)
+        : mux(m), audio(audioSlots), midi(m.ports() / MidiMultiplexer::kPortsPerSlot),
+          blocksPerPacket(blocks), dbc(firstDbc), ports(m.ports()),
+          packet(size_t(blocks) * (audioSlots + midi)) {}
+
+    void sendPacket() {
+        const uint32_t dbs = audio + midi;
+        std::fill(packet.begin(), packet.end(), kAudioMarker);
+        mux.fill(packet.data(), blocksPerPacket, dbs, audio, dbc);
+        for (uint32_t f = 0; f < blocksPerPacket; ++f, ++block) {
+            const uint32_t* b = &packet[size_t(f) * dbs];
+            for (uint32_t s = 0; s < audio; ++s) audioClobbered += b[s] != kAudioMarker;
+            for (uint32_t s = 0; s < midi; ++s) {
+                const uint32_t q = __builtin_bswap32(b[audio + s]);
+                const uint32_t label = q >> 24;
+                if (label == AM824::kMidiLabel && (q & 0xFFFFFF) == 0) continue;
+                if (label != AM824::kMidiLabel + 1 || (q & 0xFFFF) != 0) { ++badLabels; continue; }
+                Received& r = ports[s * 8 + uint8_t(dbc + f) % 8];
+                r.bytes.push_back(uint8_t(q >> 16));
+                r.blocks.push_back(block);
+            }
+        }
+        dbc = uint8_t(dbc + blocksPerPacket);
+    }
+
+    void run(uint64_t packets) { for (uint64_t i = 0; i < packets; ++i) sendPacket(); }
+};
+
+} // namespace
+
+TEST_CASE("MIDI bytes come out on their own port, in order, in MPX-MIDI slots", "[midi]")
+{
+    for (uint32_t blocksPerPacket : { 8u, 16u }) {   // SYT_INTERVAL at 48 and 96 kHz
+        for (uint8_t firstDbc : { uint8_t(0), uint8_t(5), uint8_t(250) }) {
+            MidiMultiplexer mux(2, 48000);
+            REQUIRE(mux.ports() == 16);
+
+            // Each port gets its own messages: note on/off on its own channel, plus a sysex
+            std::vector<std::vector<uint8_t>> sent(16);
+            for (uint32_t p = 0; p < 16; ++p) {
+                for (uint8_t n = 0; n < 20; ++n) {
+                    const uint8_t on[] = { uint8_t(0x90 | (p & 0xF)), uint8_t(p * 7 + n), 100 };
+                    const uint8_t off[] = { uint8_t(0x80 | (p & 0xF)), uint8_t(p * 7 + n), 0 };
+                    REQUIRE(mux.push(p, on, 3));
+                    REQUIRE(mux.push(p, off, 3));
+                    sent[p].insert(sent[p].end(), on, on + 3);
+                    sent[p].insert(sent[p].end(), off, off + 3);
+                }
+                const uint8_t sysex[] = { 0xF0, 0x7E, uint8_t(p), 0x06, 0x01, 0xF7 };
+                REQUIRE(mux.push(p, sysex, sizeof(sysex)));
+                sent[p].insert(sent[p].end(), sysex, sysex + sizeof(sysex));
+            }
+
+            Stream stream(mux, 6, blocksPerPacket, firstDbc);
+            stream.run(48000 / blocksPerPacket);   // one second
+
+            INFO(blocksPerPacket << " blocks per packet, first DBC " << int(firstDbc));
+            CHECK(stream.badLabels == 0);
+            CHECK(stream.audioClobbered == 0);
+            for (uint32_t p = 0; p < 16; ++p) {
+                CHECK(stream.ports[p].bytes == sent[p]);
+                CHECK(mux.queued(p) == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE("A saturated MIDI port is held to 3125 bytes per second", "[midi]")
+{
+    for (uint32_t rate : { 44100u, 48000u, 96000u, 192000u }) {
+        const uint32_t blocksPerPacket = rate >= 176400 ? 32 : rate >= 88200 ? 16 : 8;
+        constexpr uint32_t kSeconds = 10;
+
+        MidiMultiplexer mux(1, rate);
+        Stream stream(mux, 2, blocksPerPacket);
+        const uint8_t chunk[64] = {};
+        for (uint64_t i = 0; i < uint64_t(kSeconds) * rate / blocksPerPacket; ++i) {
+            // Keep every queue topped up: the producer is always ahead of the wire
+            for (uint32_t p = 0; p < mux.ports(); ++p)
+                while (mux.queued(p) < 512) REQUIRE(mux.push(p, chunk, sizeof(chunk)));
+            stream.sendPacket();
+        }
+        const uint64_t expected = stream.block * MidiMultiplexer::kBytesPerSecond / rate;
+
+        INFO(rate << " Hz");
+        CHECK(stream.badLabels == 0);
+        for (uint32_t p = 0; p < mux.ports(); ++p) {
+            const Received& r = stream.ports[p];
+            INFO("port " << p);
+            // Long run: the wire rate, to within the one byte the last opportunity can leave pending
+            CHECK(r.bytes.size() + 1 >= expected);
+            CHECK(r.bytes.size() <= expected + 1);
+            // Every one-second window, wherever it starts: no bursts above the rate
+            size_t lo = 0, worst = 0, least = SIZE_MAX;
+            for (size_t hi = 0; hi < r.blocks.size(); ++hi) {
+                while (r.blocks[hi] - r.blocks[lo] >= rate) ++lo;
+                worst = std::max(worst, hi - lo + 1);
+                if (r.blocks[hi] >= rate) least = std::min(least, hi - lo + 1);
+            }
+            CHECK(worst <= MidiMultiplexer::kBytesPerSecond + 1);
+            CHECK(least >= MidiMultiplexer::kBytesPerSecond - 1);
+        }
+    }
+}
+
+TEST_CASE("An idle MIDI port earns no burst credit", "[midi]")
+{
+    MidiMultiplexer mux(1, 48000);
+    Stream stream(mux, 2, 8);
+    stream.run(6000);   // one idle second
+
+    std::vector<uint8_t> burst(600, 0x42);
+    REQUIRE(mux.push(3, burst.data(), burst.size()));
+    const uint64_t start = stream.block;
+    stream.run(600);    // 100 ms
+
+    const Received& r = stream.ports[3];
+    // 100 ms at 3125 bytes/s, plus the byte the first opportunity sends at once
+    CHECK(r.bytes.size() <= 313 + 1);
+    CHECK(r.bytes.size() >= 312);
+    REQUIRE(!r.blocks.empty());
+    CHECK(r.blocks.front() - start < 8);
+
+    SECTION("reset() drops queued bytes and restarts the clock")
+    {
+        mux.reset();
+        CHECK(mux.queued(3) == 0);
+        const uint8_t b = 0xF8;
+        REQUIRE(mux.push(3, &b, 1));
+        const size_t before = r.bytes.size();
+        stream.run(1);
+        REQUIRE(r.bytes.size() == before + 1);
+        CHECK(r.bytes.back() == 0xF8);
+    }
+}
+
+TEST_CASE("MIDI push is all or nothing and rejects unknown ports", "[midi]")
+{
+    MidiMultiplexer mux(1, 48000, 64);
+    const uint8_t msg[3] = { 0x90, 60, 100 };
+    CHECK_FALSE(mux.push(8, msg, 3));
+    CHECK_FALSE(mux.push(0, nullptr, 3));
+    CHECK_FALSE(mux.push(0, msg, 0));
+    for (int i = 0; i < 21; ++i) REQUIRE(mux.push(0, msg, 3));   // 63 bytes: the whole queue
+    CHECK_FALSE(mux.push(0, msg, 3));
+    CHECK(mux.queued(0) == 63);
+
+    MidiMultiplexer none(0, 48000);
+    CHECK(none.ports() == 0);
+    uint32_t block[2] = { kAudioMarker, kAudioMarker };
+    none.fill(block, 1, 2, 2, 0);
+    CHECK(block[1] == kAudioMarker);
+}
+
+TEST_CASE("MIDI bytes pushed from another thread arrive intact", "[midi]")
+{
+    MidiMultiplexer mux(1, 192000, 256);
+    Stream stream(mux, 2, 32);
+    constexpr uint32_t kBytes = 20000;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&] {
+        uint32_t next = 0;
+        while (next < kBytes) {
+            const uint8_t run[4] = { uint8_t(next), uint8_t(next + 1), uint8_t(next + 2), uint8_t(next + 3) };
+            if (mux.push(5, run, 4)) next += 4;
+            else std::this_thread::yield();
+        }
+        done = true;
+    });
+    while (!done.load() || mux.queued(5) > 0) stream.sendPacket();
+    producer.join();
+
+    const Received& r = stream.ports[5];
+    REQUIRE(r.bytes.size() == kBytes);
+    for (uint32_t i = 0; i < kBytes; ++i) {
+        if (r.bytes[i] != uint8_t(i)) FAIL("byte " << i << " out of order");
+    }
+}
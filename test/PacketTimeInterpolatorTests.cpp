@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "Isoch/core/PacketTimeInterpolator.hpp"
+#include "Isoch/core/AmdtpTimingGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+using FWA::Isoch::AmdtpTimingGenerator;
+using FWA::Isoch::PacketTime;
+using FWA::Isoch::PacketTimeInterpolator;
+
+namespace {
+
+constexpr uint32_t kWrap = AmdtpTimingGenerator::kCyclesPerWrap;
+constexpr uint64_t kTicks = AmdtpTimingGenerator::kTicksPerCycle;
+
+// Bus time in offset ticks since the simulation start -> 32-bit cycle-timer value
+uint32_t cycleTimeAt(uint64_t busTicks) {
+    const uint64_t cycle = busTicks / kTicks % kWrap;
+    return uint32_t(((cycle / 8000) << 25) | ((cycle % 8000) << 12) | (busTicks % kTicks));
+}
+
+} // namespace
+
+TEST_CASE("Packet times are exact cycle starts relative to the anchor", "[timestamps]")
+{
+    PacketTimeInterpolator t;
+    CHECK_FALSE(t.isAnchored());
+    CHECK(t.at(100).hostNano == 0);
+    CHECK(t.at(100).cycleTime == 0);
+
+    // Read 1536 ticks (half a cycle) into cycle 3 of second 5, at host time 1 s
+    t.anchor((5u << 25) | (3u << 12) | 1536, 1'000'000'000);
+    REQUIRE(t.isAnchored());
+
+    const PacketTime same = t.at(5 * 8000 + 3);
+    CHECK(same.cycleTime == ((5u << 25) | (3u << 12)));
+    CHECK(same.hostNano == 1'000'000'000 - 62'500);
+
+    const PacketTime later = t.at(5 * 8000 + 3 + 16);
+    CHECK(later.hostNano == same.hostNano + 16 * 125'000);
+    CHECK(later.cycleTime == ((5u << 25) | (19u << 12)));
+
+    // Earlier cycles (the completed group) map before the anchor
+    CHECK(t.at(5 * 8000).hostNano == same.hostNano - 3 * 125'000);
+
+    // Across the second boundary
+    CHECK(t.at(6 * 8000).cycleTime == (6u << 25));
+    CHECK(t.at(6 * 8000).hostNano == same.hostNano + (8000 - 3) * 125'000ull);
+
+    t.reset();
+    CHECK(t.at(5 * 8000).hostNano == 0);
+}
+
+TEST_CASE("Packet times stay continuous across the 128 s cycle-timer wrap", "[timestamps]")
+{
+    PacketTimeInterpolator t;
+    t.anchor(PacketTimeInterpolator::cycleTimeOf(kWrap - 2), 5'000'000'000);
+
+    CHECK(t.at(kWrap - 1).hostNano == 5'000'000'000 + 125'000);
+    CHECK(t.at(0).hostNano == 5'000'000'000 + 2 * 125'000);
+    CHECK(t.at(0).cycleTime == 0);
+    CHECK(t.at(kWrap + 5).cycleTime == PacketTimeInterpolator::cycleTimeOf(5));   // taken mod 128 s
+    CHECK(t.at(kWrap - 10).hostNano == 5'000'000'000 - 8 * 125'000);
+}
+
+TEST_CASE("Per-group anchoring tracks a drifting host clock", "[timestamps]")
+{
+    // Synthetic stream: 8 groups of 16 packets, one completion per group, handled 3 cycles and
+    // some ticks later; the host clock runs 80 ppm fast against the bus and started 42 ms in.
+    constexpr uint32_t kGroups = 8, kPackets = 16, kRing = kGroups * kPackets;
+    constexpr double kHostRate = 1.0 + 80e-6;
+    constexpr double kHostStart = 42e6;
+    auto hostAt = [&](uint64_t busTicks) { return kHostStart + double(busTicks) * 125000.0 / kTicks * kHostRate; };
+
+    const uint64_t startCycle = uint64_t(kWrap) - 3000;   // crosses the wrap part way through
+    PacketTimeInterpolator t;
+    double worstError = 0;
+    uint64_t packetsChecked = 0;
+
+    for (uint64_t lap = 0; lap < 200; ++lap) {
+        for (uint32_t g = 0; g < kGroups; ++g) {
+            // Group g's last packet went out in the completion cycle
+            const uint64_t completionCycle = startCycle + lap * kRing + g * kPackets + kPackets - 1;
+            const uint64_t readTicks = (completionCycle + 3) * kTicks + 1000 + (lap * 37 + g * 101) % kTicks;
+            t.anchor(cycleTimeAt(readTicks), uint64_t(hostAt(readTicks)));
+
+            // The completed group is refilled for its next pass, one ring later
+            for (uint32_t p = 0; p < kPackets; ++p) {
+                const uint64_t cycle = completionCycle + 1 - kPackets + p + kRing;
+                const PacketTime pt = t.at(uint32_t(cycle % kWrap));
+                CHECK(pt.cycleTime == cycleTimeAt(cycle * kTicks));
+                worstError = std::max(worstError, std::fabs(double(pt.hostNano) - hostAt(cycle * kTicks)));
+                ++packetsChecked;
+            }
+        }
+    }
+    INFO(packetsChecked << " packets, worst host-time error " << worstError << " ns");
+    // 80 ppm over at most one ring (16 ms) is ~1.3 us; rounding adds a few ns
+    CHECK(worstError < 80e-6 * kRing * 125000.0 + 5);
+}
@@ -0,0 +1,181 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "Isoch/utils/RingBuffer.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using raul::RingBuffer;
+
+TEST_CASE("RingBuffer reservations cover the wraparound with two regions", "[ringbuffer]")
+{
+    RingBuffer rb(64);
+    REQUIRE(rb.capacity() == 63);
+
+    // Move both heads to offset 48 so a 32-byte reservation wraps.
+    char scratch[48] = {};
+    REQUIRE(rb.write(48, scratch) == 48);
+    REQUIRE(rb.skip(48) == 48);
+
+    auto w = rb.reserve_write(32);
+    REQUIRE(w);
+    CHECK(w.first.size == 16);
+    CHECK(w.second.size == 16);
+    CHECK(w.size() == 32);
+    for (uint32_t i = 0; i < w.first.size; ++i) w.first.data[i] = char(i);
+    for (uint32_t i = 0; i < w.second.size; ++i) w.second.data[i] = char(16 + i);
+
+    CHECK(rb.read_space() == 0);                     // nothing visible before the commit
+    rb.commit_write(32);
+    CHECK(rb.read_space() == 32);
+
+    char out[32];
+    REQUIRE(rb.peek(32, out) == 32);
+    for (int i = 0; i < 32; ++i) CHECK(out[i] == char(i));
+
+    auto r = rb.reserve_read(32);
+    REQUIRE(r);
+    CHECK(r.first.size == 16);
+    CHECK(r.second.size == 16);
+    CHECK(r.first.data[0] == 0);
+    CHECK(r.second.data[0] == 16);
+    rb.commit_read(32);
+    CHECK(rb.read_space() == 0);
+    CHECK(rb.write_space() == 63);
+}
+
+TEST_CASE("RingBuffer reservations are all or nothing", "[ringbuffer]")
+{
+    RingBuffer rb(128);
+    CHECK_FALSE(rb.reserve_read(4));                 // empty
+    CHECK_FALSE(rb.reserve_write(0));
+    CHECK_FALSE(rb.reserve_write(128));              // one byte is always kept free
+
+    auto w = rb.reserve_write(127);
+    REQUIRE(w);
+    CHECK(w.second.size == 0);
+    rb.commit_write(100);                            // commit less than reserved
+    CHECK(rb.read_space() == 100);
+    CHECK_FALSE(rb.reserve_read(101));
+    CHECK(rb.reserve_read(100).size() == 100);
+}
+
+TEST_CASE("RingBuffer in-place producer and consumer agree across threads", "[ringbuffer]")
+{
+    RingBuffer rb(4096);
+    constexpr uint32_t kWords = 2'000'000;
+    constexpr uint32_t kBlock = 96;                  // not a divisor of the size, so blocks wrap
+
+    std::thread producer([&] {
+        uint32_t next = 0;
+        while (next < kWords) {
+            const uint32_t words = std::min(kBlock, kWords - next);
+            auto w = rb.reserve_write(words * 4);
+            if (!w) { std::this_thread::yield(); continue; }
+            for (auto span : { w.first, w.second }) {
+                for (uint32_t off = 0; off < span.size; off += 4, ++next)
+                    std::memcpy(span.data + off, &next, 4);
+            }
+            rb.commit_write(w.size());
+        }
+    });
+
+    uint32_t expect = 0, bad = 0;
+    while (expect < kWords) {
+        const uint32_t words = std::min(kBlock / 2, kWords - expect);
+        auto r = rb.reserve_read(words * 4);
+        if (!r) { std::this_thread::yield(); continue; }
+        for (auto span : { r.first, r.second }) {
+            for (uint32_t off = 0; off < span.size; off += 4, ++expect) {
+                uint32_t v;
+                std::memcpy(&v, span.data + off, 4);
+                if (v != expect) ++bad;
+            }
+        }
+        rb.commit_read(r.size());
+    }
+    producer.join();
+    CHECK(bad == 0);
+    CHECK(rb.read_space() == 0);
+}
+
+TEST_CASE("RingBuffer copy kernels match memcpy at every size and misalignment", "[ringbuffer]")
+{
+    std::vector<raul::copy::Kernels> all{ { raul::copy::scalar, raul::copy::scalar, "scalar" },
+                                          raul::copy::kernels() };
+#ifdef RAUL_COPY_X86
+    all.push_back({ raul::copy::sse2, raul::copy::sse2_stream, "sse2" });
+    if (__builtin_cpu_supports("avx2")) all.push_back({ raul::copy::avx2, raul::copy::avx2_stream, "avx2" });
+#endif
+    std::vector<uint8_t> src(4096 + 64), dst(4096 + 64), ref(4096 + 64);
+    for (size_t i = 0; i < src.size(); ++i) src[i] = uint8_t(i * 131 + 7);
+
+    for (const auto& k : all) {
+        for (raul::copy::Kernel fn : { k.regular, k.streaming }) {
+            for (size_t size : { 0, 1, 15, 16, 127, 128, 129, 255, 1000, 4096 }) {
+                for (size_t off : { 0, 1, 3, 17 }) {
+                    std::fill(dst.begin(), dst.end(), 0xEE);
+                    ref = dst;
+                    std::memcpy(ref.data() + off, src.data() + 5, size);
+                    fn(dst.data() + off, src.data() + 5, size);
+                    INFO(k.name << " size " << size << " offset " << off);
+                    CHECK(dst == ref);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("RingBuffer non-temporal writes round trip", "[ringbuffer]")
+{
+    RingBuffer rb(1 << 16);
+    rb.set_non_temporal_threshold(4096);
+    std::vector<uint8_t> in(40000), out(40000);
+    for (size_t i = 0; i < in.size(); ++i) in[i] = uint8_t(i ^ (i >> 8));
+    for (int pass = 0; pass < 5; ++pass) {          // 5 x 40000 wraps a 64 KB ring
+        REQUIRE(rb.write(uint32_t(in.size()), in.data()) == in.size());
+        REQUIRE(rb.read(uint32_t(out.size()), out.data()) == out.size());
+        CHECK(in == out);
+    }
+}
+
+TEST_CASE("RingBuffer copy throughput, 4 KB to 1 MB rings", "[.][benchmark][ringbuffer]")
+{
+    std::vector<raul::copy::Kernels> all{ { raul::copy::scalar, raul::copy::scalar, "memcpy" } };
+#ifdef RAUL_COPY_X86
+    all.push_back({ raul::copy::sse2, raul::copy::sse2_stream, "sse2" });
+    if (__builtin_cpu_supports("avx2")) all.push_back({ raul::copy::avx2, raul::copy::avx2_stream, "avx2" });
+#elif defined(__ARM_NEON)
+    all.push_back({ raul::copy::neon, raul::copy::neon, "neon" });
+#endif
+
+    for (uint32_t ringBytes : { 4u << 10, 16u << 10, 64u << 10, 256u << 10, 1u << 20 }) {
+        // Half a ring per transfer, alternating halves, like a producer one block ahead.
+        const uint32_t block = ringBytes / 2;
+        std::vector<uint8_t> src(block, 0x5A), ring(ringBytes);
+        for (const auto& k : all) {
+            const std::string size = std::to_string(ringBytes >> 10) + " KB";
+            uint32_t half = 0;
+            BENCHMARK(std::string(k.name) + " " + size) {
+                k.regular(ring.data() + (half ^= block), src.data(), block);
+                return ring[half];
+            };
+            if (k.streaming != k.regular) {
+                BENCHMARK(std::string(k.name) + " non-temporal " + size) {
+                    k.streaming(ring.data() + (half ^= block), src.data(), block);
+                    return ring[half];
+                };
+            }
+        }
+        RingBuffer rb(ringBytes);
+        std::vector<uint8_t> out(block);
+        BENCHMARK("RingBuffer write+read " + std::to_string(ringBytes >> 10) + " KB") {
+            rb.write(block - 64, src.data());
+            return rb.read(block - 64, out.data());
+        };
+    }
+}
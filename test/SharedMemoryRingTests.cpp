@@ -0,0 +1,551 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "shared/SharedMemoryStructures.hpp"
+
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kTestChannels = 2;
+constexpr uint32_t kTestBytesPerSample = 4;
+
+// Deterministic sample value for (absolute frame, channel) so the consumer can verify every byte.
+uint32_t sampleValue(uint64_t frame, uint32_t ch)
+{
+    return static_cast<uint32_t>(frame * 2654435761u) ^ (ch << 28);
+}
+
+void fillFrames(std::vector<uint32_t>& buf, uint64_t startFrame, uint32_t frames)
+{
+    buf.resize(std::size_t(frames) * kTestChannels);
+    for (uint32_t f = 0; f < frames; ++f)
+        for (uint32_t ch = 0; ch < kTestChannels; ++ch)
+            buf[std::size_t(f) * kTestChannels + ch] = sampleValue(startFrame + f, ch);
+}
+
+bool checkFrames(const uint32_t* buf, uint64_t startFrame, uint32_t frames)
+{
+    for (uint32_t f = 0; f < frames; ++f)
+        for (uint32_t ch = 0; ch < kTestChannels; ++ch)
+            if (buf[std::size_t(f) * kTestChannels + ch] != sampleValue(startFrame + f, ch)) return false;
+    return true;
+}
+
+// Chunk sizes vary per sequence number so frames wrap at every possible offset.
+uint32_t chunkFrames(uint64_t seq)
+{
+    return 1 + static_cast<uint32_t>((seq * 37) % 700);
+}
+
+} // namespace
+
+TEST_CASE("RTShmRing layout is sized for the real geometry", "[shm]")
+{
+    const std::size_t bytes = RTShmRing::SegmentBytes(8192, 2, 4);
+    REQUIRE(bytes > 8192u * 8u);
+    REQUIRE(bytes < 8192u * 8u + 64u * 1024u);
+    REQUIRE(bytes % kDestructiveCL == 0);
+
+    REQUIRE(RTShmRing::SegmentBytes(1000, 2, 4) == 0);                 // frames not pow2
+    REQUIRE(RTShmRing::SegmentBytes(1024, 0, 4) == 0);
+    REQUIRE(RTShmRing::SegmentBytes(1024, kMaxChannels + 1, 4) == 0);
+    REQUIRE(RTShmRing::SegmentBytes(1024, 2, 4, 100) == 0);            // descriptors not pow2
+}
+
+TEST_CASE("RTShmRing attach validates the header", "[shm]")
+{
+    const std::size_t bytes = RTShmRing::SegmentBytes(1024, kTestChannels, kTestBytesPerSample);
+    std::vector<std::byte> mem(bytes);
+
+    REQUIRE_FALSE(RTShmRing::AttachRing(mem.data(), mem.size()));      // zeroed: no version yet
+    REQUIRE_FALSE(RTShmRing::InitRing(mem.data(), bytes - 1, 1024, kTestChannels, kTestBytesPerSample));
+
+    auto created = RTShmRing::InitRing(mem.data(), mem.size(), 1024, kTestChannels, kTestBytesPerSample);
+    REQUIRE(created);
+    REQUIRE(created.control->bytesPerFrame == kTestChannels * kTestBytesPerSample);
+
+    auto attached = RTShmRing::AttachRing(mem.data(), mem.size());
+    REQUIRE(attached);
+    REQUIRE(attached.audio == created.audio);
+    REQUIRE_FALSE(RTShmRing::AttachRing(mem.data(), bytes - kDestructiveCL));
+}
+
+TEST_CASE("RTShmRing push/pop copies only the frames written", "[shm]")
+{
+    constexpr uint32_t kFrames = 256;
+    std::vector<std::byte> mem(RTShmRing::SegmentBytes(kFrames, kTestChannels, kTestBytesPerSample, 8));
+    auto ring = RTShmRing::InitRing(mem.data(), mem.size(), kFrames, kTestChannels, kTestBytesPerSample, 8);
+    REQUIRE(ring);
+
+    std::vector<uint32_t> src;
+    std::vector<uint32_t> dst(kMaxFramesPerChunk * kTestChannels, 0xDEADBEEF);
+    RTShmRing::ChunkInfo info;
+
+    REQUIRE_FALSE(RTShmRing::pop(ring, info, dst.data(), kMaxFramesPerChunk));
+
+    // Frame ring full before descriptor ring.
+    fillFrames(src, 0, 200);
+    REQUIRE(RTShmRing::push(ring, src.data(), 200, RTShmRing::TimeStamp_POD{0.0, 1, 1.0, 0, 0}));
+    fillFrames(src, 200, 100);
+    REQUIRE_FALSE(RTShmRing::push(ring, src.data(), 100, RTShmRing::TimeStamp_POD{}));
+    fillFrames(src, 200, 56);
+    REQUIRE(RTShmRing::push(ring, src.data(), 56, RTShmRing::TimeStamp_POD{200.0, 2, 1.0, 0, 0}));
+
+    REQUIRE(RTShmRing::pop(ring, info, dst.data(), kMaxFramesPerChunk));
+    REQUIRE(info.sequence == 1);
+    REQUIRE(info.frameCount == 200);
+    REQUIRE(info.dataBytes == 200 * kTestChannels * kTestBytesPerSample);
+    REQUIRE(info.timeStamp.hostTime == 1);
+    REQUIRE(checkFrames(dst.data(), 0, 200));
+    REQUIRE(dst[200 * kTestChannels] == 0xDEADBEEF);                   // nothing beyond dataBytes touched
+
+    // Wraps around the end of the frame area.
+    fillFrames(src, 256, 150);
+    REQUIRE(RTShmRing::push(ring, src.data(), 150, RTShmRing::TimeStamp_POD{256.0, 3, 1.0, 0, 0}));
+
+    REQUIRE(RTShmRing::pop(ring, info, dst.data(), kMaxFramesPerChunk));
+    REQUIRE(info.sequence == 2);
+    REQUIRE(checkFrames(dst.data(), 200, 56));
+    REQUIRE(RTShmRing::pop(ring, info, dst.data(), kMaxFramesPerChunk));
+    REQUIRE(info.sequence == 3);
+    REQUIRE(info.startFrame == 256);
+    REQUIRE(checkFrames(dst.data(), 256, 150));
+    REQUIRE_FALSE(RTShmRing::pop(ring, info, dst.data(), kMaxFramesPerChunk));
+
+    // Descriptor ring full before frame ring.
+    for (int i = 0; i < 8; ++i) {
+        fillFrames(src, 406 + i, 1);
+        REQUIRE(RTShmRing::push(ring, src.data(), 1, RTShmRing::TimeStamp_POD{}));
+    }
+    REQUIRE_FALSE(RTShmRing::push(ring, src.data(), 1, RTShmRing::TimeStamp_POD{}));
+}
+
+TEST_CASE("RTShmRing survives a cross-process producer/consumer stress run", "[shm][stress]")
+{
+    constexpr uint32_t kFrames = 4096;
+    constexpr uint64_t kChunks = 200000;
+
+    const std::string name = "/fwa_shm_test_" + std::to_string(::getpid());
+    ::shm_unlink(name.c_str());
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    REQUIRE(fd != -1);
+    const std::size_t bytes = RTShmRing::SegmentBytes(kFrames, kTestChannels, kTestBytesPerSample);
+    REQUIRE(::ftruncate(fd, static_cast<off_t>(bytes)) == 0);
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    REQUIRE(base != MAP_FAILED);
+    REQUIRE(RTShmRing::InitRing(base, bytes, kFrames, kTestChannels, kTestBytesPerSample));
+
+    const pid_t child = ::fork();
+    REQUIRE(child != -1);
+    if (child == 0) {
+        // Producer: maps the segment independently, the way the driver does.
+        void* mine = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        auto ring = RTShmRing::AttachRing(mine, bytes);
+        if (!ring) ::_exit(2);
+        std::vector<uint32_t> src;
+        uint64_t frame = 0;
+        for (uint64_t seq = 0; seq < kChunks; ++seq) {
+            const uint32_t n = chunkFrames(seq);
+            fillFrames(src, frame, n);
+            RTShmRing::TimeStamp_POD ts;
+            ts.sampleTime = static_cast<double>(frame);
+            ts.hostTime = seq;
+            while (!RTShmRing::push(ring, src.data(), n, ts)) ::sched_yield();
+            frame += n;
+        }
+        ::_exit(0);
+    }
+
+    auto ring = RTShmRing::AttachRing(base, bytes);
+    REQUIRE(ring);
+    std::vector<uint32_t> dst(kMaxFramesPerChunk * kTestChannels);
+    RTShmRing::ChunkInfo info;
+    uint64_t expectedFrame = 0;
+    uint64_t received = 0;
+    uint64_t failures = 0;
+    while (received < kChunks) {
+        if (!RTShmRing::pop(ring, info, dst.data(), kMaxFramesPerChunk)) {
+            ::sched_yield();
+            continue;
+        }
+        if (info.sequence != received + 1 || info.startFrame != expectedFrame ||
+            info.frameCount != chunkFrames(received) || info.timeStamp.hostTime != received ||
+            info.timeStamp.sampleTime != static_cast<double>(expectedFrame) ||
+            !checkFrames(dst.data(), expectedFrame, info.frameCount)) {
+            ++failures;
+        }
+        expectedFrame += info.frameCount;
+        ++received;
+    }
+
+    int status = 0;
+    REQUIRE(::waitpid(child, &status, 0) == child);
+    ::munmap(base, bytes);
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+    REQUIRE(failures == 0);
+    REQUIRE(received == kChunks);
+}
+
+TEST_CASE("RTShmRing producer stays out of the kernel while the reader is busy", "[shm][wakeup]")
+{
+    std::vector<std::byte> mem(RTShmRing::SegmentBytes(1024, kTestChannels, kTestBytesPerSample));
+    auto ring = RTShmRing::InitRing(mem.data(), mem.size(), 1024, kTestChannels, kTestBytesPerSample);
+    REQUIRE(ring);
+
+    std::vector<uint32_t> src;
+    fillFrames(src, 0, 64);
+    for (int i = 0; i < 10; ++i) {
+        REQUIRE(RTShmRing::push(ring, src.data(), 64, RTShmRing::TimeStamp_POD{}));
+        RTShmRing::SignalReader(ring);
+    }
+    REQUIRE(ring.control->wakeSeq == 0);        // reader never parked -> no wake issued
+
+    // Data already present: WaitForData returns immediately without parking.
+    const auto t0 = std::chrono::steady_clock::now();
+    REQUIRE(RTShmRing::WaitForData(ring, 5000000));
+    REQUIRE(std::chrono::steady_clock::now() - t0 < std::chrono::seconds(1));
+    REQUIRE(ring.control->readerParked == 0);
+}
+
+TEST_CASE("RTShmRing parked reader is woken on the empty to non-empty transition", "[shm][wakeup]")
+{
+    std::vector<std::byte> mem(RTShmRing::SegmentBytes(1024, kTestChannels, kTestBytesPerSample));
+    auto ring = RTShmRing::InitRing(mem.data(), mem.size(), 1024, kTestChannels, kTestBytesPerSample);
+    REQUIRE(ring);
+
+    constexpr int kBursts = 200;
+    std::atomic<int> received {0};
+    std::atomic<bool> timedOut {false};
+    std::thread reader([&] {
+        std::vector<uint32_t> dst(kMaxFramesPerChunk * kTestChannels);
+        RTShmRing::ChunkInfo info;
+        while (received.load() < kBursts) {
+            if (RTShmRing::pop(ring, info, dst.data(), kMaxFramesPerChunk)) {
+                received.fetch_add(1);
+                continue;
+            }
+            // A lost wakeup would show up as a full 2 s timeout.
+            const auto t0 = std::chrono::steady_clock::now();
+            RTShmRing::WaitForData(ring, 2000000);
+            if (std::chrono::steady_clock::now() - t0 > std::chrono::milliseconds(1500)) timedOut = true;
+        }
+    });
+
+    std::vector<uint32_t> src;
+    fillFrames(src, 0, 32);
+    for (int i = 0; i < kBursts; ++i) {
+        while (!RTShmRing::push(ring, src.data(), 32, RTShmRing::TimeStamp_POD{})) std::this_thread::yield();
+        RTShmRing::SignalReader(ring);
+        if (i % 4 == 0) std::this_thread::sleep_for(std::chrono::microseconds(200));
+    }
+    reader.join();
+
+    REQUIRE(received.load() == kBursts);
+    REQUIRE_FALSE(timedOut.load());
+    REQUIRE(ring.control->wakeSeq > 0);
+}
+
+TEST_CASE("RTShmRing wakeups work across processes", "[shm][wakeup][stress]")
+{
+    constexpr uint32_t kFrames = 1024;
+    constexpr uint64_t kChunks = 2000;
+
+    const std::string name = "/fwa_shm_wake_" + std::to_string(::getpid());
+    ::shm_unlink(name.c_str());
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    REQUIRE(fd != -1);
+    const std::size_t bytes = RTShmRing::SegmentBytes(kFrames, kTestChannels, kTestBytesPerSample);
+    REQUIRE(::ftruncate(fd, static_cast<off_t>(bytes)) == 0);
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    REQUIRE(base != MAP_FAILED);
+    auto ring = RTShmRing::InitRing(base, bytes, kFrames, kTestChannels, kTestBytesPerSample);
+    REQUIRE(ring);
+
+    const pid_t child = ::fork();
+    REQUIRE(child != -1);
+    if (child == 0) {
+        void* mine = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        auto r = RTShmRing::AttachRing(mine, bytes);
+        if (!r) ::_exit(2);
+        std::vector<uint32_t> src;
+        uint64_t frame = 0;
+        for (uint64_t seq = 0; seq < kChunks; ++seq) {
+            const uint32_t n = 1 + static_cast<uint32_t>(seq % 64);
+            fillFrames(src, frame, n);
+            while (!RTShmRing::push(r, src.data(), n, RTShmRing::TimeStamp_POD{})) ::sched_yield();
+            RTShmRing::SignalReader(r);
+            frame += n;
+            if (seq % 8 == 0) ::usleep(100);
+        }
+        ::_exit(0);
+    }
+
+    std::vector<uint32_t> dst(kMaxFramesPerChunk * kTestChannels);
+    RTShmRing::ChunkInfo info;
+    uint64_t received = 0, expectedFrame = 0, failures = 0, longWaits = 0;
+    while (received < kChunks) {
+        if (RTShmRing::pop(ring, info, dst.data(), kMaxFramesPerChunk)) {
+            if (info.sequence != received + 1 || !checkFrames(dst.data(), expectedFrame, info.frameCount)) ++failures;
+            expectedFrame += info.frameCount;
+            ++received;
+            continue;
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        RTShmRing::WaitForData(ring, 2000000);
+        if (std::chrono::steady_clock::now() - t0 > std::chrono::milliseconds(1500)) ++longWaits;
+    }
+
+    int status = 0;
+    REQUIRE(::waitpid(child, &status, 0) == child);
+    ::munmap(base, bytes);
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+    REQUIRE(failures == 0);
+    REQUIRE(longWaits == 0);
+}
+
+TEST_CASE("RTShmRing frame-wise consumer reads in place and retires descriptors", "[shm][zerocopy]")
+{
+    constexpr uint32_t kFrames = 64;
+    std::vector<std::byte> mem(RTShmRing::SegmentBytes(kFrames, kTestChannels, kTestBytesPerSample, 4));
+    auto ring = RTShmRing::InitRing(mem.data(), mem.size(), kFrames, kTestChannels, kTestBytesPerSample, 4);
+    REQUIRE(ring);
+
+    std::vector<uint32_t> src;
+    fillFrames(src, 0, 40);
+    REQUIRE(RTShmRing::push(ring, src.data(), 40, RTShmRing::TimeStamp_POD{}));
+    fillFrames(src, 40, 20);
+    REQUIRE(RTShmRing::push(ring, src.data(), 20, RTShmRing::TimeStamp_POD{}));
+
+    auto spans = RTShmRing::PeekFrames(ring, 8);
+    REQUIRE(spans.frames() == 8);
+    REQUIRE(spans.secondFrames == 0);
+    REQUIRE(checkFrames(reinterpret_cast<const uint32_t*>(spans.first), 0, 8));
+
+    // Partially consuming the first chunk keeps its descriptor live.
+    RTShmRing::ConsumeFrames(ring, 8);
+    REQUIRE(ring.control->readIndex == 0);
+    RTShmRing::ConsumeFrames(ring, 32);
+    REQUIRE(ring.control->readIndex == 1);
+    REQUIRE(RTShmRing::AvailableFrames(ring) == 20);
+
+    // Next chunk wraps: 40..63 then 0..
+    fillFrames(src, 60, 30);
+    REQUIRE(RTShmRing::push(ring, src.data(), 30, RTShmRing::TimeStamp_POD{}));
+    RTShmRing::ConsumeFrames(ring, 20);
+    REQUIRE(ring.control->readIndex == 2);
+
+    spans = RTShmRing::PeekFrames(ring, 100);
+    REQUIRE(spans.frames() == 30);
+    REQUIRE(spans.firstFrames == 4);
+    REQUIRE(spans.secondFrames == 26);
+    REQUIRE(checkFrames(reinterpret_cast<const uint32_t*>(spans.first), 60, 4));
+    REQUIRE(checkFrames(reinterpret_cast<const uint32_t*>(spans.second), 64, 26));
+    RTShmRing::ConsumeFrames(ring, 30);
+    REQUIRE(ring.control->readIndex == ring.control->writeIndex);
+    REQUIRE(RTShmRing::PeekFrames(ring, 8).frames() == 0);
+}
+
+TEST_CASE("RTShmRing frame-wise consumer keeps up with a cross-process producer", "[shm][zerocopy][stress]")
+{
+    constexpr uint32_t kFrames = 2048;
+    constexpr uint64_t kChunks = 50000;
+    constexpr uint32_t kPacketFrames = 8;   // one AMDTP blocking-mode packet at 48 kHz
+
+    const std::string name = "/fwa_shm_zc_" + std::to_string(::getpid());
+    ::shm_unlink(name.c_str());
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    REQUIRE(fd != -1);
+    const std::size_t bytes = RTShmRing::SegmentBytes(kFrames, kTestChannels, kTestBytesPerSample);
+    REQUIRE(::ftruncate(fd, static_cast<off_t>(bytes)) == 0);
+    void* base = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    REQUIRE(base != MAP_FAILED);
+    auto ring = RTShmRing::InitRing(base, bytes, kFrames, kTestChannels, kTestBytesPerSample);
+    REQUIRE(ring);
+
+    uint64_t totalFrames = 0;
+    for (uint64_t seq = 0; seq < kChunks; ++seq) totalFrames += chunkFrames(seq) % 512 + 1;
+
+    const pid_t child = ::fork();
+    REQUIRE(child != -1);
+    if (child == 0) {
+        void* mine = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        auto r = RTShmRing::AttachRing(mine, bytes);
+        if (!r) ::_exit(2);
+        std::vector<uint32_t> src;
+        uint64_t frame = 0;
+        for (uint64_t seq = 0; seq < kChunks; ++seq) {
+            const uint32_t n = chunkFrames(seq) % 512 + 1;
+            fillFrames(src, frame, n);
+            while (!RTShmRing::push(r, src.data(), n, RTShmRing::TimeStamp_POD{})) ::sched_yield();
+            frame += n;
+        }
+        ::_exit(0);
+    }
+
+    uint64_t consumed = 0, failures = 0;
+    std::vector<uint32_t> packet(kPacketFrames * kTestChannels);
+    while (consumed < totalFrames) {
+        const uint32_t want = static_cast<uint32_t>(std::min<uint64_t>(kPacketFrames, totalFrames - consumed));
+        auto spans = RTShmRing::PeekFrames(ring, want);
+        if (spans.frames() < want) {
+            ::sched_yield();
+            continue;
+        }
+        std::memcpy(packet.data(), spans.first, std::size_t(spans.firstFrames) * kTestChannels * kTestBytesPerSample);
+        if (spans.secondFrames)
+            std::memcpy(packet.data() + std::size_t(spans.firstFrames) * kTestChannels, spans.second,
+                        std::size_t(spans.secondFrames) * kTestChannels * kTestBytesPerSample);
+        if (!checkFrames(packet.data(), consumed, want)) ++failures;
+        RTShmRing::ConsumeFrames(ring, want);
+        consumed += want;
+    }
+
+    int status = 0;
+    REQUIRE(::waitpid(child, &status, 0) == child);
+    const bool drained = ring.control->readIndex == ring.control->writeIndex;
+    ::munmap(base, bytes);
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+    REQUIRE(failures == 0);
+    REQUIRE(drained);
+}
+
+TEST_CASE("RTShmRing reserve/commit lets a producer render in place", "[shm][capture]")
+{
+    constexpr uint32_t kFrames = 32;
+    std::vector<std::byte> mem(RTShmRing::SegmentBytes(kFrames, kTestChannels, sizeof(float), 4));
+    auto ring = RTShmRing::InitRing(mem.data(), mem.size(), kFrames, kTestChannels, sizeof(float), 4);
+    REQUIRE(ring);
+
+    auto render = [&](uint32_t frames, float base) {
+        auto spans = RTShmRing::ReserveFrames(ring, frames);
+        if (spans.frames() != frames) return false;
+        uint32_t i = 0;
+        for (auto [ptr, n] : { std::pair{spans.first, spans.firstFrames}, std::pair{spans.second, spans.secondFrames} }) {
+            auto* out = reinterpret_cast<float*>(ptr);
+            for (uint32_t f = 0; f < n; ++f, ++i) {
+                out[f * 2] = base + float(i);
+                out[f * 2 + 1] = -(base + float(i));
+            }
+        }
+        RTShmRing::TimeStamp_POD ts;
+        ts.sampleTime = base;
+        RTShmRing::CommitFrames(ring, frames, ts);
+        return true;
+    };
+
+    // Abandoned reservation publishes nothing.
+    REQUIRE(RTShmRing::ReserveFrames(ring, 8).frames() == 8);
+    REQUIRE(RTShmRing::AvailableFrames(ring) == 0);
+
+    REQUIRE(render(24, 0.0f));
+    REQUIRE_FALSE(render(16, 100.0f));           // only 8 frames free
+    std::vector<float> dst(kFrames * 2);
+    RTShmRing::ChunkInfo info;
+    REQUIRE(RTShmRing::pop(ring, info, dst.data(), kFrames));
+    REQUIRE(info.frameCount == 24);
+    REQUIRE(dst[23 * 2] == 23.0f);
+
+    // Wrapping reservation.
+    REQUIRE(render(16, 100.0f));
+    REQUIRE(RTShmRing::pop(ring, info, dst.data(), kFrames));
+    REQUIRE(info.startFrame == 24);
+    REQUIRE(info.timeStamp.sampleTime == 100.0);
+    for (uint32_t f = 0; f < 16; ++f) {
+        REQUIRE(dst[f * 2] == 100.0f + float(f));
+        REQUIRE(dst[f * 2 + 1] == -(100.0f + float(f)));
+    }
+}
+
+TEST_CASE("Capture input started after an idle period is live, and stays live", "[shm][capture]")
+{
+    constexpr uint32_t kFrames = 8192, kPacket = 8, kIo = 512;
+    std::vector<std::byte> mem(RTShmRing::SegmentBytes(kFrames, kTestChannels, sizeof(float)));
+    auto ring = RTShmRing::InitRing(mem.data(), mem.size(), kFrames, kTestChannels, sizeof(float));
+    REQUIRE(ring);
+
+    // Receiver: one packet per cycle, frames numbered by absolute sample index
+    uint64_t produced = 0, newest = 0;   // packets sent; frame index after the last one delivered
+    auto packet = [&] {
+        auto spans = RTShmRing::ReserveFrames(ring, kPacket);
+        if (spans.frames() != kPacket) { ++produced; return false; }   // overrun: packet lost
+        uint32_t i = 0;
+        for (auto [ptr, n] : { std::pair{spans.first, spans.firstFrames}, std::pair{spans.second, spans.secondFrames} }) {
+            auto* out = reinterpret_cast<float*>(ptr);
+            for (uint32_t f = 0; f < n; ++f, ++i) out[f * 2] = out[f * 2 + 1] = float(produced * kPacket + i);
+        }
+        RTShmRing::CommitFrames(ring, kPacket, RTShmRing::TimeStamp_POD{});
+        newest = ++produced * kPacket;
+        return true;
+    };
+    // Driver IO cycle, as FWADriverHandler::ReadFromSharedMemory: returns the first frame read
+    std::vector<float> dst(kIo * kTestChannels);
+    auto read = [&]() -> int64_t {
+        RTShmRing::TrimCaptureBacklog(ring, kIo);
+        const RTShmRing::FrameSpans spans = RTShmRing::PeekFrames(ring, kIo);
+        if (spans.frames() != kIo) return -1;
+        const float first = reinterpret_cast<const float*>(spans.first)[0];
+        RTShmRing::ConsumeFrames(ring, kIo);
+        return int64_t(first);
+    };
+
+    // A second of idle driver: the ring fills up (descriptors or frames) and later packets are lost
+    uint32_t lost = 0;
+    for (int i = 0; i < 6000; ++i) lost += !packet();
+    REQUIRE(lost > 0);
+    const uint64_t backlog = RTShmRing::AvailableFrames(ring);
+    REQUIRE(backlog > kIo + kCaptureTrimThresholdFrames);
+
+    // OnStartIO: the backlog is discarded, so the first buffer is audio received after it
+    const uint64_t startedAt = produced * kPacket;
+    CHECK(RTShmRing::DropOldestFrames(ring, 0) == backlog);
+    CHECK(RTShmRing::AvailableFrames(ring) == 0);
+    for (uint32_t i = 0; i < kIo / kPacket; ++i) REQUIRE(packet());
+    CHECK(read() == int64_t(startedAt));
+
+    SECTION("without the discard, the reader alone bounds the delay")
+    {
+        for (int i = 0; i < 6000; ++i) packet();
+        REQUIRE(RTShmRing::AvailableFrames(ring) == backlog);
+        const int64_t first = read();
+        CHECK(int64_t(newest) - first <= int64_t(kIo + kCaptureTargetFillFrames));
+    }
+    SECTION("a late IO cycle is trimmed back, not carried forever")
+    {
+        for (int cycle = 0; cycle < 200; ++cycle) {
+            const uint32_t packets = cycle == 50 ? 10 * kIo / kPacket : kIo / kPacket;   // one long stall
+            for (uint32_t i = 0; i < packets; ++i) packet();
+            const int64_t first = read();
+            REQUIRE(first >= 0);
+            INFO("cycle " << cycle);
+            // Whatever is left waiting is the delay the next buffer starts with
+            CHECK(RTShmRing::AvailableFrames(ring) <= kCaptureTrimThresholdFrames);
+            if (cycle == 50) CHECK(int64_t(newest) - first == int64_t(kIo + kCaptureTargetFillFrames));
+        }
+        CHECK(RTShmRing::AvailableFrames(ring) <= kCaptureTargetFillFrames);
+    }
+}
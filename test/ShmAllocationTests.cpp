@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "shared/ShmAllocation.hpp"
+#include "shared/SharedMemoryStructures.hpp"
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+long minorFaultsSoFar()
+{
+    struct rusage ru {};
+#if defined(RUSAGE_THREAD)
+    ::getrusage(RUSAGE_THREAD, &ru);
+#else
+    ::getrusage(RUSAGE_SELF, &ru);
+#endif
+    return ru.ru_minflt;
+}
+
+struct ShmObject
+{
+    std::string name;
+    int fd = -1;
+
+    ShmObject(const char* tag, std::size_t bytes)
+        : name(std::string("/fwa_alloc_") + tag + "_" + std::to_string(::getpid()))
+    {
+        ::shm_unlink(name.c_str());
+        fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd != -1 && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    ~ShmObject()
+    {
+        if (fd != -1) ::close(fd);
+        ::shm_unlink(name.c_str());
+    }
+};
+
+// One simulated IO cycle: the driver pushes a period, the daemon pops it.
+bool pushPopCycle(const RTShmRing::RingView& ring, const std::vector<uint32_t>& src,
+                  std::vector<uint32_t>& dst, uint32_t frames)
+{
+    RTShmRing::ChunkInfo info;
+    return RTShmRing::push(ring, src.data(), frames, RTShmRing::TimeStamp_POD{}) &&
+           RTShmRing::pop(ring, info, dst.data(), kMaxFramesPerChunk) &&
+           info.frameCount == frames;
+}
+
+} // namespace
+
+TEST_CASE("MapShm pre-faults and reports residency", "[shm][alloc]")
+{
+    const std::size_t bytes = RTShmRing::SegmentBytes(kDefaultRingFramesPow2, kDefaultRingChannels, kDefaultRingBytesPerSample);
+    ShmObject obj("report", bytes);
+    REQUIRE(obj.fd != -1);
+
+    RTShmRing::ShmMapping m = RTShmRing::MapShm(obj.fd, bytes);
+    REQUIRE(m);
+    CHECK(m.bytes == bytes);
+    CHECK(m.pageSize >= RTShmRing::BasePageSize());
+    CHECK(m.residentBytes >= bytes);
+    // mlock may be refused by RLIMIT_MEMLOCK in CI; the report must say so either way.
+    CHECK((m.lockedBytes == bytes || m.lockErrno != 0));
+    RTShmRing::UnmapShm(m);
+    CHECK_FALSE(m);
+}
+
+TEST_CASE("MapShm advises huge pages for large segments", "[shm][alloc]")
+{
+    const std::size_t bytes = 4 * RTShmRing::kHugePageBytes;
+    ShmObject obj("huge", bytes);
+    REQUIRE(obj.fd != -1);
+
+    RTShmRing::ShmMapping m = RTShmRing::MapShm(obj.fd, bytes);
+    REQUIRE(m);
+    // Whether tmpfs hands out PMD mappings depends on the host's shmem_enabled setting;
+    // only check that the report is self-consistent.
+    CHECK(m.hugeBytes <= bytes);
+    CHECK((m.hugeBytes == 0 || m.pageSize == RTShmRing::kHugePageBytes));
+    CHECK(m.residentBytes >= bytes);
+    RTShmRing::UnmapShm(m);
+}
+
+TEST_CASE("Steady-state push/pop on a pre-faulted segment takes no minor faults", "[shm][alloc]")
+{
+    constexpr uint32_t kFrames = 4096;
+    constexpr uint32_t kPeriod = 512;
+    const std::size_t bytes = RTShmRing::SegmentBytes(kFrames, kDefaultRingChannels, kDefaultRingBytesPerSample);
+    ShmObject obj("steady", bytes);
+    REQUIRE(obj.fd != -1);
+
+    RTShmRing::ShmMapping m = RTShmRing::MapShm(obj.fd, bytes);
+    REQUIRE(m);
+    auto ring = RTShmRing::InitRing(m.base, m.bytes, kFrames, kDefaultRingChannels, kDefaultRingBytesPerSample);
+    REQUIRE(ring);
+
+    // Client-side buffers are touched up front, as a real IO proc's would be.
+    std::vector<uint32_t> src(kPeriod * kDefaultRingChannels, 0x1234);
+    std::vector<uint32_t> dst(kMaxFramesPerChunk * kDefaultRingChannels, 0);
+
+    // Warm up the code path itself (first-call faults in text pages, etc.).
+    REQUIRE(pushPopCycle(ring, src, dst, kPeriod));
+
+    const long before = minorFaultsSoFar();
+    bool ok = true;
+    for (int cycle = 0; cycle < 20000; ++cycle) {
+        ok &= pushPopCycle(ring, src, dst, kPeriod - (cycle % 7));   // uneven sizes walk every wrap offset
+    }
+    const long after = minorFaultsSoFar();
+
+    REQUIRE(ok);
+    REQUIRE(after - before == 0);
+    RTShmRing::UnmapShm(m);
+}
+
+TEST_CASE("Without pre-faulting the first pass over the ring does fault", "[shm][alloc]")
+{
+    constexpr uint32_t kFrames = 4096;
+    const std::size_t bytes = RTShmRing::SegmentBytes(kFrames, kDefaultRingChannels, kDefaultRingBytesPerSample);
+    ShmObject obj("cold", bytes);
+    REQUIRE(obj.fd != -1);
+
+    RTShmRing::ShmMapOptions cold;
+    cold.prefault = false;
+    cold.lock = false;
+    cold.tryHugePages = false;
+    RTShmRing::ShmMapping m = RTShmRing::MapShm(obj.fd, bytes, cold);
+    REQUIRE(m);
+
+    std::vector<uint32_t> src(512 * kDefaultRingChannels, 0x1234);
+    std::vector<uint32_t> dst(kMaxFramesPerChunk * kDefaultRingChannels, 0);
+
+    const long before = minorFaultsSoFar();
+    auto ring = RTShmRing::InitRing(m.base, m.bytes, kFrames, kDefaultRingChannels, kDefaultRingBytesPerSample);
+    REQUIRE(ring);
+    for (int cycle = 0; cycle < 16; ++cycle) REQUIRE(pushPopCycle(ring, src, dst, 512));
+    const long after = minorFaultsSoFar();
+
+    CHECK(after - before > 0);
+    RTShmRing::UnmapShm(m);
+}
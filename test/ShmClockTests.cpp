@@ -0,0 +1,153 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "shared/SharedMemoryStructures.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Every field is a function of k, so a reader can tell a torn snapshot from a consistent one.
+RTShmRing::ClockSnapshot snapshotFor(uint64_t k)
+{
+    RTShmRing::ClockSnapshot s;
+    s.seed               = k;
+    s.anchorSampleTime   = double(k) * 512.0;
+    s.anchorHostTime     = k * 1000u + 7u;
+    s.hostTicksPerSample = 1000.0 / 512.0 + double(k) * 1e-9;
+    s.rateScalar         = 1.0 + double(k) * 1e-12;
+    s.sampleRate         = 48000.0 + double(k % 7);
+    return s;
+}
+
+bool isConsistent(const RTShmRing::ClockSnapshot& s)
+{
+    const RTShmRing::ClockSnapshot want = snapshotFor(s.seed);
+    return s.anchorSampleTime == want.anchorSampleTime &&
+           s.anchorHostTime == want.anchorHostTime &&
+           s.hostTicksPerSample == want.hostTicksPerSample &&
+           s.rateScalar == want.rateScalar &&
+           s.sampleRate == want.sampleRate;
+}
+
+} // namespace
+
+TEST_CASE("Clock record starts unpublished and round-trips", "[shm][clock]")
+{
+    RTShmRing::ControlBlock_POD cb{};
+    RTShmRing::ClockSnapshot s;
+    REQUIRE(RTShmRing::ReadClock(cb, s));
+    CHECK_FALSE(s.valid());
+
+    RTShmRing::PublishClock(cb, snapshotFor(42));
+    REQUIRE(RTShmRing::ReadClock(cb, s));
+    CHECK(s.valid());
+    CHECK(s.seed == 42);
+    CHECK(isConsistent(s));
+    CHECK((cb.clock.seq & 1u) == 0);
+
+    // Retracting (seed 0) makes the driver fall back to its own clock.
+    RTShmRing::PublishClock(cb, RTShmRing::ClockSnapshot{});
+    REQUIRE(RTShmRing::ReadClock(cb, s));
+    CHECK_FALSE(s.valid());
+}
+
+TEST_CASE("Reader gives up instead of spinning while an update is stuck", "[shm][clock]")
+{
+    RTShmRing::ControlBlock_POD cb{};
+    RTShmRing::PublishClock(cb, snapshotFor(1));
+    cb.clock.seq += 1;   // writer "stalled" mid-update
+    RTShmRing::ClockSnapshot s;
+    CHECK_FALSE(RTShmRing::ReadClock(cb, s, 8));
+    cb.clock.seq += 1;
+    CHECK(RTShmRing::ReadClock(cb, s, 8));
+    CHECK(s.seed == 1);
+}
+
+TEST_CASE("Concurrent readers never observe a torn clock record", "[shm][clock]")
+{
+    RTShmRing::ControlBlock_POD cb{};
+    RTShmRing::PublishClock(cb, snapshotFor(1));
+
+    constexpr uint64_t kUpdates = 400000;
+    constexpr int kReaders = 3;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0}, reads{0}, regressions{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kReaders; ++i) {
+        readers.emplace_back([&] {
+            uint64_t lastSeed = 0, myReads = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                RTShmRing::ClockSnapshot s;
+                if (!RTShmRing::ReadClock(cb, s, 1024)) continue;
+                ++myReads;
+                if (!isConsistent(s)) torn.fetch_add(1, std::memory_order_relaxed);
+                if (s.seed < lastSeed) regressions.fetch_add(1, std::memory_order_relaxed);
+                lastSeed = s.seed;
+            }
+            reads.fetch_add(myReads, std::memory_order_relaxed);
+        });
+    }
+
+    for (uint64_t k = 2; k <= kUpdates; ++k) {
+        RTShmRing::PublishClock(cb, snapshotFor(k));
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& t : readers) t.join();
+
+    RTShmRing::ClockSnapshot last;
+    REQUIRE(RTShmRing::ReadClock(cb, last));
+    CHECK(last.seed == kUpdates);
+    CHECK(reads.load() > 0);
+    CHECK(torn.load() == 0);
+    CHECK(regressions.load() == 0);
+}
+
+TEST_CASE("Zero timestamps follow the published clock", "[shm][clock]")
+{
+    RTShmRing::ClockSnapshot c;
+    c.seed               = 3;
+    c.anchorSampleTime   = 10000.0;
+    c.anchorHostTime     = 5'000'000;
+    c.hostTicksPerSample = 24'000'000.0 / 48000.0 * (1.0 - 150e-6);   // device 150 ppm fast
+    c.rateScalar         = 1.0 / (1.0 - 150e-6);
+    c.sampleRate         = 48000.0;
+
+    constexpr uint32_t kPeriod = 512;
+    double sample = 0.0, prevSample = -1.0;
+    uint64_t host = 0, prevHost = 0;
+
+    for (uint64_t now = c.anchorHostTime; now < c.anchorHostTime + 24'000'000; now += 333'333) {
+        REQUIRE(RTShmRing::ZeroTimeStampAt(c, now, kPeriod, sample, host));
+        CHECK(std::fmod(sample, double(kPeriod)) == 0.0);
+        CHECK(host <= now);
+        CHECK(now - host < uint64_t(std::ceil(kPeriod * c.hostTicksPerSample)) + 1);
+        // The grid point maps back onto the clock line to within a tick.
+        const double expectHost = double(c.anchorHostTime) + (sample - c.anchorSampleTime) * c.hostTicksPerSample;
+        CHECK(std::fabs(double(host) - expectHost) <= 1.0);
+        if (prevSample >= 0.0) {
+            CHECK(sample >= prevSample);
+            CHECK(host >= prevHost);
+        }
+        prevSample = sample;
+        prevHost = host;
+    }
+
+    // One second of host time spans the drifted number of samples, not the nominal one.
+    double s0 = 0.0, s1 = 0.0;
+    uint64_t h0 = 0, h1 = 0;
+    REQUIRE(RTShmRing::ZeroTimeStampAt(c, c.anchorHostTime, 1, s0, h0));
+    REQUIRE(RTShmRing::ZeroTimeStampAt(c, c.anchorHostTime + 24'000'000, 1, s1, h1));
+    CHECK(std::fabs((s1 - s0) - 48000.0 * c.rateScalar) <= 1.0);
+
+    // Host times before the anchor extrapolate backwards onto the same grid.
+    REQUIRE(RTShmRing::ZeroTimeStampAt(c, c.anchorHostTime - 1'000'000, kPeriod, sample, host));
+    CHECK(sample < c.anchorSampleTime);
+    CHECK(std::fmod(sample, double(kPeriod)) == 0.0);
+
+    CHECK_FALSE(RTShmRing::ZeroTimeStampAt(RTShmRing::ClockSnapshot{}, 123, kPeriod, sample, host));
+}
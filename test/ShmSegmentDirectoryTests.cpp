@@ -0,0 +1,263 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "shared/ShmAllocation.hpp"
+#include "shared/ShmSegmentDirectory.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using RTShmRing::StreamDirection;
+
+namespace {
+
+constexpr uint64_t kGuidA = 0x000a92000001c0deULL;
+constexpr uint64_t kGuidB = 0x000a92000001c0dfULL;
+
+// Two interfaces, each with playback and capture, all with different geometry.
+const RTShmRing::RingSpec kSpecs[] = {
+    { kGuidA, StreamDirection::Playback, 4096, 2,  4 },
+    { kGuidA, StreamDirection::Capture,  2048, 2,  4 },
+    { kGuidB, StreamDirection::Playback, 8192, 10, 4 },
+    { kGuidB, StreamDirection::Capture,  1024, 18, 4 },
+};
+constexpr uint32_t kSpecCount = sizeof(kSpecs) / sizeof(kSpecs[0]);
+
+struct AnonMapping {
+    std::size_t bytes;
+    void* base;
+    explicit AnonMapping(std::size_t n)
+        : bytes(n), base(::mmap(nullptr, n, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0)) {}
+    ~AnonMapping() { if (base != MAP_FAILED) ::munmap(base, bytes); }
+};
+
+// Frame f of a ring carries the value (tag << 24) | (f & 0xFFFFFF) in every channel.
+uint32_t sampleFor(uint32_t tag, uint64_t frame) { return (tag << 24) | uint32_t(frame & 0xFFFFFF); }
+
+} // namespace
+
+TEST_CASE("Directory lays out independently sized rings", "[shm][directory]")
+{
+    const std::size_t bytes = RTShmRing::DirectorySegmentBytes(kSpecs, kSpecCount);
+    REQUIRE(bytes > RTShmRing::DirectoryHeaderBytes());
+    AnonMapping m(bytes);
+    REQUIRE(m.base != MAP_FAILED);
+
+    RTShmRing::DirectoryView dir = RTShmRing::InitDirectory(m.base, m.bytes, kSpecs, kSpecCount);
+    REQUIRE(dir);
+    REQUIRE(dir.count == kSpecCount);
+
+    for (uint32_t i = 0; i < kSpecCount; ++i) {
+        const RTShmRing::RingView ring = RTShmRing::FindRing(dir, kSpecs[i].guid, kSpecs[i].direction);
+        REQUIRE(ring);
+        CHECK(ring.control == dir.rings[i].control);
+        CHECK(ring.control->capacityFrames == kSpecs[i].capacityFrames);
+        CHECK(ring.control->channels == kSpecs[i].channels);
+        CHECK(reinterpret_cast<uintptr_t>(ring.control) % kDestructiveCL == 0);
+        if (i > 0) {
+            // No overlap with the previous ring.
+            CHECK(reinterpret_cast<std::byte*>(ring.control) >=
+                  reinterpret_cast<std::byte*>(dir.rings[i - 1].control) + dir.header->entries[i - 1].bytes);
+        }
+    }
+    CHECK_FALSE(RTShmRing::FindRing(dir, 0x1234, StreamDirection::Playback));
+    CHECK(RTShmRing::FindRingIndex(dir, kGuidB, StreamDirection::Capture) == 3);
+
+    // A second process sees the same rings.
+    RTShmRing::DirectoryView attached = RTShmRing::AttachDirectory(m.base, m.bytes);
+    REQUIRE(attached);
+    for (uint32_t i = 0; i < kSpecCount; ++i) CHECK(attached.rings[i].control == dir.rings[i].control);
+}
+
+TEST_CASE("Directory rejects bad input", "[shm][directory]")
+{
+    const RTShmRing::RingSpec dup[] = {
+        { kGuidA, StreamDirection::Playback, 1024, 2, 4 },
+        { kGuidA, StreamDirection::Playback, 1024, 2, 4 },
+    };
+    const std::size_t bytes = RTShmRing::DirectorySegmentBytes(dup, 2);
+    AnonMapping m(bytes);
+    CHECK_FALSE(RTShmRing::InitDirectory(m.base, m.bytes, dup, 2));
+    CHECK_FALSE(RTShmRing::AttachDirectory(m.base, m.bytes));          // never published
+
+    const RTShmRing::RingSpec bad[] = { { kGuidA, StreamDirection::Playback, 1000, 2, 4 } };
+    CHECK(RTShmRing::DirectorySegmentBytes(bad, 1) == 0);
+
+    RTShmRing::RingSpec many[RTShmRing::kMaxDirectoryRings + 1];
+    CHECK(RTShmRing::DirectorySegmentBytes(many, RTShmRing::kMaxDirectoryRings + 1) == 0);
+
+    AnonMapping ok(RTShmRing::DirectorySegmentBytes(kSpecs, kSpecCount));
+    REQUIRE(RTShmRing::InitDirectory(ok.base, ok.bytes, kSpecs, kSpecCount));
+    CHECK_FALSE(RTShmRing::AttachDirectory(ok.base, ok.bytes - 64));   // truncated mapping
+}
+
+TEST_CASE("A full directory still finds every ring", "[shm][directory]")
+{
+    std::vector<RTShmRing::RingSpec> specs;
+    for (uint32_t i = 0; i < RTShmRing::kMaxDirectoryRings; ++i) {
+        specs.push_back({ 0x000a920000000000ULL + i / 2, i % 2 ? StreamDirection::Capture : StreamDirection::Playback, 256, 2, 4 });
+    }
+    AnonMapping m(RTShmRing::DirectorySegmentBytes(specs.data(), uint32_t(specs.size())));
+    RTShmRing::DirectoryView dir = RTShmRing::InitDirectory(m.base, m.bytes, specs.data(), uint32_t(specs.size()));
+    REQUIRE(dir);
+    for (uint32_t i = 0; i < specs.size(); ++i) {
+        CHECK(RTShmRing::FindRingIndex(dir, specs[i].guid, specs[i].direction) == int(i));
+    }
+}
+
+TEST_CASE("Concurrent producer/consumer pairs do not interfere", "[shm][directory]")
+{
+    AnonMapping m(RTShmRing::DirectorySegmentBytes(kSpecs, kSpecCount));
+    RTShmRing::DirectoryView dir = RTShmRing::InitDirectory(m.base, m.bytes, kSpecs, kSpecCount);
+    REQUIRE(dir);
+
+    constexpr uint64_t kFramesPerPair = 200000;
+    std::atomic<int> producersDone{0};
+    std::atomic<uint32_t> corrupt{0};
+    std::vector<uint64_t> received(kSpecCount, 0);
+    std::vector<std::thread> threads;
+
+    for (uint32_t i = 0; i < kSpecCount; ++i) {
+        const RTShmRing::RingView ring = RTShmRing::FindRing(dir, kSpecs[i].guid, kSpecs[i].direction);
+        const uint32_t ch = kSpecs[i].channels;
+        const uint32_t chunk = 64 + 37 * i;   // every pair runs a different period
+
+        threads.emplace_back([&, ring, ch, chunk, i] {
+            std::vector<uint32_t> buf(size_t(chunk) * ch);
+            uint64_t frame = 0;
+            while (frame < kFramesPerPair) {
+                const uint32_t n = uint32_t(std::min<uint64_t>(chunk, kFramesPerPair - frame));
+                for (uint32_t f = 0; f < n; ++f)
+                    for (uint32_t c = 0; c < ch; ++c) buf[size_t(f) * ch + c] = sampleFor(i, frame + f);
+                if (RTShmRing::push(ring, buf.data(), n, RTShmRing::TimeStamp_POD{})) {
+                    RTShmRing::SignalReader(ring);
+                    frame += n;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            producersDone.fetch_add(1);
+        });
+
+        threads.emplace_back([&, ring, ch, i] {
+            std::vector<uint32_t> buf(size_t(kMaxFramesPerChunk) * ch);
+            uint64_t expect = 0;
+            RTShmRing::ChunkInfo info;
+            while (expect < kFramesPerPair) {
+                if (!RTShmRing::pop(ring, info, buf.data(), kMaxFramesPerChunk)) {
+                    RTShmRing::WaitForData(ring, 1000);
+                    continue;
+                }
+                for (uint32_t f = 0; f < info.frameCount; ++f)
+                    for (uint32_t c = 0; c < ch; ++c)
+                        if (buf[size_t(f) * ch + c] != sampleFor(i, expect + f)) corrupt.fetch_add(1);
+                expect += info.frameCount;
+            }
+            received[i] = expect;
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    CHECK(producersDone.load() == int(kSpecCount));
+    CHECK(corrupt.load() == 0);
+    for (uint32_t i = 0; i < kSpecCount; ++i) CHECK(received[i] == kFramesPerPair);
+}
+
+TEST_CASE("A stalled stream does not block the others", "[shm][directory]")
+{
+    AnonMapping m(RTShmRing::DirectorySegmentBytes(kSpecs, kSpecCount));
+    RTShmRing::DirectoryView dir = RTShmRing::InitDirectory(m.base, m.bytes, kSpecs, kSpecCount);
+    REQUIRE(dir);
+
+    // Ring 0 has no consumer: fill it until it refuses.
+    const RTShmRing::RingView stalled = dir.rings[0];
+    std::vector<uint32_t> buf(256 * 18, 0);
+    while (RTShmRing::push(stalled, buf.data(), 256, RTShmRing::TimeStamp_POD{})) {}
+    REQUIRE(RTShmRing::AvailableFrames(stalled) > 0);
+
+    // Every other ring still moves data in both directions.
+    for (uint32_t i = 1; i < kSpecCount; ++i) {
+        RTShmRing::ChunkInfo info;
+        for (int round = 0; round < 100; ++round) {
+            REQUIRE(RTShmRing::push(dir.rings[i], buf.data(), 128, RTShmRing::TimeStamp_POD{}));
+            REQUIRE(RTShmRing::pop(dir.rings[i], info, buf.data(), 256));
+            CHECK(info.frameCount == 128);
+        }
+    }
+}
+
+TEST_CASE("Directory rings carry data between processes", "[shm][directory]")
+{
+    const std::string name = "/fwa_dir_test_" + std::to_string(::getpid());
+    const std::size_t bytes = RTShmRing::DirectorySegmentBytes(kSpecs, kSpecCount);
+    ::shm_unlink(name.c_str());
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    REQUIRE(fd != -1);
+    REQUIRE(::ftruncate(fd, off_t(bytes)) == 0);
+
+    RTShmRing::ShmMapping m = RTShmRing::MapShm(fd, bytes);
+    REQUIRE(m);
+    RTShmRing::DirectoryView dir = RTShmRing::InitDirectory(m.base, m.bytes, kSpecs, kSpecCount);
+    REQUIRE(dir);
+
+    constexpr uint64_t kFrames = 50000;
+    const pid_t child = ::fork();
+    REQUIRE(child != -1);
+    if (child == 0) {
+        // Child: attach on its own mapping and produce into interface B's playback ring only.
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        RTShmRing::DirectoryView mine = RTShmRing::AttachDirectory(p, bytes);
+        const RTShmRing::RingView ring = RTShmRing::FindRing(mine, kGuidB, StreamDirection::Playback);
+        if (!ring) ::_exit(2);
+        std::vector<uint32_t> buf(size_t(100) * 10);
+        uint64_t frame = 0;
+        while (frame < kFrames) {
+            for (uint32_t f = 0; f < 100; ++f)
+                for (uint32_t c = 0; c < 10; ++c) buf[size_t(f) * 10 + c] = sampleFor(7, frame + f);
+            if (RTShmRing::push(ring, buf.data(), 100, RTShmRing::TimeStamp_POD{})) {
+                RTShmRing::SignalReader(ring);
+                frame += 100;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        ::_exit(0);
+    }
+
+    const RTShmRing::RingView ring = RTShmRing::FindRing(dir, kGuidB, StreamDirection::Playback);
+    std::vector<uint32_t> buf(size_t(kMaxFramesPerChunk) * 10);
+    uint64_t expect = 0;
+    uint32_t corrupt = 0;
+    RTShmRing::ChunkInfo info;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while (expect < kFrames && std::chrono::steady_clock::now() < deadline) {
+        if (!RTShmRing::pop(ring, info, buf.data(), kMaxFramesPerChunk)) {
+            RTShmRing::WaitForData(ring, 1000);
+            continue;
+        }
+        for (uint32_t f = 0; f < info.frameCount; ++f)
+            if (buf[size_t(f) * 10] != sampleFor(7, expect + f)) ++corrupt;
+        expect += info.frameCount;
+    }
+    int status = 0;
+    ::waitpid(child, &status, 0);
+
+    CHECK(WIFEXITED(status));
+    CHECK(WEXITSTATUS(status) == 0);
+    CHECK(expect == kFrames);
+    CHECK(corrupt == 0);
+    for (uint32_t i = 0; i < kSpecCount; ++i) {
+        if (i != 2) CHECK(RTShmRing::AvailableFrames(dir.rings[i]) == 0);
+    }
+
+    RTShmRing::UnmapShm(m);
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+}
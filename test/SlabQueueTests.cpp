@@ -0,0 +1,166 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "shared/SlabQueue.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using RTShmRing::SlabQueue;
+
+TEST_CASE("SlabQueue reserve/commit/pop round trip", "[slab]")
+{
+    SlabQueue q;
+    CHECK(q.reserve() == nullptr);                  // nothing allocated yet
+    CHECK_FALSE(q.allocate(3, 128));                // slot count must be a power of two
+    REQUIRE(q.allocate(4, 100));
+    CHECK(q.capacity() == 4);
+    CHECK(q.slotBytes() == 100);
+
+    for (int i = 0; i < 4; ++i) {
+        std::byte* slot = q.reserve();
+        REQUIRE(slot != nullptr);
+        CHECK(reinterpret_cast<uintptr_t>(slot) % 64 == 0);
+        std::memset(slot, i + 1, 10 + i);
+        q.commit(10 + i);
+    }
+    CHECK(q.reserve() == nullptr);                  // full
+    CHECK_FALSE(q.push("x", 1));
+    CHECK(q.size() == 4);
+
+    for (int i = 0; i < 4; ++i) {
+        const std::byte* data = nullptr;
+        std::size_t bytes = 0;
+        REQUIRE(q.front(data, bytes));
+        CHECK(bytes == std::size_t(10 + i));
+        CHECK(data[0] == std::byte(i + 1));
+        CHECK(data[bytes - 1] == std::byte(i + 1));
+        q.pop();
+    }
+    const std::byte* data = nullptr;
+    std::size_t bytes = 0;
+    CHECK_FALSE(q.front(data, bytes));
+    CHECK_FALSE(q.push(std::vector<char>(101).data(), 101));   // larger than a slot
+}
+
+TEST_CASE("SlabQueue reuses the same slab slots", "[slab]")
+{
+    SlabQueue q;
+    REQUIRE(q.allocate(8, 4096));
+    std::vector<std::byte*> seen;
+    for (int i = 0; i < 64; ++i) {
+        std::byte* slot = q.reserve();
+        REQUIRE(slot != nullptr);
+        if (i < 8) seen.push_back(slot);
+        else CHECK(slot == seen[i % 8]);
+        q.commit(16);
+        q.pop();
+    }
+}
+
+TEST_CASE("SlabQueue discard drops stale buffers and leaves the producer running", "[slab]")
+{
+    SlabQueue q;
+    REQUIRE(q.allocate(4, 64));
+    const char stale[] = "old";
+    for (int i = 0; i < 4; ++i) REQUIRE(q.push(stale, sizeof(stale)));
+    CHECK(q.reserve() == nullptr);
+
+    q.discard();
+    CHECK(q.size() == 0);
+    const std::byte* data = nullptr;
+    std::size_t bytes = 0;
+    CHECK_FALSE(q.front(data, bytes));
+
+    // The queue keeps its indices running: new buffers come out in order, none of the old ones
+    const char fresh[] = "new";
+    REQUIRE(q.push(fresh, sizeof(fresh)));
+    REQUIRE(q.front(data, bytes));
+    CHECK(bytes == sizeof(fresh));
+    CHECK(std::memcmp(data, fresh, bytes) == 0);
+    q.pop();
+    CHECK(q.size() == 0);
+}
+
+TEST_CASE("SlabQueue consumer blocks until a commit and wakes for shutdown", "[slab]")
+{
+    SlabQueue q;
+    REQUIRE(q.allocate(16, 64));
+
+    std::atomic<bool> gotData{false};
+    std::thread consumer([&] {
+        gotData = q.waitForData();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_FALSE(gotData.load());                    // still parked
+    REQUIRE(q.push("abc", 3));
+    consumer.join();
+    CHECK(gotData.load());
+
+    const std::byte* data = nullptr;
+    std::size_t bytes = 0;
+    REQUIRE(q.front(data, bytes));
+    q.pop();
+
+    std::atomic<bool> returned{false};
+    std::thread waiter([&] {
+        const bool any = q.waitForData();
+        returned = true;
+        CHECK_FALSE(any);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    CHECK_FALSE(returned.load());
+    q.wake();
+    waiter.join();
+    CHECK(returned.load());
+}
+
+TEST_CASE("SlabQueue carries every chunk intact between two threads", "[slab]")
+{
+    SlabQueue q;
+    REQUIRE(q.allocate(64, 512 * 8));
+
+    constexpr uint32_t kChunks = 100000;
+    std::atomic<bool> done{false};
+    uint32_t corrupt = 0, received = 0;
+
+    std::thread consumer([&] {
+        uint32_t expect = 0;
+        while (expect < kChunks) {
+            const std::byte* data = nullptr;
+            std::size_t bytes = 0;
+            if (!q.front(data, bytes)) {
+                q.waitForData();
+                continue;
+            }
+            // Chunk n holds (n % 512 + 1) words, each equal to n.
+            const std::size_t words = expect % 512 + 1;
+            if (bytes != words * sizeof(uint32_t)) ++corrupt;
+            const auto* w = reinterpret_cast<const uint32_t*>(data);
+            for (std::size_t i = 0; i < words && i * sizeof(uint32_t) < bytes; ++i)
+                if (w[i] != expect) ++corrupt;
+            q.pop();
+            ++expect;
+        }
+        received = expect;
+        done = true;
+    });
+
+    for (uint32_t n = 0; n < kChunks;) {
+        std::byte* slot = q.reserve();
+        if (!slot) { std::this_thread::yield(); continue; }
+        const std::size_t words = n % 512 + 1;
+        auto* w = reinterpret_cast<uint32_t*>(slot);
+        for (std::size_t i = 0; i < words; ++i) w[i] = n;
+        q.commit(words * sizeof(uint32_t));
+        ++n;
+    }
+    consumer.join();
+
+    CHECK(done.load());
+    CHECK(received == kChunks);
+    CHECK(corrupt == 0);
+}
@@ -0,0 +1,304 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "Isoch/core/TransmitRecovery.hpp"
+#include "Isoch/core/AmdtpTimingGenerator.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+using FWA::Isoch::AmdtpTimingGenerator;
+using FWA::Isoch::CycleTiming;
+using FWA::Isoch::GroupAction;
+using FWA::Isoch::GroupDecision;
+using FWA::Isoch::TransmitRecovery;
+using FWA::Isoch::TransmitRecoveryConfig;
+using FWA::Isoch::TransmitStreamState;
+
+namespace {
+
+constexpr uint32_t kWrap = AmdtpTimingGenerator::kCyclesPerWrap;
+
+uint32_t cycleTime(uint64_t cycle) {
+    const uint32_t c = uint32_t(cycle % kWrap);
+    return ((c / 8000) << 25) | ((c % 8000) << 12);
+}
+
+// Simulated completion-timing source: a circular DCL program run by "hardware" one packet per
+// bus cycle, and a host that handles completion callbacks some cycles later, the way
+// AmdtpTransmitter does. Each slot remembers the cycle the timing generator meant it for, so
+// a data packet that goes out in any other cycle (a stale replay) is caught.
+struct Simulation {
+    struct Slot {
+        bool data = false;
+        bool primed = false;         // NO_DATA from a (re)prime: valid in any cycle
+        uint8_t dbc = 0;
+        uint32_t intendedCycle = 0;
+    };
+    struct Completion {
+        uint32_t group;
+        uint64_t cycle;
+    };
+
+    TransmitRecoveryConfig config;
+    uint32_t ring;
+    TransmitRecovery recovery;
+    AmdtpTimingGenerator timing{ 48000 };
+    std::vector<Slot> slots;
+    std::deque<Completion> pending;
+
+    uint64_t cycle = 0;            // bus cycle about to be sent
+    uint64_t hwStart = 0;          // cycle the program (re)started at slot 0
+    bool hwRunning = true;
+    uint64_t hostBusyUntil = 0;    // host stall: no callbacks before this cycle
+    uint32_t latency = 3;          // normal callback latency in cycles
+
+    // What went out
+    uint64_t staleData = 0, lastStaleCycle = 0, freshData = 0, dbcErrors = 0, firstFreshAfter = 0;
+    uint64_t resumeMark = ~0ull;   // first fresh data packet at or after this cycle sets firstFreshAfter
+    bool haveDbc = false;
+    uint8_t nextDbc = 0;
+    uint32_t reprimes = 0, resyncs = 0, fails = 0;
+    uint32_t backlogs = 0;   // upcoming refills that cannot be queued (pre-render worker behind)
+
+    explicit Simulation(TransmitRecoveryConfig cfg, uint64_t startCycle = 7 * 8000)
+        : config(cfg), ring(cfg.numGroups * cfg.packetsPerGroup), recovery(cfg), slots(ring)
+    {
+        cycle = hwStart = startCycle;
+        recovery.start();
+    }
+
+    void reprime() {
+        for (auto& s : slots) s = Slot{ false, true, timing.dbc(), 0 };
+        haveDbc = false;   // packets filled ahead are dropped, so DBC skips once here
+    }
+
+    void fillGroup(uint32_t g) {
+        for (uint32_t p = 0; p < config.packetsPerGroup; ++p) {
+            const uint32_t intended = timing.cycle();
+            const CycleTiming t = timing.next();
+            slots[g * config.packetsPerGroup + p] = Slot{ t.hasData(), false, t.dbc, intended };
+        }
+    }
+
+    void handle(const Completion& c) {
+        const GroupDecision d = recovery.onGroupComplete(c.group, cycleTime(c.cycle), cycleTime(cycle));
+        const uint32_t fill = c.group;
+        if (backlogs && (d.action == GroupAction::Fill || d.action == GroupAction::Resync)) {
+            --backlogs;
+            const GroupAction a = recovery.onRenderBacklog(cycleTime(cycle));
+            if (a == GroupAction::Reprime) { ++reprimes; reprime(); }
+            if (a == GroupAction::Fail) ++fails;
+            return;
+        }
+        switch (d.action) {
+        case GroupAction::Resync:
+            ++resyncs;
+            timing.reset(d.resyncCycle, timing.dbc());
+            fillGroup(fill);
+            break;
+        case GroupAction::Fill: fillGroup(fill); break;
+        case GroupAction::Reprime: ++reprimes; reprime(); break;
+        case GroupAction::Fail: ++fails; break;
+        case GroupAction::Idle: break;
+        }
+    }
+
+    void overrun(uint64_t restartAfter) {
+        hwRunning = false;
+        pending.clear();
+        const GroupAction a = recovery.onOverrun(cycleTime(cycle));
+        if (a == GroupAction::Reprime) { ++reprimes; reprime(); }
+        if (a == GroupAction::Fail) ++fails;
+        hwStart = cycle + restartAfter;   // transport restarted in place: program from slot 0
+    }
+
+    void step() {
+        // Host: callbacks whose latency has elapsed, unless it is stalled
+        while (!pending.empty() && cycle >= hostBusyUntil && pending.front().cycle + latency <= cycle) {
+            const Completion c = pending.front();
+            pending.pop_front();
+            handle(c);
+        }
+        // Hardware: one packet per cycle
+        if (!hwRunning && cycle >= hwStart) hwRunning = true;
+        if (hwRunning) {
+            const uint32_t s = uint32_t((cycle - hwStart) % ring);
+            const Slot& slot = slots[s];
+            if (slot.data) {
+                if (slot.intendedCycle != cycle % kWrap) {
+                    ++staleData;
+                    lastStaleCycle = cycle;
+                } else {
+                    ++freshData;
+                    if (cycle >= resumeMark && !firstFreshAfter) firstFreshAfter = cycle;
+                }
+            }
+            // DBC continuity over everything but stale replays: empty packets carry the next DBC
+            if (slot.primed || slot.intendedCycle == cycle % kWrap) {
+                if (haveDbc && slot.dbc != nextDbc) ++dbcErrors;
+                if (slot.data) { haveDbc = true; nextDbc = uint8_t(slot.dbc + 8); }
+            }
+            if (s % config.packetsPerGroup == config.packetsPerGroup - 1) {
+                const uint32_t g = s / config.packetsPerGroup;
+                if ((g + 1) % config.callbackGroupInterval == 0) pending.push_back({ g, cycle });
+            }
+        }
+        ++cycle;
+    }
+
+    void run(uint64_t cycles) { for (uint64_t i = 0; i < cycles; ++i) step(); }
+};
+
+} // namespace
+
+TEST_CASE("Steady streaming never triggers recovery", "[recovery]")
+{
+    for (uint32_t latency : { 0u, 3u, 40u, 90u }) {
+        Simulation sim({ 8, 16 });
+        sim.latency = latency;
+        sim.run(10 * 8000);
+        INFO("latency " << latency);
+        CHECK(sim.recovery.state() == TransmitStreamState::Running);
+        CHECK(sim.recovery.recoveries() == 0);
+        CHECK(sim.resyncs == 1);
+        CHECK(sim.staleData == 0);
+        CHECK(sim.dbcErrors == 0);
+        // 48 kHz: 6 frames per cycle, 8 per packet -> 3 data packets in 4 cycles
+        CHECK(sim.freshData >= 10 * 6000 - 2 * sim.ring);
+    }
+}
+
+TEST_CASE("A host stall is detected and recovered in place within one ring", "[recovery]")
+{
+    for (uint32_t stall : { 130u, 400u, 4000u }) {   // ~1 ring, 50 ms, 500 ms
+        Simulation sim({ 8, 16 });
+        sim.run(2 * 8000);
+        REQUIRE(sim.recovery.state() == TransmitStreamState::Running);
+        const uint64_t freshBefore = sim.freshData;
+
+        const uint64_t stallStart = sim.cycle;
+        sim.hostBusyUntil = stallStart + stall;
+        sim.resumeMark = sim.hostBusyUntil;
+        sim.run(2 * 8000);
+
+        INFO("stall " << stall << " cycles");
+        CHECK(sim.reprimes == 1);
+        CHECK(sim.recovery.recoveries() == 1);
+        CHECK(sim.resyncs == 2);
+        CHECK(sim.fails == 0);
+        CHECK(sim.recovery.state() == TransmitStreamState::Running);
+        CHECK(sim.dbcErrors == 0);
+        // Stale replays only while the host was stalled (the hardware keeps looping the ring)
+        CHECK(sim.lastStaleCycle < sim.hostBusyUntil + sim.latency + 1);
+        // Fresh data again within one ring plus two groups of the stall ending
+        REQUIRE(sim.firstFreshAfter != 0);
+        CHECK(sim.firstFreshAfter - sim.hostBusyUntil <= sim.ring + 2 * 16 + sim.latency);
+        CHECK(sim.freshData > freshBefore);
+    }
+}
+
+TEST_CASE("A DCL overrun re-primes the ring and restarts without teardown", "[recovery]")
+{
+    Simulation sim({ 8, 16 });
+    sim.run(8000);
+    sim.resumeMark = sim.cycle;
+    const uint64_t overrunAt = sim.cycle;
+    sim.overrun(20);   // program halted; transport restarted 20 cycles later
+    CHECK(sim.recovery.state() == TransmitStreamState::Recovering);
+    sim.run(8000);
+
+    CHECK(sim.reprimes == 1);
+    CHECK(sim.recovery.state() == TransmitStreamState::Running);
+    CHECK(sim.staleData == 0);
+    CHECK(sim.dbcErrors == 0);
+    REQUIRE(sim.firstFreshAfter != 0);
+    CHECK(sim.firstFreshAfter - overrunAt <= 20 + sim.ring + 2 * 16 + sim.latency);
+}
+
+TEST_CASE("A refill that cannot be queued re-primes without stale packets or a DBC jump", "[recovery]")
+{
+    for (uint32_t backlogs : { 1u, 3u }) {
+        Simulation sim({ 8, 16 });
+        sim.run(8000);
+        sim.resumeMark = sim.cycle;
+        const uint64_t backlogAt = sim.cycle;
+        sim.backlogs = backlogs;   // the transport keeps running throughout
+        sim.run(8000);
+
+        INFO(backlogs << " refills lost in a row");
+        CHECK(sim.reprimes == backlogs);
+        CHECK(sim.fails == 0);
+        CHECK(sim.resyncs == 2);
+        CHECK(sim.recovery.state() == TransmitStreamState::Running);
+        CHECK(sim.staleData == 0);
+        CHECK(sim.dbcErrors == 0);
+        REQUIRE(sim.firstFreshAfter != 0);
+        CHECK(sim.firstFreshAfter - backlogAt <= backlogs * 16 + sim.ring + 2 * 16 + sim.latency);
+    }
+}
+
+TEST_CASE("Out-of-sequence completions count as falling behind", "[recovery]")
+{
+    TransmitRecovery r({ 4, 8 });
+    r.start();
+    GroupDecision d = r.onGroupComplete(0, cycleTime(8000), cycleTime(8001));
+    REQUIRE(d.action == GroupAction::Resync);
+    CHECK(d.resyncCycle == 8000 + 1 - 8 + 32);   // group 0 again, one ring on
+    CHECK(r.onGroupComplete(1, cycleTime(8008), cycleTime(8009)).action == GroupAction::Fill);
+    CHECK(r.onGroupComplete(3, cycleTime(8024), cycleTime(8025)).action == GroupAction::Reprime);
+    CHECK(r.state() == TransmitStreamState::Recovering);
+    // Late completions are drained, the first in-time one resyncs
+    CHECK(r.onGroupComplete(0, cycleTime(8032), cycleTime(8032 + 20)).action == GroupAction::Idle);
+    d = r.onGroupComplete(1, cycleTime(8040), cycleTime(8042));
+    CHECK(d.action == GroupAction::Resync);
+    CHECK(d.resyncCycle == 8040 + 1 - 8 + 32);
+    CHECK(r.onGroupComplete(2, cycleTime(8048), cycleTime(8049)).action == GroupAction::Fill);
+
+    SECTION("the resync cycle wraps with the cycle timer")
+    {
+        r.start();
+        d = r.onGroupComplete(0, cycleTime(kWrap - 10), cycleTime(kWrap - 9));
+        CHECK(d.resyncCycle == (kWrap - 10 + 1 - 8 + 32) % kWrap);
+        CHECK(r.onGroupComplete(1, cycleTime(kWrap - 2), cycleTime(3)).action == GroupAction::Fill);
+    }
+    SECTION("stopped and failed streams ignore everything")
+    {
+        r.stop();
+        CHECK(r.onGroupComplete(2, cycleTime(0), cycleTime(0)).action == GroupAction::Idle);
+        CHECK(r.onOverrun(cycleTime(0)) == GroupAction::Idle);
+    }
+}
+
+TEST_CASE("Repeated overruns give up after the configured budget", "[recovery]")
+{
+    TransmitRecoveryConfig cfg{ 8, 16 };
+    cfg.maxRecoveries = 3;
+    cfg.recoveryWindowCycles = 8000;
+
+    SECTION("too many within the window fail the stream")
+    {
+        Simulation sim(cfg);
+        sim.run(8000);
+        for (int i = 0; i < 4; ++i) {
+            sim.hostBusyUntil = sim.cycle + 300;
+            sim.run(1000);
+        }
+        CHECK(sim.reprimes == 3);
+        CHECK(sim.fails == 1);
+        CHECK(sim.recovery.state() == TransmitStreamState::Failed);
+        CHECK(sim.recovery.onOverrun(cycleTime(sim.cycle)) == GroupAction::Idle);
+    }
+    SECTION("the same number spread out is tolerated")
+    {
+        Simulation sim(cfg);
+        sim.run(8000);
+        for (int i = 0; i < 8; ++i) {
+            sim.hostBusyUntil = sim.cycle + 300;
+            sim.run(4000);
+        }
+        CHECK(sim.reprimes == 8);
+        CHECK(sim.fails == 0);
+        CHECK(sim.recovery.state() == TransmitStreamState::Running);
+    }
+}
@@ -0,0 +1,282 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "Isoch/core/TransmitRenderPipeline.hpp"
+#include "Isoch/core/AmdtpStreamFormat.hpp"
+#include "Isoch/core/AmdtpTimingGenerator.hpp"
+#include "Isoch/core/DCLSegmentTable.hpp"
+#include "Isoch/utils/AM824Encoder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using FWA::Isoch::AmdtpStreamFormat;
+using FWA::Isoch::AmdtpTimingGenerator;
+using FWA::Isoch::AM824InputFormat;
+using FWA::Isoch::CycleTiming;
+using FWA::Isoch::DCLSegmentTable;
+using FWA::Isoch::TransmitRenderJob;
+using FWA::Isoch::TransmitRenderPipeline;
+namespace AM824 = FWA::Isoch::AM824;
+
+namespace {
+
+struct Recorder {
+    std::vector<TransmitRenderJob> jobs = std::vector<TransmitRenderJob>(64);
+    std::atomic<uint32_t> count{0};
+    std::atomic<bool> gate{true};   // render blocks while false
+
+    static void render(const TransmitRenderJob& job, void* refCon) {
+        auto* self = static_cast<Recorder*>(refCon);
+        while (!self->gate.load(std::memory_order_acquire)) std::this_thread::yield();
+        self->jobs[self->count.load(std::memory_order_relaxed) % self->jobs.size()] = job;
+        self->count.fetch_add(1, std::memory_order_release);
+    }
+};
+
+bool takeWithin(TransmitRenderPipeline& p, uint32_t& group, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (!p.takeRendered(group)) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+} // namespace
+
+TEST_CASE("Render pipeline renders jobs in order and bounds the jobs in flight", "[pipeline]")
+{
+    TransmitRenderPipeline pipeline(8);
+    Recorder rec;
+    REQUIRE(pipeline.start(&Recorder::render, &rec, 2'000'000));
+    CHECK_FALSE(pipeline.start(&Recorder::render, &rec, 2'000'000));
+
+    for (uint32_t g = 0; g < 8; ++g) {
+        TransmitRenderJob job;
+        job.group = g;
+        job.resyncCycle = g == 0 ? 1234 : TransmitRenderJob::kNoResync;
+        CHECK(pipeline.submit(job));
+    }
+    CHECK_FALSE(pipeline.submit({}));   // 8 in flight, none taken
+    CHECK(pipeline.pending() == 8);
+
+    for (uint32_t g = 0; g < 8; ++g) {
+        uint32_t group = 99;
+        REQUIRE(takeWithin(pipeline, group));
+        CHECK(group == g);
+    }
+    CHECK(pipeline.pending() == 0);
+    REQUIRE(rec.count.load() == 8);
+    CHECK(rec.jobs[0].resyncCycle == 1234);
+    CHECK(rec.jobs[1].resyncCycle == TransmitRenderJob::kNoResync);
+
+    // Steady state: one submit and one take per callback, forever
+    for (uint32_t i = 0; i < 1000; ++i) {
+        REQUIRE(pipeline.submit({ i % 8 }));
+        uint32_t group = 99;
+        REQUIRE(takeWithin(pipeline, group));
+        CHECK(group == i % 8);
+    }
+    pipeline.stop();
+    pipeline.stop();
+    CHECK_FALSE(pipeline.isRunning());
+    CHECK(rec.count.load() == 1008);
+}
+
+TEST_CASE("Render pipeline flush drops queued jobs without waiting for the worker", "[pipeline]")
+{
+    TransmitRenderPipeline pipeline(8);
+    Recorder rec;
+    rec.gate = false;
+    REQUIRE(pipeline.start(&Recorder::render, &rec, 2'000'000));
+
+    for (uint32_t g = 0; g < 4; ++g) REQUIRE(pipeline.submit({ g }));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));   // worker now blocked in job 0
+
+    // The callback thread never waits: flush and the next submit return at once
+    const auto t0 = std::chrono::steady_clock::now();
+    pipeline.flush();
+    REQUIRE(pipeline.submit({ 5 }));
+    CHECK(std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(5));
+    uint32_t group = 99;
+    CHECK_FALSE(pipeline.takeRendered(group));
+
+    // Job 0's result and jobs 1..3 are passed over; the re-prime comes out ahead of job 5
+    rec.gate = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE(takeWithin(pipeline, group));
+    CHECK(group == TransmitRenderJob::kAllGroups);
+    REQUIRE(takeWithin(pipeline, group));
+    CHECK(group == 5);
+    CHECK_FALSE(pipeline.takeRendered(group));
+    CHECK(pipeline.pending() == 0);
+
+    // Worker order: the job in progress, then the re-prime, then what came after the flush
+    REQUIRE(rec.count.load() == 3);
+    CHECK(rec.jobs[0].group == 0);
+    CHECK(rec.jobs[1].group == TransmitRenderJob::kAllGroups);
+    CHECK(rec.jobs[2].group == 5);
+
+    SECTION("back-to-back flushes are reported once, after the last re-prime")
+    {
+        pipeline.flush();
+        pipeline.flush();
+        REQUIRE(takeWithin(pipeline, group));
+        CHECK(group == TransmitRenderJob::kAllGroups);
+        CHECK(rec.jobs[(rec.count.load() - 1) % rec.jobs.size()].group == TransmitRenderJob::kAllGroups);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        CHECK_FALSE(pipeline.takeRendered(group));
+    }
+
+    // Restart after stop: old jobs are gone, new ones flow
+    REQUIRE(pipeline.submit({ 6 }));
+    pipeline.stop();
+    REQUIRE(pipeline.start(&Recorder::render, &rec, 2'000'000));
+    CHECK(pipeline.pending() == 0);
+    REQUIRE(pipeline.submit({ 7 }));
+    REQUIRE(takeWithin(pipeline, group));
+    CHECK(group == 7);
+}
+
+namespace {
+
+// Stand-in for IOVirtualRange
+struct Range {
+    uintptr_t address;
+    uintptr_t length;
+};
+
+// A transmit ring shaped like AmdtpTransmitter's: per packet a CIP header and a payload slot,
+// filled from an interleaved float source through the AM824 encoder. render() is the work
+// the completion callback does today; apply() is what it keeps in pipeline mode.
+struct Ring {
+    static constexpr uint32_t kGroups = 8, kPackets = 16;
+
+    AmdtpStreamFormat format;
+    AmdtpTimingGenerator timing{ 48000 };
+    std::vector<float> source;
+    std::vector<uint32_t> cip, payload;
+    std::vector<Range> ranges;          // what render() decided per packet
+    std::vector<uint32_t> rangeCount;
+    DCLSegmentTable<Range> segments;
+    std::vector<int> dcls;
+    uint64_t sourceFrame = 0, dclUpdates = 0, notifies = 0;
+
+    explicit Ring(uint32_t channels)
+        : format{ channels, 0, 48000 }, source(size_t(channels) * 4096),
+          cip(kGroups * kPackets * 2), payload(size_t(kGroups) * kPackets * format.dataBlockSize() * 8),
+          ranges(kGroups * kPackets * 2), rangeCount(kGroups * kPackets), dcls(kGroups * kPackets)
+    {
+        for (size_t i = 0; i < source.size(); ++i) source[i] = float(i % 97) / 97.0f - 0.5f;
+        segments.build(kGroups, kPackets);
+        for (uint32_t i = 0; i < kGroups * kPackets; ++i) segments.setDCL(i, &dcls[i], nullptr, 0);
+        timing.reset(100);
+    }
+
+    void render(uint32_t group) {
+        const uint32_t channels = format.audioChannels;
+        const size_t slotQuadlets = size_t(format.dataBlockSize()) * 8;
+        for (uint32_t p = 0; p < kPackets; ++p) {
+            const uint32_t i = group * kPackets + p;
+            const CycleTiming t = timing.next();
+            format.writeCIPHeader(reinterpret_cast<uint8_t*>(&cip[i * 2]), 0, t.dbc,
+                                  t.hasData() ? timing.sfc() : AmdtpStreamFormat::kFdfNoData, t.syt);
+            ranges[i * 2] = { reinterpret_cast<uintptr_t>(&cip[i * 2]), 8 };
+            rangeCount[i] = 1;
+            if (t.hasData()) {
+                const size_t offset = size_t(sourceFrame % (4096 - 8)) * channels;
+                uint32_t* slot = &payload[i * slotQuadlets];
+                AM824::encode(AM824InputFormat::Float32, &source[offset], size_t(8) * channels, slot);
+                sourceFrame += 8;
+                ranges[i * 2 + 1] = { reinterpret_cast<uintptr_t>(slot), slotQuadlets * 4 };
+                rangeCount[i] = 2;
+            }
+        }
+    }
+
+    void apply(uint32_t group) {
+        for (uint32_t p = 0; p < kPackets; ++p) {
+            const uint32_t i = group * kPackets + p;
+            if (segments.isUnchanged(i, &ranges[i * 2], rangeCount[i])) continue;
+            segments.remember(i, &ranges[i * 2], rangeCount[i]);
+            ++dclUpdates;
+        }
+        std::atomic_thread_fence(std::memory_order_release);   // stands in for Notify()
+        ++notifies;
+    }
+
+    static void renderJob(const TransmitRenderJob& job, void* refCon) {
+        static_cast<Ring*>(refCon)->render(job.group);
+    }
+};
+
+struct Distribution {
+    std::vector<double> us;
+    double percentile(double q) {
+        std::sort(us.begin(), us.end());
+        return us[std::min(us.size() - 1, size_t(q * double(us.size())))];
+    }
+};
+
+// Completion callbacks at a fixed period, timing only the callback body
+Distribution runCallbacks(uint32_t channels, bool pipelined, uint32_t callbacks, std::chrono::microseconds period) {
+    using clock = std::chrono::steady_clock;
+    Ring ring(channels);
+    TransmitRenderPipeline pipeline(Ring::kGroups);
+    if (pipelined) pipeline.start(&Ring::renderJob, &ring, uint64_t(period.count()) * 1000);
+
+    Distribution d;
+    d.us.reserve(callbacks);
+    auto next = clock::now();
+    for (uint32_t c = 0; c < callbacks; ++c) {
+        next += period;
+        std::this_thread::sleep_until(next);
+        const uint32_t group = c % Ring::kGroups;
+
+        const auto begin = clock::now();
+        if (pipelined) {
+            pipeline.submit({ group });
+            uint32_t done;
+            while (pipeline.takeRendered(done)) ring.apply(done);
+        } else {
+            ring.render(group);
+            ring.apply(group);
+        }
+        d.us.push_back(std::chrono::duration<double, std::micro>(clock::now() - begin).count());
+    }
+    pipeline.stop();
+    return d;
+}
+
+} // namespace
+
+TEST_CASE("Completion callback duration, inline rendering against the pipeline", "[.][benchmark][pipeline]")
+{
+    // 2 ms groups scaled down 8x so a few thousand callbacks take seconds, not minutes
+    constexpr uint32_t kCallbacks = 4000;
+    constexpr std::chrono::microseconds kPeriod(250);
+
+    double inlineMedianAtMax = 0, pipelineMedianAtMax = 0, inlineP99AtMax = 0, pipelineP99AtMax = 0;
+    for (uint32_t channels : { 2u, 16u, 64u }) {
+        for (bool pipelined : { false, true }) {
+            Distribution d = runCallbacks(channels, pipelined, kCallbacks, kPeriod);
+            const double p50 = d.percentile(0.5), p99 = d.percentile(0.99), worst = d.percentile(1.0);
+            std::ostringstream line;
+            line << (pipelined ? "pipeline" : "inline  ") << " " << channels << " ch: p50 " << p50
+                 << " us, p99 " << p99 << " us, max " << worst << " us";
+            WARN(line.str());
+            if (channels == 64) {
+                (pipelined ? pipelineMedianAtMax : inlineMedianAtMax) = p50;
+                (pipelined ? pipelineP99AtMax : inlineP99AtMax) = p99;
+            }
+        }
+    }
+    CHECK(pipelineMedianAtMax < inlineMedianAtMax);
+    CHECK(pipelineP99AtMax < inlineP99AtMax);
+}
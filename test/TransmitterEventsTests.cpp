@@ -0,0 +1,170 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "Isoch/core/TransmitterEvents.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using FWA::Isoch::TransmitterEvent;
+using FWA::Isoch::TransmitterEventCounters;
+using FWA::Isoch::TransmitterEventDispatcher;
+using FWA::Isoch::TransmitterEventSnapshot;
+
+namespace {
+
+struct Reports {
+    std::mutex mutex;
+    std::vector<TransmitterEventSnapshot> deltas;
+    TransmitterEventSnapshot lastTotals;
+
+    static void sink(const TransmitterEventSnapshot& delta, const TransmitterEventSnapshot& totals, void* refCon) {
+        auto* self = static_cast<Reports*>(refCon);
+        std::lock_guard<std::mutex> lock(self->mutex);
+        self->deltas.push_back(delta);
+        self->lastTotals = totals;
+    }
+
+    TransmitterEventSnapshot sum() {
+        std::lock_guard<std::mutex> lock(mutex);
+        TransmitterEventSnapshot s;
+        for (const auto& d : deltas)
+            for (size_t i = 0; i < s.counts.size(); ++i) s.counts[i] += d.counts[i];
+        return s;
+    }
+
+    size_t count() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return deltas.size();
+    }
+};
+
+} // namespace
+
+TEST_CASE("Transmitter event counters are exact under concurrent recording", "[events]")
+{
+    TransmitterEventCounters counters;
+    constexpr int kThreads = 4, kPerThread = 50000;
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; ++t) {
+        writers.emplace_back([&counters, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                counters.record(TransmitterEvent::BufferUnderrun);
+                if (i % 10 == 0) counters.record(static_cast<TransmitterEvent>(1 + t % 4), 2);
+                if (i % 1000 == 0) std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& w : writers) w.join();
+
+    const TransmitterEventSnapshot s = counters.snapshot();
+    CHECK(s[TransmitterEvent::BufferUnderrun] == uint64_t(kThreads) * kPerThread);
+    for (int t = 0; t < kThreads; ++t)
+        CHECK(s[static_cast<TransmitterEvent>(1 + t)] == uint64_t(kPerThread / 10) * 2);
+    CHECK(s.total() == uint64_t(kThreads) * kPerThread + uint64_t(kThreads) * (kPerThread / 10) * 2);
+
+    const TransmitterEventSnapshot d = counters.snapshot().since(s);
+    CHECK(d.total() == 0);
+}
+
+TEST_CASE("Event dispatcher coalesces an underrun storm into one report per interval", "[events]")
+{
+    using namespace std::chrono;
+    TransmitterEventCounters counters;
+    counters.record(TransmitterEvent::LateCallback, 7);   // before start(): never reported
+
+    Reports reports;
+    TransmitterEventDispatcher dispatcher(counters, milliseconds(20));
+    dispatcher.start(&Reports::sink, &reports);
+    REQUIRE(dispatcher.isRunning());
+
+    // A storm: every simulated callback underruns all 16 of its packets, for ~300 ms
+    const auto begin = steady_clock::now();
+    uint64_t recorded = 0;
+    while (steady_clock::now() - begin < milliseconds(300)) {
+        counters.record(TransmitterEvent::BufferUnderrun, 16);
+        recorded += 16;
+        if (recorded % 1024 == 0) counters.record(TransmitterEvent::NotifyError);
+        std::this_thread::yield();
+    }
+    const auto elapsed = duration_cast<milliseconds>(steady_clock::now() - begin);
+
+    // The storm's tail goes out with the next report; after that, quiet means no reports
+    std::this_thread::sleep_for(milliseconds(60));
+    const size_t duringStorm = reports.count();
+    std::this_thread::sleep_for(milliseconds(100));
+    CHECK(reports.count() == duringStorm);
+
+    counters.record(TransmitterEvent::DCLUpdateError, 3);
+    dispatcher.stop();   // final report carries the last increment
+    CHECK_FALSE(dispatcher.isRunning());
+
+    INFO(recorded << " underruns over " << elapsed.count() << " ms in " << duringStorm << " reports");
+    CHECK(duringStorm >= 1);
+    CHECK(duringStorm <= size_t((elapsed.count() + 60) / 20 + 2));
+    CHECK(reports.count() == duringStorm + 1);
+
+    const TransmitterEventSnapshot sum = reports.sum();
+    CHECK(sum[TransmitterEvent::BufferUnderrun] == recorded);
+    CHECK(sum[TransmitterEvent::NotifyError] == recorded / 1024);
+    CHECK(sum[TransmitterEvent::DCLUpdateError] == 3);
+    CHECK(sum[TransmitterEvent::LateCallback] == 0);
+    CHECK(reports.lastTotals[TransmitterEvent::LateCallback] == 7);
+    CHECK(reports.lastTotals.total() == sum.total() + 7);
+}
+
+TEST_CASE("Event dispatcher restarts and stops idempotently", "[events]")
+{
+    TransmitterEventCounters counters;
+    Reports reports;
+    TransmitterEventDispatcher dispatcher(counters, std::chrono::milliseconds(10));
+
+    dispatcher.stop();                     // not running: no-op
+    dispatcher.start(nullptr, &reports);   // no sink: stays stopped
+    CHECK_FALSE(dispatcher.isRunning());
+
+    for (int round = 0; round < 3; ++round) {
+        dispatcher.start(&Reports::sink, &reports);
+        counters.record(TransmitterEvent::SkippedPacket);
+        dispatcher.stop();
+        dispatcher.stop();
+    }
+    CHECK(reports.sum()[TransmitterEvent::SkippedPacket] == 3);
+    CHECK(reports.count() == 3);
+}
+
+TEST_CASE("A sink may stop its own dispatcher", "[events]")
+{
+    // A client stopping the stream from a fault report ends up in stop() on the dispatcher thread
+    struct Client {
+        TransmitterEventDispatcher* dispatcher = nullptr;
+        std::atomic<int> reports{0};
+        static void sink(const TransmitterEventSnapshot&, const TransmitterEventSnapshot&, void* refCon) {
+            auto* self = static_cast<Client*>(refCon);
+            ++self->reports;
+            self->dispatcher->stop();
+        }
+    };
+    TransmitterEventCounters counters;
+    TransmitterEventDispatcher dispatcher(counters, std::chrono::milliseconds(5));
+    Client client;
+    client.dispatcher = &dispatcher;
+
+    for (int round = 0; round < 3; ++round) {
+        dispatcher.start(&Client::sink, &client);
+        REQUIRE(dispatcher.isRunning());
+        const int before = client.reports.load();
+        counters.record(TransmitterEvent::BufferUnderrun);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (dispatcher.isRunning() && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        CHECK_FALSE(dispatcher.isRunning());
+        CHECK(client.reports.load() == before + 1);
+    }
+    dispatcher.stop();   // joins the thread the sink stopped
+    CHECK_FALSE(dispatcher.isRunning());
+}
@@ -0,0 +1,145 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include "Isoch/core/VarispeedResampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using FWA::Isoch::RateServo;
+using FWA::Isoch::VarispeedResampler;
+
+namespace {
+
+constexpr uint32_t kChunk = 512;          // one CoreAudio IO cycle
+constexpr double kRate = 48000.0;
+
+struct DriftResult {
+    double minFill = 1e30;
+    double maxFill = -1e30;
+    double finalFill = 0.0;
+    double finalCorrection = 0.0;
+};
+
+// Host-clock producer pushes kChunk frames per IO cycle through the resampler; the bus consumes
+// (1 + ppm) x as fast. Fill is tracked before each push, like the provider ring's read space.
+DriftResult simulateDrift(double ppm, double pllBusPerHost, double seconds, double target, bool servoEnabled,
+                          double settleSeconds)
+{
+    VarispeedResampler rs(2, kChunk);
+    RateServo servo;
+    std::vector<int32_t> in(size_t(kChunk) * 2, 0), out(size_t(kChunk) * 4, 0);
+
+    const double busPerHost = 1.0 + ppm * 1e-6;
+    const uint64_t cycles = uint64_t(seconds * kRate / kChunk);
+    const uint64_t settleCycles = uint64_t(settleSeconds * kRate / kChunk);
+    double fill = target;
+    DriftResult r;
+    for (uint64_t k = 0; k < cycles; ++k) {
+        fill -= kChunk * busPerHost;                     // bus drained since the last IO cycle
+        if (k >= settleCycles) {
+            r.minFill = std::min(r.minFill, fill);
+            r.maxFill = std::max(r.maxFill, fill);
+        }
+        const uint32_t produced = rs.process(in.data(), kChunk, out.data(), uint32_t(out.size() / 2));
+        fill += produced;
+        rs.setStep(servoEnabled ? servo.update(fill, target, pllBusPerHost) : 1.0);
+    }
+    r.finalFill = fill;
+    r.finalCorrection = servo.correction();
+    return r;
+}
+
+} // namespace
+
+TEST_CASE("Unity step reproduces the input exactly, two frames late", "[resampler]")
+{
+    constexpr uint32_t kCh = 3;
+    VarispeedResampler rs(kCh, 64);
+    std::vector<int32_t> all, out;
+    std::vector<int32_t> chunk, buf(size_t(128) * kCh);
+    int32_t v = -8388608;
+    for (int n = 0; n < 40; ++n) {
+        const uint32_t frames = 1 + (n * 13) % 64;
+        chunk.resize(size_t(frames) * kCh);
+        for (auto& s : chunk) { s = v; v = (v + 104729) % 8388607; }
+        all.insert(all.end(), chunk.begin(), chunk.end());
+        const uint32_t got = rs.process(chunk.data(), frames, buf.data(), 128);
+        CHECK(got == frames);
+        out.insert(out.end(), buf.begin(), buf.begin() + size_t(got) * kCh);
+    }
+    REQUIRE(out.size() == all.size());
+    // Two frames of initial silence, then the input verbatim.
+    for (uint32_t i = 0; i < 2 * kCh; ++i) CHECK(out[i] == 0);
+    CHECK(std::equal(out.begin() + 2 * kCh, out.end(), all.begin()));
+}
+
+TEST_CASE("Varispeed changes the length by the step and interpolates cleanly", "[resampler]")
+{
+    constexpr uint32_t kCh = 5;              // exercises the 4-wide SIMD group plus a scalar tail
+    constexpr double kStep = 1.0 + 900e-6;
+    VarispeedResampler rs(kCh, kChunk);
+    rs.setStep(kStep);
+
+    const double amp = 4'000'000.0, w = 2.0 * M_PI * 1000.0 / kRate;
+    std::vector<int32_t> in(size_t(kChunk) * kCh), out(size_t(rs.maxOutputFrames(kChunk)) * kCh);
+    uint64_t inFrames = 0, outFrames = 0;
+    double maxErr = 0.0;
+    for (int cycle = 0; cycle < 200; ++cycle) {
+        for (uint32_t f = 0; f < kChunk; ++f)
+            for (uint32_t c = 0; c < kCh; ++c)
+                in[size_t(f) * kCh + c] = int32_t(std::lround(amp * std::sin(w * double(inFrames + f) + c)));
+        const uint32_t got = rs.process(in.data(), kChunk, out.data(), rs.maxOutputFrames(kChunk));
+        for (uint32_t f = 0; f < got; ++f) {
+            // Output frame n sits at input position n * step, delayed by two frames.
+            const double x = double(outFrames + f) * kStep - 2.0;
+            if (x < 0.0) continue;
+            for (uint32_t c = 0; c < kCh; ++c)
+                maxErr = std::max(maxErr, std::fabs(out[size_t(f) * kCh + c] - amp * std::sin(w * x + c)));
+        }
+        inFrames += kChunk;
+        outFrames += got;
+    }
+    CHECK(std::fabs(double(outFrames) - double(inFrames) / kStep) <= 3.0);
+    CHECK(maxErr < amp * 1e-3);              // better than -60 dB for a 1 kHz tone
+}
+
+TEST_CASE("Servo holds the ring at constant fill under a +/-200 ppm offset", "[resampler][drift]")
+{
+    constexpr double kTarget = 2048.0;
+    constexpr double kMinutes = 10.0;
+
+    // Without compensation the ring walks off by ~5800 frames in ten minutes.
+    const DriftResult free = simulateDrift(+200.0, 1.0, 60.0 * kMinutes, kTarget, false, 0.0);
+    CHECK(free.finalFill < kTarget - 5000.0);
+
+    for (double ppm : { -200.0, +200.0 }) {
+        // PLL ratio unknown: the servo has to find the offset by itself.
+        const DriftResult blind = simulateDrift(ppm, 1.0, 60.0 * kMinutes, kTarget, true, 60.0);
+        CHECK(blind.minFill > kTarget - kChunk - 128.0);
+        CHECK(blind.maxFill < kTarget + 128.0);
+        // A faster bus needs more output per input, i.e. a step below 1.
+        CHECK(std::fabs(blind.finalCorrection + ppm * 1e-6) < 50e-6);
+
+        // PLL ratio known: the nominal step already matches, the servo stays near zero.
+        const DriftResult steered = simulateDrift(ppm, 1.0 + ppm * 1e-6, 60.0 * kMinutes, kTarget, true, 10.0);
+        CHECK(steered.minFill > kTarget - kChunk - 64.0);
+        CHECK(steered.maxFill < kTarget + 64.0);
+        CHECK(std::fabs(steered.finalCorrection) < 10e-6);
+    }
+}
+
+TEST_CASE("Varispeed resampler CPU cost per channel", "[.][benchmark][resampler]")
+{
+    for (uint32_t ch : { 1u, 2u, 8u, 18u }) {
+        VarispeedResampler rs(ch, kChunk);
+        rs.setStep(1.0 + 150e-6);
+        std::vector<int32_t> in(size_t(kChunk) * ch, 12345), out(size_t(rs.maxOutputFrames(kChunk)) * ch);
+        BENCHMARK("cubic varispeed, 512 frames x " + std::to_string(ch) + " ch") {
+            return rs.process(in.data(), kChunk, out.data(), rs.maxOutputFrames(kChunk));
+        };
+    }
+}